@@ -126,6 +126,15 @@
 #define RIPPLE_DUMP_LEAKS_ON_EXIT 1
 #endif
 
+/** Config: RIPPLE_COUNT_ALLOCATIONS
+    Replaces the global operator new with one that counts the bytes each
+    thread allocates, so that the cost of an RPC command can be measured.
+    Off by default, since every allocation in the process pays for it.
+*/
+#ifndef RIPPLE_COUNT_ALLOCATIONS
+#define RIPPLE_COUNT_ALLOCATIONS 0
+#endif
+
 //------------------------------------------------------------------------------
 
 // These control whether or not certain functionality gets
@@ -25,6 +25,7 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LocalTxs.h>
 #include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/main/CollectorManager.h>
 #include <ripple/app/misc/AmendmentTable.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
@@ -83,6 +84,12 @@ RCLConsensus::Adaptor::Adaptor(
         , nodeID_{calcNodeID(app.nodeIdentity().first)}
         , valPublic_{validatorKeys.publicKey}
         , valSecret_{validatorKeys.secretKey}
+        , openTime_{app.getCollectorManager().collector()->make_histogram(
+              "consensus_open")}
+        , establishTime_{app.getCollectorManager().collector()->make_histogram(
+              "consensus_establish")}
+        , acceptTime_{app.getCollectorManager().collector()->make_histogram(
+              "consensus_accept")}
 {
 }
 
@@ -280,6 +287,10 @@ RCLConsensus::Adaptor::onClose(
     const bool wrongLCL = mode == ConsensusMode::wrongLedger;
     const bool proposing = mode == ConsensusMode::proposing;
 
+    auto const roundStart = roundStart_.load();
+    if (roundStart != std::chrono::steady_clock::time_point{})
+        openTime_.notify(std::chrono::steady_clock::now() - roundStart);
+
     notify(protocol::neCLOSING_LEDGER, ledger, !wrongLCL);
 
     auto const& prevLedger = ledger.ledger_;
@@ -395,8 +406,10 @@ RCLConsensus::Adaptor::doAccept(
     ConsensusMode const& mode,
     Json::Value && consensusJson)
 {
+    auto const acceptStart = std::chrono::steady_clock::now();
     prevProposers_ = result.proposers;
     prevRoundTime_ = result.roundTime.read();
+    establishTime_.notify(result.roundTime.read());
 
     bool closeTimeCorrect;
 
@@ -589,6 +602,8 @@ RCLConsensus::Adaptor::doAccept(
 
         app_.timeKeeper().adjustCloseTime(offset);
     }
+
+    acceptTime_.notify(std::chrono::steady_clock::now() - acceptStart);
 }
 
 void
@@ -964,6 +979,7 @@ RCLConsensus::Adaptor::preStartRound(RCLCxLedger const & prevLgr)
 
     // Notify inbound ledgers that we are starting a new round
     inboundTransactions_.newRound(prevLgr.seq());
+    roundStart_ = std::chrono::steady_clock::now();
 
     // Use parent ledger's rules to determine whether to use rounded close time
     parms_.useRoundedCloseTime = prevLgr.ledger_->rules().enabled(fix1528);
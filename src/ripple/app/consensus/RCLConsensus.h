@@ -27,6 +27,7 @@
 #include <ripple/app/misc/FeeVote.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/Log.h>
+#include <ripple/beast/insight/Histogram.h>
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/consensus/Consensus.h>
 #include <ripple/core/JobQueue.h>
@@ -77,6 +78,15 @@ class RCLConsensus
             std::chrono::milliseconds{0}};
         std::atomic<ConsensusMode> mode_{ConsensusMode::observing};
 
+        // When the current round started, to time the open phase
+        std::atomic<std::chrono::steady_clock::time_point> roundStart_{
+            std::chrono::steady_clock::time_point{}};
+
+        // Time spent in each phase of a round, in microseconds
+        beast::insight::Histogram openTime_;
+        beast::insight::Histogram establishTime_;
+        beast::insight::Histogram acceptTime_;
+
     public:
         using Ledger_t = RCLCxLedger;
         using NodeID_t = NodeID;
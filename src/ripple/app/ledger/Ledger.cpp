@@ -450,6 +450,26 @@ Ledger::read (Keylet const& k) const
     return std::move(sle);
 }
 
+boost::optional<LazySLE>
+Ledger::readLazy (Keylet const& k) const
+{
+    if (k.key == zero)
+    {
+        assert(false);
+        return boost::none;
+    }
+    auto const& item =
+        stateMap_->peekItem(k.key);
+    if (! item)
+        return boost::none;
+    // The entry refers to the bytes of the item
+    // and keeps the item alive.
+    LazySLE sle (item->key(), item->slice(), item);
+    if (! k.check(sle))
+        return boost::none;
+    return sle;
+}
+
 //------------------------------------------------------------------------------
 
 auto
@@ -170,6 +170,9 @@ public:
     std::shared_ptr<SLE const>
     read (Keylet const& k) const override;
 
+    boost::optional<LazySLE>
+    readLazy (Keylet const& k) const override;
+
     std::unique_ptr<sles_type::iter_base>
     slesBegin() const override;
 
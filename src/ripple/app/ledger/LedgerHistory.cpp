@@ -49,10 +49,43 @@ LedgerHistory::LedgerHistory (
         stopwatch(), app_.journal("TaggedCache"))
     , m_consensus_validated ("ConsensusValidated", 64, 300,
         stopwatch(), app_.journal("TaggedCache"))
+    , mRecent (app_.config().getSize (siLedgerPinned))
+    , flag_pinned_ (app_.config().getSize (siFlagLedgerPinned))
     , j_ (app.journal ("LedgerHistory"))
 {
 }
 
+void
+LedgerHistory::pin (std::shared_ptr<Ledger const> const& ledger)
+{
+    auto const seq = ledger->info().seq;
+
+    auto& slot = mRecent[seq % mRecent.size ()];
+    if (! slot || slot->info().seq <= seq)
+        slot = ledger;
+
+    if ((seq % 256) == 0 && flag_pinned_ != 0)
+    {
+        mFlagLedgers[seq] = ledger;
+        while (mFlagLedgers.size () > flag_pinned_)
+            mFlagLedgers.erase (mFlagLedgers.begin ());
+    }
+}
+
+std::shared_ptr<Ledger const>
+LedgerHistory::getPinned (LedgerIndex index) const
+{
+    auto const& slot = mRecent[index % mRecent.size ()];
+    if (slot && slot->info().seq == index)
+        return slot;
+
+    auto const it = mFlagLedgers.find (index);
+    if (it != mFlagLedgers.end ())
+        return it->second;
+
+    return {};
+}
+
 bool
 LedgerHistory::insert(
     std::shared_ptr<Ledger const> ledger,
@@ -68,7 +101,10 @@ LedgerHistory::insert(
     const bool alreadyHad = m_ledgers_by_hash.canonicalize (
         ledger->info().hash, ledger, true);
     if (validated)
+    {
         mLedgersByIndex[ledger->info().seq] = ledger->info().hash;
+        pin (ledger);
+    }
 
     return alreadyHad;
 }
@@ -76,6 +112,9 @@ LedgerHistory::insert(
 LedgerHash LedgerHistory::getLedgerHash (LedgerIndex index)
 {
     LedgersByHash::ScopedLockType sl (m_ledgers_by_hash.peekMutex ());
+    if (auto const ledger = getPinned (index))
+        return ledger->info().hash;
+
     auto it = mLedgersByIndex.find (index);
 
     if (it != mLedgersByIndex.end ())
@@ -84,9 +123,40 @@ LedgerHash LedgerHistory::getLedgerHash (LedgerIndex index)
     return uint256 ();
 }
 
+std::shared_ptr<Ledger const>
+LedgerHistory::getCachedLedgerBySeq (LedgerIndex index)
+{
+    LedgersByHash::ScopedLockType sl (m_ledgers_by_hash.peekMutex ());
+    if (auto ret = getPinned (index))
+        return ret;
+
+    auto it = mLedgersByIndex.find (index);
+
+    if (it != mLedgersByIndex.end ())
+        return m_ledgers_by_hash.fetch (it->second);
+
+    return {};
+}
+
+std::shared_ptr<Ledger const>
+LedgerHistory::getPinnedLedger (LedgerIndex index)
+{
+    LedgersByHash::ScopedLockType sl (m_ledgers_by_hash.peekMutex ());
+    return getPinned (index);
+}
+
+std::shared_ptr<Ledger const>
+LedgerHistory::getCachedLedgerByHash (LedgerHash const& hash)
+{
+    return m_ledgers_by_hash.fetch (hash);
+}
+
 std::shared_ptr<Ledger const>
 LedgerHistory::getLedgerBySeq (LedgerIndex index)
 {
+    if (auto ret = getCachedLedgerBySeq (index))
+        return ret;
+
     {
         LedgersByHash::ScopedLockType sl (m_ledgers_by_hash.peekMutex ());
         auto it = mLedgersByIndex.find (index);
@@ -484,6 +554,12 @@ bool LedgerHistory::fixIndex (
     if ((it != mLedgersByIndex.end ()) && (it->second != ledgerHash) )
     {
         it->second = ledgerHash;
+
+        // Don't keep serving the wrong ledger from the pinned set
+        auto& slot = mRecent[ledgerIndex % mRecent.size ()];
+        if (slot && slot->info().seq == ledgerIndex)
+            slot.reset ();
+        mFlagLedgers.erase (ledgerIndex);
         return false;
     }
     return true;
@@ -497,6 +573,17 @@ void LedgerHistory::tune (int size, int age)
 
 void LedgerHistory::clearLedgerCachePrior (LedgerIndex seq)
 {
+    {
+        LedgersByHash::ScopedLockType sl (m_ledgers_by_hash.peekMutex ());
+        for (auto& slot : mRecent)
+        {
+            if (slot && slot->info().seq < seq)
+                slot.reset ();
+        }
+        mFlagLedgers.erase (mFlagLedgers.begin (),
+            mFlagLedgers.lower_bound (seq));
+    }
+
     for (LedgerHash it: m_ledgers_by_hash.getKeys())
     {
         auto const ledger = getLedgerByHash (it);
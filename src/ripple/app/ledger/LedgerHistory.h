@@ -25,12 +25,21 @@
 #include <ripple/protocol/RippleLedgerHash.h>
 #include <ripple/beast/insight/Collector.h>
 #include <ripple/beast/insight/Event.h>
+#include <map>
+#include <vector>
 
 namespace ripple {
 
 // VFALCO TODO Rename to OldLedgers ?
 
-/** Retains historical ledgers. */
+/** Retains historical ledgers.
+
+    The most recent validated ledgers, and the latest flag ledgers, are
+    pinned in memory and indexed by sequence in a ring buffer, so that
+    lookups of recent history by `ledger_index` never have to go to the
+    ledger database or the node store. How many are pinned depends on
+    the configured node size.
+*/
 class LedgerHistory
 {
 public:
@@ -59,6 +68,33 @@ public:
     std::shared_ptr<Ledger const>
     getLedgerByHash (LedgerHash const& ledgerHash);
 
+    /** Get a ledger given its sequence number, if it is in memory.
+        Pinned ledgers are found without a hash lookup. This never
+        loads the ledger from the database.
+    */
+    std::shared_ptr<Ledger const>
+    getCachedLedgerBySeq (LedgerIndex ledgerIndex);
+
+    /** Get a pinned ledger given its sequence number */
+    std::shared_ptr<Ledger const>
+    getPinnedLedger (LedgerIndex ledgerIndex);
+
+    /** Retrieve a ledger given its hash, if it is in memory */
+    std::shared_ptr<Ledger const>
+    getCachedLedgerByHash (LedgerHash const& ledgerHash);
+
+    /** The number of recent validated ledgers pinned by sequence */
+    std::size_t getRecentPinned () const
+    {
+        return mRecent.size ();
+    }
+
+    /** The number of flag ledgers pinned in addition to the recent ones */
+    std::size_t getFlagPinned () const
+    {
+        return flag_pinned_;
+    }
+
     /** Get a ledger's hash given its sequence number
         @param ledgerIndex The sequence number of the desired ledger
         @return The hash of the specified ledger
@@ -108,6 +144,15 @@ private:
     void handleMismatch (LedgerHash const& built, LedgerHash const& valid,
         Json::Value const& consensus);
 
+    // Pin a validated ledger in the recent ring, and in the flag ledger
+    // set if applicable. Called with the m_ledgers_by_hash lock held.
+    void pin (std::shared_ptr<Ledger const> const& ledger);
+
+    // Look up a pinned ledger by sequence number. Called with the
+    // m_ledgers_by_hash lock held.
+    std::shared_ptr<Ledger const>
+    getPinned (LedgerIndex ledgerIndex) const;
+
     Application& app_;
     beast::insight::Collector::ptr collector_;
     beast::insight::Counter mismatch_counter_;
@@ -131,6 +176,14 @@ private:
     // Maps ledger indexes to the corresponding hash.
     std::map <LedgerIndex, LedgerHash> mLedgersByIndex; // validated ledgers
 
+    // Recent validated ledgers, indexed by sequence modulo the size.
+    // Holding the ledger keeps it (and its hash cache entry) resident.
+    std::vector <std::shared_ptr<Ledger const>> mRecent;
+
+    // The most recent validated flag ledgers, at most flag_pinned_
+    std::map <LedgerIndex, std::shared_ptr<Ledger const>> mFlagLedgers;
+    std::size_t const flag_pinned_;
+
     beast::Journal j_;
 };
 
@@ -21,16 +21,17 @@
 #define RIPPLE_APP_LEDGER_LEDGERHOLDER_H_INCLUDED
 
 #include <ripple/basics/contract.h>
-#include <mutex>
+#include <atomic>
+#include <memory>
 
 namespace ripple {
 
-// Can std::atomic<std::shared_ptr>> make this lock free?
-
-// VFALCO NOTE This class can be replaced with atomic<shared_ptr<...>>
-
 /** Hold a ledger in a thread-safe way.
 
+    The held ledger is published and read with atomic shared_ptr
+    operations, so readers always get a complete snapshot and never
+    wait for a writer, even while the ledger is being advanced.
+
     VFALCO TODO The constructor should require a valid ledger, this
                 way the object always holds a value. We can use the
                 genesis ledger in all cases.
@@ -45,25 +46,22 @@ public:
             LogicError("LedgerHolder::set with nullptr");
         if(! ledger->isImmutable())
             LogicError("LedgerHolder::set with mutable Ledger");
-        std::lock_guard <std::mutex> sl (m_lock);
-        m_heldLedger = std::move(ledger);
+        std::atomic_store (&m_heldLedger, std::move(ledger));
     }
 
     // Return the (immutable) held ledger
-    std::shared_ptr<Ledger const> get ()
+    std::shared_ptr<Ledger const> get () const
     {
-        std::lock_guard <std::mutex> sl (m_lock);
-        return m_heldLedger;
+        return std::atomic_load (&m_heldLedger);
     }
 
-    bool empty ()
+    bool empty () const
     {
-        std::lock_guard <std::mutex> sl (m_lock);
-        return m_heldLedger == nullptr;
+        return get () == nullptr;
     }
 
 private:
-    std::mutex m_lock;
+    // Only accessed through std::atomic_load and std::atomic_store
     std::shared_ptr<Ledger const> m_heldLedger;
 };
 
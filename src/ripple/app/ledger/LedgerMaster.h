@@ -90,17 +90,11 @@ public:
 
     // The finalized ledger is the last closed/accepted ledger
     std::shared_ptr<Ledger const>
-    getClosedLedger()
-    {
-        return mClosedLedger.get();
-    }
+    getClosedLedger();
 
     // The validated ledger is the last fully validated ledger
     std::shared_ptr<Ledger const>
-    getValidatedLedger ()
-    {
-        return mValidLedger.get();
-    }
+    getValidatedLedger ();
 
     // The Rules are in the last fully validated ledger if there is one.
     Rules getValidatedRules();
@@ -196,6 +190,18 @@ public:
     void sweep ();
     float getCacheHitRate ();
 
+    /** Lookups by sequence number that were satisfied from memory
+        (hits) and that had to load the ledger from the database
+        (misses).
+    */
+    struct SeqLookupStats
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+    };
+
+    SeqLookupStats getSeqLookupStats () const;
+
     void checkAccept (std::shared_ptr<Ledger const> const& ledger);
     void checkAccept (uint256 const& hash, std::uint32_t seq);
     void consensusBuilt (std::shared_ptr<Ledger const> const& ledger, Json::Value consensus);
@@ -242,6 +248,21 @@ public:
 
     std::size_t getFetchPackCacheSize () const;
 
+    /** Statistics for snapshot reads of the current, closed, validated
+        and published ledgers. Readers never take m_mutex, so the wait
+        time should stay in the low microseconds even while the ledger
+        is advancing. Reads are sampled, so the count and total wait
+        are estimates and the maximum is taken over the sampled reads.
+    */
+    struct ReadStats
+    {
+        std::uint64_t reads = 0;
+        std::chrono::microseconds totalWait {0};
+        std::chrono::microseconds maxWait {0};
+    };
+
+    ReadStats getReadStats () const;
+
 private:
     using ScopedLockType = std::lock_guard <std::recursive_mutex>;
     using ScopedUnlockType = GenericScopedUnlock <std::recursive_mutex>;
@@ -278,6 +299,9 @@ private:
     // The passed ScopedLockType is a reminder to callers.
     bool newPFWork(const char *name, ScopedLockType&);
 
+    // Times a sample of snapshot reads and records them in the read stats
+    class ReadTimer;
+
 private:
     Application& app_;
     beast::Journal m_journal;
@@ -291,7 +315,7 @@ private:
     LedgerHolder mValidLedger;
 
     // The last ledger we have published.
-    std::shared_ptr<Ledger const> mPubLedger;
+    LedgerHolder mPubLedger;
 
     // The last ledger we did pathfinding against.
     std::shared_ptr<Ledger const> mPathLedger;
@@ -333,6 +357,17 @@ private:
     std::atomic <LedgerIndex> mValidLedgerSeq {0};
     std::atomic <LedgerIndex> mBuildingLedgerSeq {0};
 
+    // Snapshot read statistics, see ReadTimer
+    std::atomic <std::uint64_t> mReads {0};
+    std::atomic <std::uint64_t> mReadWaitNanos {0};
+    std::atomic <std::uint64_t> mReadMaxWaitNanos {0};
+
+    // Lookups by sequence, see getLedgerBySeq
+    beast::insight::Counter mSeqHitCounter;
+    beast::insight::Counter mSeqMissCounter;
+    std::atomic <std::uint64_t> mSeqHits {0};
+    std::atomic <std::uint64_t> mSeqMisses {0};
+
     // The server is in standalone mode
     bool const standalone_;
 
@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERREPLAYER_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERREPLAYER_H_INCLUDED
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/beast/utility/Journal.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/** Apply a ledger's transactions to its parent.
+
+    This repeats the work of closing `ledger`, in the order its
+    metadata records. The result is accepted with the same close time
+    so that its hash can be compared to the original. Nothing is
+    written to the node store.
+
+    @param transactions Set to the number of transactions applied.
+*/
+std::shared_ptr<Ledger>
+replayLedger (Application& app, Ledger const& parent, Ledger const& ledger,
+    std::size_t& transactions, beast::Journal j);
+
+/** Replays a range of historical ledgers and checks their hashes.
+
+    Each ledger in the range is rebuilt from the stored copy of its
+    parent, so ledgers are independent and are replayed on several
+    threads at once. One thread fetches ledgers in order a few ahead
+    of the workers, so loading the next ledger overlaps applying the
+    current one.
+*/
+class LedgerReplayer
+{
+public:
+    /** Loads a stored ledger, or returns null if it is not available. */
+    using Fetch = std::function<
+        std::shared_ptr<Ledger const> (std::uint32_t seq)>;
+
+    struct Setup
+    {
+        // Replay the ledgers from first through last
+        std::uint32_t first = 0;
+        std::uint32_t last = 0;
+
+        // Number of ledgers replayed at once
+        std::size_t workers = 1;
+
+        // Ledgers fetched ahead of the workers, at least 2 * workers
+        std::size_t window = 0;
+
+        // State entries listed for each state mismatch
+        std::size_t maxDifferences = 8;
+    };
+
+    /** A ledger whose replay did not reproduce it. */
+    struct Mismatch
+    {
+        std::uint32_t seq = 0;
+
+        // The stored and the replayed ledger hash, if replayed
+        uint256 expected;
+        uint256 actual;
+
+        // What went wrong
+        std::string reason;
+
+        // Keys of state entries that differ, if the state does
+        std::vector<uint256> keys;
+    };
+
+    struct Progress
+    {
+        std::size_t ledgers = 0;
+        std::size_t transactions = 0;
+        std::size_t mismatches = 0;
+        std::chrono::steady_clock::duration elapsed {};
+    };
+
+    LedgerReplayer (Application& app, Setup const& setup,
+        Fetch fetch, beast::Journal journal);
+
+    /** Replay the whole range.
+
+        @param onProgress Called on this thread about every `interval`
+                          while the replay runs, and once at the end.
+    */
+    Progress
+    run (std::function<void (Progress const&)> const& onProgress = {},
+        std::chrono::milliseconds interval = std::chrono::seconds (10));
+
+    /** Stop a replay in progress. Safe to call from any thread. */
+    void
+    stop()
+    {
+        stop_ = true;
+    }
+
+    /** Mismatches found by run, in ledger order. */
+    std::vector<Mismatch> const&
+    mismatches() const
+    {
+        return mismatches_;
+    }
+
+private:
+    Application& app_;
+    Setup setup_;
+    Fetch fetch_;
+    beast::Journal j_;
+    std::atomic<bool> stop_ {false};
+    std::vector<Mismatch> mismatches_;
+};
+
+} // ripple
+
+#endif
@@ -52,7 +52,8 @@ private:
     beast::Journal j_;
     CachedSLEs& cache_;
     std::mutex mutable modify_mutex_;
-    std::mutex mutable current_mutex_;
+    // Written only under modify_mutex_, with std::atomic_store, so
+    // that current() can take a snapshot without locking.
     std::shared_ptr<OpenView const> current_;
 
 public:
@@ -69,6 +69,8 @@ LedgerMaster::LedgerMaster (Application& app, Stopwatch& stopwatch,
     , mLedgerHistory (collector, app)
     , mLedgerCleaner (detail::make_LedgerCleaner (
         app, *this, app_.journal("LedgerCleaner")))
+    , mSeqHitCounter (collector->make_counter ("ledger.history", "seq_hit"))
+    , mSeqMissCounter (collector->make_counter ("ledger.history", "seq_miss"))
     , standalone_ (app_.config().standalone())
     , fetch_depth_ (app_.getSHAMapStore ().clampFetchDepth (
         app_.config().FETCH_DEPTH))
@@ -231,7 +233,7 @@ void
 LedgerMaster::setPubLedger(
     std::shared_ptr<Ledger const> const& l)
 {
-    mPubLedger = l;
+    mPubLedger.set (l);
     mPubLedgerClose = l->info().closeTime.time_since_epoch().count();
     mPubLedgerSeq = l->info().seq;
 }
@@ -640,7 +642,7 @@ LedgerMaster::setFullLedger (
 
         if (ledger->info().seq > mValidLedgerSeq)
             setValidLedger(ledger);
-        if (!mPubLedger)
+        if (mPubLedger.empty ())
         {
             setPubLedger(ledger);
             app_.getOrderBookDB().setup(ledger);
@@ -768,7 +770,7 @@ LedgerMaster::checkAccept (
     ledger->setValidated();
     ledger->setFull();
     setValidLedger(ledger);
-    if (!mPubLedger)
+    if (mPubLedger.empty ())
     {
         pendSaveValidated(app_, ledger, true, true);
         setPubLedger(ledger);
@@ -961,7 +963,7 @@ LedgerMaster::findNewLedgersToPublish ()
         return {};
     }
 
-    if (! mPubLedger)
+    if (mPubLedger.empty ())
     {
         JLOG(m_journal.info()) <<
             "First published ledger will be " << mValidLedgerSeq;
@@ -1238,13 +1240,72 @@ LedgerMaster::peekMutex ()
     return m_mutex;
 }
 
+// Only one read in this many on each thread is timed, so the ledger
+// accessors normally write no shared state and never read the clock.
+static std::uint32_t constexpr readSampleInterval = 64;
+
+class LedgerMaster::ReadTimer
+{
+public:
+    explicit
+    ReadTimer (LedgerMaster& lm)
+        : lm_ (sample () ? &lm : nullptr)
+    {
+        if (lm_)
+            start_ = std::chrono::steady_clock::now ();
+    }
+
+    ~ReadTimer ()
+    {
+        if (! lm_)
+            return;
+        auto const elapsed = static_cast<std::uint64_t> (
+            std::chrono::duration_cast<std::chrono::nanoseconds> (
+                std::chrono::steady_clock::now () - start_).count ());
+        ++lm_->mReads;
+        lm_->mReadWaitNanos += elapsed;
+        auto prev = lm_->mReadMaxWaitNanos.load (std::memory_order_relaxed);
+        while (prev < elapsed &&
+            ! lm_->mReadMaxWaitNanos.compare_exchange_weak (prev, elapsed))
+        {
+        }
+    }
+
+private:
+    static
+    bool
+    sample ()
+    {
+        static thread_local std::uint32_t reads = 0;
+        return ++reads % readSampleInterval == 0;
+    }
+
+    LedgerMaster* const lm_;
+    std::chrono::steady_clock::time_point start_;
+};
+
 // The current ledger is the ledger we believe new transactions should go in
 std::shared_ptr<ReadView const>
 LedgerMaster::getCurrentLedger ()
 {
+    ReadTimer timer (*this);
     return app_.openLedger().current();
 }
 
+std::shared_ptr<Ledger const>
+LedgerMaster::getClosedLedger ()
+{
+    ReadTimer timer (*this);
+    return mClosedLedger.get();
+}
+
+std::shared_ptr<Ledger const>
+LedgerMaster::getValidatedLedger ()
+{
+    ReadTimer timer (*this);
+    return mValidLedger.get();
+}
+
 Rules
 LedgerMaster::getValidatedRules ()
 {
@@ -1263,8 +1324,21 @@ LedgerMaster::getValidatedRules ()
 std::shared_ptr<ReadView const>
 LedgerMaster::getPublishedLedger ()
 {
-    ScopedLockType lock(m_mutex);
-    return mPubLedger;
+    ReadTimer timer (*this);
+    return mPubLedger.get ();
+}
+
+LedgerMaster::ReadStats
+LedgerMaster::getReadStats () const
+{
+    using namespace std::chrono;
+    ReadStats stats;
+    stats.reads = mReads.load () * readSampleInterval;
+    stats.totalWait = duration_cast<microseconds> (
+        nanoseconds (mReadWaitNanos.load () * readSampleInterval));
+    stats.maxWait = duration_cast<microseconds> (
+        nanoseconds (mReadMaxWaitNanos.load ()));
+    return stats;
 }
 
 std::string
@@ -1379,20 +1453,43 @@ LedgerMaster::walkHashBySeq (
 std::shared_ptr<Ledger const>
 LedgerMaster::getLedgerBySeq (std::uint32_t index)
 {
+    auto const hit = [this](std::shared_ptr<Ledger const> ledger)
+    {
+        ++mSeqHits;
+        ++mSeqHitCounter;
+        return ledger;
+    };
+    auto const miss = [this]()
+    {
+        ++mSeqMisses;
+        ++mSeqMissCounter;
+    };
+
     if (index <= mValidLedgerSeq)
     {
         // Always prefer a validated ledger
         if (auto valid = mValidLedger.get ())
         {
             if (valid->info().seq == index)
-                return valid;
+                return hit (std::move (valid));
+
+            // Only validated ledgers are pinned, so a pinned ledger
+            // saves walking the skip lists of the validated ledger
+            if (auto ret = mLedgerHistory.getPinnedLedger (index))
+                return hit (std::move (ret));
 
             try
             {
                 auto const hash = hashOfSeq(*valid, index, m_journal);
 
                 if (hash)
+                {
+                    if (auto ret = mLedgerHistory.getCachedLedgerByHash (*hash))
+                        return hit (std::move (ret));
+
+                    miss ();
                     return mLedgerHistory.getLedgerByHash (*hash);
+                }
             }
             catch (std::exception const&)
             {
@@ -1401,6 +1498,10 @@ LedgerMaster::getLedgerBySeq (std::uint32_t index)
         }
     }
 
+    if (auto ret = mLedgerHistory.getCachedLedgerBySeq (index))
+        return hit (std::move (ret));
+
+    miss ();
     if (auto ret = mLedgerHistory.getLedgerBySeq (index))
         return ret;
 
@@ -1457,6 +1558,12 @@ LedgerMaster::getCacheHitRate ()
     return mLedgerHistory.getCacheHitRate ();
 }
 
+LedgerMaster::SeqLookupStats
+LedgerMaster::getSeqLookupStats () const
+{
+    return { mSeqHits.load (), mSeqMisses.load () };
+}
+
 beast::PropertyStream::Source&
 LedgerMaster::getPropertySource ()
 {
@@ -1536,7 +1643,8 @@ void LedgerMaster::doAdvance (ScopedLockType& sl)
                 {
                     ScopedLockType sl (mCompleteLock);
                     maybeMissing =
-                        prevMissing(mCompleteLedgers, mPubLedger->info().seq);
+                        prevMissing(mCompleteLedgers,
+                            mPubLedger.get ()->info().seq);
                 }
                 if (maybeMissing)
                 {
@@ -0,0 +1,334 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerReplayer.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/basics/Log.h>
+#include <ripple/beast/core/CurrentThreadName.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/Feature.h>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace ripple {
+
+std::shared_ptr<Ledger>
+replayLedger (Application& app, Ledger const& parent, Ledger const& ledger,
+    std::size_t& transactions, beast::Journal j)
+{
+    // The metadata records the order the transactions were applied in
+    std::map<std::uint32_t, std::shared_ptr<STTx const>> txns;
+    for (auto const& tx : ledger.txs)
+    {
+        if (! tx.second)
+            Throw<std::runtime_error> ("transaction without metadata");
+        txns.emplace ((*tx.second)[sfTransactionIndex], tx.first);
+    }
+    transactions = txns.size();
+
+    auto const& info = ledger.info();
+    auto built = std::make_shared<Ledger> (parent, info.closeTime);
+    if (built->rules().enabled (featureSHAMapV2) &&
+            ! built->stateMap().is_v2())
+        built->make_v2();
+
+    {
+        OpenView accum (&*built);
+        for (auto const& tx : txns)
+            applyTransaction (app, accum, *tx.second, false,
+                tapNO_CHECK_SIGN, j);
+        accum.apply (*built);
+    }
+
+    built->updateSkipList();
+    built->setAccepted (info.closeTime, info.closeTimeResolution,
+        getCloseAgree (info), app.config());
+    return built;
+}
+
+//------------------------------------------------------------------------------
+
+LedgerReplayer::LedgerReplayer (Application& app, Setup const& setup,
+        Fetch fetch, beast::Journal journal)
+    : app_ (app)
+    , setup_ (setup)
+    , fetch_ (std::move (fetch))
+    , j_ (journal)
+{
+    // The genesis ledger has no parent to replay from
+    setup_.first = std::max<std::uint32_t> (setup_.first, 2);
+    setup_.workers = std::max<std::size_t> (setup_.workers, 1);
+    setup_.window = std::max (setup_.window, 2 * setup_.workers + 2);
+}
+
+LedgerReplayer::Progress
+LedgerReplayer::run (std::function<void (Progress const&)> const& onProgress,
+    std::chrono::milliseconds interval)
+{
+    using clock_type = std::chrono::steady_clock;
+
+    mismatches_.clear();
+    auto const first = setup_.first;
+    auto const last = setup_.last;
+    auto const start = clock_type::now();
+
+    // Fetched ledgers, with the number of replays that still need them
+    struct Entry
+    {
+        std::shared_ptr<Ledger const> ledger;
+        int uses;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::map<std::uint32_t, Entry> window;
+    std::uint32_t fetched = first - 1;
+    bool fetching = true;
+    std::size_t running = 0;
+    std::vector<Mismatch> found;
+    std::atomic<std::uint32_t> next {first};
+    std::atomic<std::size_t> ledgers {0};
+    std::atomic<std::size_t> transactions {0};
+
+    auto const progress = [&]
+    {
+        Progress p;
+        p.ledgers = ledgers;
+        p.transactions = transactions;
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            p.mismatches = found.size();
+        }
+        p.elapsed = clock_type::now() - start;
+        return p;
+    };
+
+    // The waits below wake up at nextReport, so it must move on
+    // even when nobody is listening, or they would spin.
+    auto nextReport = start + interval;
+    auto const report = [&]
+    {
+        if (clock_type::now() >= nextReport)
+        {
+            if (onProgress)
+                onProgress (progress());
+            nextReport = clock_type::now() + interval;
+        }
+    };
+
+    // Returns a description of what is wrong, or nothing
+    auto const check = [&](std::uint32_t seq,
+        std::shared_ptr<Ledger const> const& parent,
+        std::shared_ptr<Ledger const> const& ledger)
+            -> boost::optional<Mismatch>
+    {
+        Mismatch m;
+        m.seq = seq;
+        if (! ledger)
+        {
+            m.reason = "ledger not found";
+            return m;
+        }
+        m.expected = ledger->info().hash;
+        if (! parent)
+        {
+            m.reason = "parent ledger not found";
+            return m;
+        }
+        if (ledger->info().parentHash != parent->info().hash)
+        {
+            m.reason = "parent hash does not match";
+            return m;
+        }
+
+        try
+        {
+            std::size_t count = 0;
+            auto const built = replayLedger (app_, *parent, *ledger, count, j_);
+            transactions += count;
+            m.actual = built->info().hash;
+            if (m.actual == m.expected)
+                return boost::none;
+
+            if (built->info().accountHash != ledger->info().accountHash)
+            {
+                m.reason = "state does not match";
+                if (setup_.maxDifferences > 0)
+                    built->stateMap().visitDelta (ledger->stateMap(),
+                        [&](uint256 const& key,
+                            std::shared_ptr<SHAMapItem const> const&,
+                            std::shared_ptr<SHAMapItem const> const&)
+                        {
+                            m.keys.push_back (key);
+                            return m.keys.size() < setup_.maxDifferences;
+                        });
+            }
+            else if (built->info().txHash != ledger->info().txHash)
+            {
+                m.reason = "transactions do not match";
+            }
+            else
+            {
+                m.reason = "header does not match";
+            }
+        }
+        catch (std::exception const& e)
+        {
+            m.reason = std::string ("replay failed: ") + e.what();
+        }
+        return m;
+    };
+
+    // Called with the lock held
+    auto const release = [&](std::uint32_t seq)
+    {
+        auto const iter = window.find (seq);
+        if (iter != window.end() && --iter->second.uses == 0)
+        {
+            window.erase (iter);
+            cond.notify_all();
+        }
+    };
+
+    auto const work = [&]
+    {
+        beast::setCurrentThreadName ("replay");
+        for (auto seq = next++; seq <= last && ! stop_; seq = next++)
+        {
+            std::shared_ptr<Ledger const> parent;
+            std::shared_ptr<Ledger const> ledger;
+            {
+                std::unique_lock<std::mutex> lock (mutex);
+                cond.wait (lock, [&]
+                    {
+                        return stop_ || fetched > seq || ! fetching;
+                    });
+                if (fetched <= seq)
+                    break;
+                parent = window[seq - 1].ledger;
+                ledger = window[seq].ledger;
+            }
+
+            auto mismatch = check (seq, parent, ledger);
+            if (mismatch)
+            {
+                JLOG(j_.warn()) << "Replay of ledger " << seq <<
+                    ": " << mismatch->reason;
+            }
+            ++ledgers;
+
+            std::lock_guard<std::mutex> lock (mutex);
+            release (seq - 1);
+            release (seq);
+            if (mismatch)
+                found.push_back (std::move (*mismatch));
+        }
+
+        std::lock_guard<std::mutex> lock (mutex);
+        --running;
+        cond.notify_all();
+    };
+
+    std::vector<std::thread> threads;
+    running = setup_.workers;
+    for (std::size_t i = 0; i < setup_.workers; ++i)
+        threads.emplace_back (work);
+
+    // Fetch ledgers in order on this thread, a window ahead of the workers
+    for (auto seq = first - 1; seq <= last && ! stop_; ++seq)
+    {
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            while (window.size() >= setup_.window && ! stop_)
+            {
+                if (cond.wait_until (lock, nextReport) ==
+                    std::cv_status::timeout)
+                {
+                    lock.unlock();
+                    report();
+                    lock.lock();
+                }
+            }
+        }
+
+        std::shared_ptr<Ledger const> ledger;
+        try
+        {
+            ledger = fetch_ (seq);
+
+            // Load the transactions while the workers are busy
+            if (ledger)
+                for (auto const& item : ledger->txMap())
+                    (void)item;
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.warn()) << "Unable to load ledger " << seq <<
+                ": " << e.what();
+            ledger.reset();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            window[seq] = Entry{std::move (ledger),
+                (seq == first - 1 || seq == last) ? 1 : 2};
+            fetched = seq + 1;
+            cond.notify_all();
+        }
+        report();
+    }
+
+    {
+        std::unique_lock<std::mutex> lock (mutex);
+        fetching = false;
+        cond.notify_all();
+        while (running > 0)
+        {
+            if (cond.wait_until (lock, nextReport) == std::cv_status::timeout)
+            {
+                lock.unlock();
+                report();
+                lock.lock();
+            }
+        }
+    }
+    for (auto& t : threads)
+        t.join();
+
+    auto const result = progress();
+
+    std::sort (found.begin(), found.end(),
+        [](Mismatch const& a, Mismatch const& b)
+        {
+            return a.seq < b.seq;
+        });
+    mismatches_ = std::move (found);
+
+    if (onProgress)
+        onProgress (result);
+    return result;
+}
+
+} // ripple
@@ -53,10 +53,7 @@ OpenLedger::empty() const
 std::shared_ptr<OpenView const>
 OpenLedger::current() const
 {
-    std::lock_guard<
-        std::mutex> lock(
-            current_mutex_);
-    return current_;
+    return std::atomic_load(&current_);
 }
 
 bool
@@ -68,12 +65,8 @@ OpenLedger::modify (modify_type const& f)
         OpenView>(*current_);
     auto const changed = f(*next, j_);
     if (changed)
-    {
-        std::lock_guard<
-            std::mutex> lock2(
-                current_mutex_);
-        current_ = std::move(next);
-    }
+        std::atomic_store(&current_,
+            std::shared_ptr<OpenView const>(std::move(next)));
     return changed;
 }
 
@@ -165,9 +158,8 @@ OpenLedger::accept(Application& app, Rules const& rules,
     }
 
     // Switch to the new open view
-    std::lock_guard<
-        std::mutex> lock2(current_mutex_);
-    current_ = std::move(next);
+    std::atomic_store(&current_,
+        std::shared_ptr<OpenView const>(std::move(next)));
 }
 
 //------------------------------------------------------------------------------
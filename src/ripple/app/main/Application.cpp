@@ -55,6 +55,8 @@
 #include <ripple/protocol/STParsedJSON.h>
 #include <ripple/protocol/Protocol.h>
 #include <ripple/resource/Fees.h>
+#include <ripple/rpc/ResponseCache.h>
+#include <ripple/shamap/TreeNodeSnapshot.h>
 #include <ripple/beast/asio/io_latency_probe.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <boost/asio/steady_timer.hpp>
@@ -299,6 +301,7 @@ public:
     NodeCache m_tempNodeCache;
     std::unique_ptr <CollectorManager> m_collectorManager;
     CachedSLEs cachedSLEs_;
+    std::unique_ptr <RPC::ResponseCache> responseCache_;
     std::pair<PublicKey, SecretKey> nodeIdentity_;
     ValidatorKeys const validatorKeys_;
 
@@ -333,6 +336,14 @@ public:
     boost::asio::steady_timer entropyTimer_;
     bool startTimers_;
 
+    // Tree nodes saved at shutdown and read back at startup
+    boost::filesystem::path snapshotPath_;
+    std::size_t snapshotMaxNodes_ = 0;
+    std::chrono::minutes snapshotInterval_ {0};
+    std::mutex snapshotMutex_;
+    std::chrono::steady_clock::time_point snapshotSaved_;
+    std::vector <std::shared_ptr<SHAMapAbstractNode>> snapshotNodes_;
+
     std::unique_ptr <DatabaseCon> mTxnDB;
     std::unique_ptr <DatabaseCon> mLedgerDB;
     std::unique_ptr <DatabaseCon> mWalletDB;
@@ -391,7 +402,11 @@ public:
 
         , m_collectorManager (CollectorManager::New (
             config_->section (SECTION_INSIGHT), logs_->journal("Collector")))
-        , cachedSLEs_ (std::chrono::minutes(1), stopwatch())
+        , cachedSLEs_ (std::chrono::minutes(1), stopwatch(),
+            config_->getSize (siSLECacheSize))
+        , responseCache_ (std::make_unique<RPC::ResponseCache> (
+            config_->getSize (siRPCCacheSize) * 1024 * 1024,
+            m_collectorManager->group ("rpc_cache")))
         , validatorKeys_(*config_, m_journal)
 
         , m_resourceManager (Resource::make_Manager (
@@ -468,7 +483,8 @@ public:
 
         , mHashRouter (std::make_unique<HashRouter>(
             stopwatch(), HashRouter::getDefaultHoldTime (),
-            HashRouter::getDefaultRecoverLimit ()))
+            HashRouter::getDefaultRecoverLimit (),
+            HashRouter::getDefaultShardCount ()))
 
         , mValidations (ValidationParms(),stopwatch(), logs_->journal("Validations"),
             *this)
@@ -511,6 +527,7 @@ public:
 
         // VFALCO HACK
         m_nodeStoreScheduler.setJobQueue (*m_jobQueue);
+        m_nodeStoreScheduler.setCollector (m_collectorManager->collector ());
 
         add (m_ledgerMaster->getPropertySource ());
     }
@@ -656,6 +673,11 @@ public:
         return *m_pathRequests;
     }
 
+    RPC::ResponseCache& getResponseCache () override
+    {
+        return *responseCache_;
+    }
+
     CachedSLEs&
     cachedSLEs() override
     {
@@ -998,6 +1020,19 @@ public:
         family().treecache().sweep();
         cachedSLEs_.expire();
 
+        // Once the server is in sync, the ledgers it loaded hold on to
+        // the nodes they use and the rest can age out of the cache.
+        if (! snapshotNodes_.empty() &&
+            (config_->standalone() || m_networkOPs->isFull()))
+        {
+            JLOG(m_journal.debug()) << "Releasing snapshot tree nodes";
+            std::vector <std::shared_ptr<SHAMapAbstractNode>> ().swap (
+                snapshotNodes_);
+        }
+
+        if (snapshotInterval_.count() > 0)
+            saveSnapshot (snapshotInterval_);
+
         // Set timer to do another sweep later.
         setSweepTimer();
     }
@@ -1017,6 +1052,8 @@ private:
     void addValidationSeqFields();
     bool updateTables ();
     void startGenesisLedger ();
+    void loadSnapshot ();
+    void saveSnapshot (std::chrono::minutes age = {});
 
     std::shared_ptr<Ledger>
     getLastFullLedger();
@@ -1115,6 +1152,8 @@ bool ApplicationImp::setup()
 
     Pathfinder::initPathTable();
 
+    loadSnapshot ();
+
     auto const startUp = config_->START_UP;
     if (startUp == Config::FRESH)
     {
@@ -1317,6 +1356,7 @@ ApplicationImp::run()
     // Stop the server. When this returns, all
     // Stoppable objects should be stopped.
     JLOG(m_journal.info()) << "Received shutdown request";
+    saveSnapshot ();
     stop (m_journal);
     JLOG(m_journal.info()) << "Done.";
     StopSustain();
@@ -1396,6 +1436,85 @@ ApplicationImp::startGenesisLedger()
     m_ledgerMaster->switchLCL (next);
 }
 
+void
+ApplicationImp::loadSnapshot()
+{
+    if (! config_->exists (SECTION_LEDGER_SNAPSHOT))
+        return;
+
+    auto const& section = config_->section (SECTION_LEDGER_SNAPSHOT);
+    std::string path;
+    if (! get_if_exists (section, "path", path))
+    {
+        auto const dir = config_->legacy ("database_path");
+        if (dir.empty ())
+        {
+            JLOG(m_journal.warn()) <<
+                "No [database_path] for the ledger snapshot";
+            return;
+        }
+        path = (boost::filesystem::path (dir) / "ledger.snapshot").string ();
+    }
+    snapshotPath_ = path;
+
+    snapshotMaxNodes_ = config_->getSize (siTreeCacheSize);
+    get_if_exists (section, "max_nodes", snapshotMaxNodes_);
+
+    int interval = 30;
+    get_if_exists (section, "interval", interval);
+    snapshotInterval_ = std::chrono::minutes (std::max (interval, 0));
+    snapshotSaved_ = std::chrono::steady_clock::now ();
+
+    try
+    {
+        auto const start = std::chrono::steady_clock::now ();
+        snapshotNodes_ = loadTreeNodeSnapshot (family (), snapshotPath_);
+        JLOG(m_journal.info()) <<
+            "Loaded " << snapshotNodes_.size () << " tree nodes from " <<
+            path << " in " << std::chrono::duration_cast<
+                std::chrono::milliseconds> (
+                    std::chrono::steady_clock::now () - start).count () <<
+            "ms";
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(m_journal.warn()) <<
+            "Unable to load ledger snapshot: " << e.what ();
+    }
+}
+
+// Does nothing if the last snapshot is younger than `age`
+void
+ApplicationImp::saveSnapshot(std::chrono::minutes age)
+{
+    if (snapshotPath_.empty ())
+        return;
+
+    std::lock_guard <std::mutex> lock (snapshotMutex_);
+    if (std::chrono::steady_clock::now () - snapshotSaved_ < age)
+        return;
+
+    try
+    {
+        auto const start = std::chrono::steady_clock::now ();
+        auto const count = saveTreeNodeSnapshot (
+            family (), snapshotPath_, snapshotMaxNodes_);
+        JLOG(m_journal.info()) <<
+            "Saved " << count << " tree nodes to " <<
+            snapshotPath_.string () << " in " << std::chrono::duration_cast<
+                std::chrono::milliseconds> (
+                    std::chrono::steady_clock::now () - start).count () <<
+            "ms";
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(m_journal.warn()) <<
+            "Unable to save ledger snapshot: " << e.what ();
+    }
+
+    snapshotSaved_ = std::chrono::steady_clock::now ();
+}
+
 std::shared_ptr<Ledger>
 ApplicationImp::getLastFullLedger()
 {
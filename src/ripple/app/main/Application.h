@@ -35,6 +35,7 @@ namespace ripple {
 
 namespace unl { class Manager; }
 namespace Resource { class Manager; }
+namespace RPC { class ResponseCache; }
 namespace NodeStore { class Database; }
 
 // VFALCO TODO Fix forward declares required for header dependency loops
@@ -157,6 +158,7 @@ public:
 
     virtual Resource::Manager&      getResourceManager () = 0;
     virtual PathRequests&           getPathRequests () = 0;
+    virtual RPC::ResponseCache&     getResponseCache () = 0;
     virtual SHAMapStore&            getSHAMapStore () = 0;
     virtual PendingSaves&           pendingSaves() = 0;
     virtual AccountIDCache const&   accountIDCache() const = 0;
@@ -19,7 +19,11 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/main/CollectorManager.h>
+#include <ripple/protocol/JsonFields.h>
+#include <array>
+#include <map>
 #include <memory>
+#include <mutex>
 
 namespace ripple {
 
@@ -31,6 +35,20 @@ public:
     beast::insight::Collector::ptr m_collector;
     std::unique_ptr <beast::insight::Groups> m_groups;
 
+    // Percentiles of each histogram over the last collection interval
+    struct HistogramGauges
+    {
+        beast::insight::HistogramSnapshot last;
+        beast::insight::Gauge count;
+        beast::insight::Gauge p50;
+        beast::insight::Gauge p99;
+        beast::insight::Gauge max;
+    };
+
+    std::mutex m_histogramMutex;
+    std::map <std::string, HistogramGauges> m_histogramGauges;
+    beast::insight::Hook m_histogramHook;
+
     CollectorManagerImp (Section const& params,
         beast::Journal journal)
         : m_journal (journal)
@@ -44,6 +62,8 @@ public:
             std::string const& prefix (get<std::string> (params, "prefix"));
 
             m_collector = beast::insight::StatsDCollector::New (address, prefix, journal);
+            m_histogramHook = m_collector->make_hook (
+                std::bind (&CollectorManagerImp::collectHistograms, this));
         }
         else
         {
@@ -66,6 +86,34 @@ public:
     {
         return m_groups->get (name);
     }
+
+    // Send the recent values of every histogram as gauges
+    void collectHistograms ()
+    {
+        std::lock_guard <std::mutex> lock (m_histogramMutex);
+        for (auto& snapshot : m_collector->histograms ())
+        {
+            auto iter = m_histogramGauges.find (snapshot.name);
+            if (iter == m_histogramGauges.end ())
+            {
+                auto const& name = snapshot.name;
+                HistogramGauges g;
+                g.count = m_collector->make_gauge (name, "count");
+                g.p50 = m_collector->make_gauge (name, "p50");
+                g.p99 = m_collector->make_gauge (name, "p99");
+                g.max = m_collector->make_gauge (name, "max");
+                iter = m_histogramGauges.emplace (name, std::move (g)).first;
+            }
+
+            auto& g = iter->second;
+            auto const recent = snapshot.since (g.last);
+            g.count = recent.count;
+            g.p50 = recent.percentile (0.5);
+            g.p99 = recent.percentile (0.99);
+            g.max = recent.max;
+            g.last = std::move (snapshot);
+        }
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -80,4 +128,28 @@ std::unique_ptr<CollectorManager> CollectorManager::New(Section const& params,
     return std::make_unique<CollectorManagerImp>(params, journal);
 }
 
+Json::Value
+getHistogramJson (beast::insight::Collector& collector, bool full)
+{
+    Json::Value ret (Json::objectValue);
+    for (auto const& h : collector.histograms ())
+    {
+        if (h.count == 0)
+            continue;
+
+        Json::Value& entry = ret[h.name] = Json::objectValue;
+        if (full)
+        {
+            entry[jss::count] = std::to_string (h.count);
+            entry[jss::mean_us] = std::to_string (h.mean ());
+        }
+        entry[jss::p50_us] = std::to_string (h.percentile (0.5));
+        if (full)
+            entry[jss::p90_us] = std::to_string (h.percentile (0.9));
+        entry[jss::p99_us] = std::to_string (h.percentile (0.99));
+        entry[jss::max_us] = std::to_string (h.max);
+    }
+    return ret;
+}
+
 }
@@ -22,6 +22,7 @@
 
 #include <ripple/basics/BasicConfig.h>
 #include <ripple/beast/insight/Insight.h>
+#include <ripple/json/json_value.h>
 
 namespace ripple {
 
@@ -38,6 +39,17 @@ public:
         std::string const& name) = 0;
 };
 
+/** Summarize the latency histograms, in microseconds.
+
+    Histograms that have not recorded anything are left out.
+
+    @param collector The collector the histograms were created with.
+    @param full Report the count, mean and more percentiles, rather
+                than only the median, 99th percentile and maximum.
+*/
+Json::Value
+getHistogramJson (beast::insight::Collector& collector, bool full);
+
 }
 
 #endif
@@ -22,6 +22,7 @@
 #include <ripple/basics/Log.h>
 #include <ripple/protocol/digest.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/ledger/LedgerReplayer.h>
 #include <ripple/basics/CheckLibraryVersions.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/StringUtilities.h>
@@ -38,6 +39,7 @@
 #include <ripple/protocol/BuildInfo.h>
 #include <ripple/beast/clock/basic_seconds_clock.h>
 #include <ripple/beast/core/CurrentThreadName.h>
+#include <ripple/beast/core/LexicalCast.h>
 #include <ripple/beast/core/Time.h>
 #include <ripple/beast/utility/Debug.h>
 
@@ -54,6 +56,7 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <thread>
 #include <utility>
 #include <stdexcept>
 
@@ -163,6 +166,8 @@ void printHelp (const po::options_description& desc)
            "     random\n"
            "     ripple ...\n"
            "     ripple_path_find <json> [<ledger>]\n"
+           "     rpc_cache [clear]\n"
+           "     rpc_costs\n"
            "     version\n"
            "     server_info\n"
            "     sign <private_key> <tx_json> [offline]\n"
@@ -178,6 +183,68 @@ void printHelp (const po::options_description& desc)
 
 //------------------------------------------------------------------------------
 
+// Parses "<first>-<last>". The genesis ledger can't be replayed.
+static bool parseLedgerRange (std::string const& range,
+    std::uint32_t& first, std::uint32_t& last)
+{
+    auto const dash = range.find ('-');
+    if (dash == std::string::npos)
+        return false;
+    return beast::lexicalCastChecked (first, range.substr (0, dash)) &&
+        beast::lexicalCastChecked (last, range.substr (dash + 1)) &&
+        first <= last && last > 1;
+}
+
+static int replayLedgers (Application& app,
+    std::uint32_t first, std::uint32_t last, std::size_t threads)
+{
+    LedgerReplayer::Setup setup;
+    setup.first = first;
+    setup.last = last;
+    setup.workers = threads;
+
+    LedgerReplayer replayer (app, setup,
+        [&app](std::uint32_t seq) -> std::shared_ptr<Ledger const>
+        {
+            return loadByIndex (seq, app);
+        },
+        app.journal ("LedgerReplayer"));
+
+    std::cout << "Replaying ledgers " << first << " through " << last <<
+        " on " << threads << " threads" << std::endl;
+
+    auto const total = last - std::max<std::uint32_t> (first, 2) + 1;
+    auto const result = replayer.run (
+        [total](LedgerReplayer::Progress const& p)
+        {
+            auto const seconds = std::max (std::chrono::duration<double> (
+                p.elapsed).count(), 0.001);
+            std::cout << p.ledgers << "/" << total << " ledgers, " <<
+                p.transactions << " transactions in " <<
+                static_cast<std::uint64_t> (seconds) << "s (" <<
+                static_cast<std::uint64_t> (p.ledgers / seconds) <<
+                " ledgers/s, " <<
+                static_cast<std::uint64_t> (p.transactions / seconds) <<
+                " tx/s), " << p.mismatches << " mismatches" << std::endl;
+        });
+
+    for (auto const& m : replayer.mismatches())
+    {
+        std::cout << "Ledger " << m.seq << ": " << m.reason;
+        if (m.expected.isNonZero())
+            std::cout << "\n    stored   " << m.expected;
+        if (m.actual.isNonZero())
+            std::cout << "\n    replayed " << m.actual;
+        for (auto const& key : m.keys)
+            std::cout << "\n    entry    " << key;
+        std::cout << std::endl;
+    }
+
+    return result.mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//------------------------------------------------------------------------------
+
 static int runUnitTests(
     std::string const& pattern,
     std::string const& argument,
@@ -303,6 +370,8 @@ int run (int argc, char** argv)
     ("debug", "Enable normally suppressed debug logging")
     ("fg", "Run in the foreground.")
     ("import", importText.c_str ())
+    ("replay_range", po::value<std::string> (), "Replay the stored ledgers <first>-<last> offline and verify their hashes.")
+    ("replay_threads", po::value<std::size_t> (), "Threads for --replay_range (default: all cores).")
     ("version", "Display the build version.")
     ;
 
@@ -380,6 +449,15 @@ int run (int argc, char** argv)
 #endif
     }
 
+    std::uint32_t replayFirst = 0;
+    std::uint32_t replayLast = 0;
+    if (vm.count ("replay_range") && ! parseLedgerRange (
+        vm["replay_range"].as<std::string> (), replayFirst, replayLast))
+    {
+        std::cerr << "Invalid --replay_range, expected <first>-<last>\n";
+        return 1;
+    }
+
     auto config = std::make_unique<Config>();
 
     auto configFile = vm.count ("conf") ?
@@ -387,7 +465,8 @@ int run (int argc, char** argv)
 
     // config file, quiet flag.
     config->setup (configFile, bool (vm.count ("quiet")),
-        bool(vm.count("silent")), bool(vm.count("standalone")));
+        bool(vm.count("silent")),
+        bool(vm.count("standalone")) || bool(vm.count("replay_range")));
 
     {
         // Stir any previously saved entropy into the pool:
@@ -550,6 +629,21 @@ int run (int argc, char** argv)
             return -1;
         }
 
+        if (vm.count ("replay_range"))
+        {
+            auto const threads = vm.count ("replay_threads") ?
+                vm["replay_threads"].as<std::size_t> () :
+                std::size_t (std::max (1u,
+                    std::thread::hardware_concurrency ()));
+
+            app->doStart(false /*don't start timers*/);
+            auto const ret = replayLedgers (
+                *app, replayFirst, replayLast, threads);
+            app->signalStop();
+            app->run();
+            return ret;
+        }
+
         // Start the server
         app->doStart(true /*start timers*/);
 
@@ -33,6 +33,13 @@ void NodeStoreScheduler::setJobQueue (JobQueue& jobQueue)
     m_jobQueue = &jobQueue;
 }
 
+void NodeStoreScheduler::setCollector (
+    beast::insight::Collector::ptr const& collector)
+{
+    m_fetchTime = collector->make_histogram ("node_fetch");
+    m_fetchDiskTime = collector->make_histogram ("node_fetch_disk");
+}
+
 void NodeStoreScheduler::onStop ()
 {
 }
@@ -74,10 +81,15 @@ void NodeStoreScheduler::doTask (NodeStore::Task& task)
 
 void NodeStoreScheduler::onFetch (NodeStore::FetchReport const& report)
 {
+    m_fetchTime.notify (report.elapsed);
     if (report.wentToDisk)
+    {
+        m_fetchDiskTime.notify (report.elapsed);
         m_jobQueue->addLoadEvents (
             report.isAsync ? jtNS_ASYNC_READ : jtNS_SYNC_READ,
-                1, report.elapsed);
+                1, std::chrono::duration_cast <std::chrono::milliseconds> (
+                    report.elapsed));
+    }
 }
 
 void NodeStoreScheduler::onBatchWrite (NodeStore::BatchWriteReport const& report)
@@ -21,6 +21,7 @@
 #define RIPPLE_APP_MAIN_NODESTORESCHEDULER_H_INCLUDED
 
 #include <ripple/nodestore/Scheduler.h>
+#include <ripple/beast/insight/Insight.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/core/Stoppable.h>
 #include <atomic>
@@ -40,6 +41,11 @@ public:
     //
     void setJobQueue (JobQueue& jobQueue);
 
+    /** Time every fetch, and those that read the backend, in
+        histograms created with the given collector.
+    */
+    void setCollector (beast::insight::Collector::ptr const& collector);
+
     void onStop () override;
     void onChildrenStopped () override;
     void scheduleTask (NodeStore::Task& task) override;
@@ -50,6 +56,8 @@ private:
     void doTask (NodeStore::Task& task);
 
     JobQueue* m_jobQueue {nullptr};
+    beast::insight::Histogram m_fetchTime;
+    beast::insight::Histogram m_fetchDiskTime;
     std::atomic <int> m_taskCount {0};
 };
 
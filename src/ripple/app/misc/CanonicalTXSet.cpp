@@ -19,7 +19,8 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
-#include <boost/range/adaptor/transformed.hpp>
+#include <algorithm>
+#include <cassert>
 
 namespace ripple {
 
@@ -86,50 +87,110 @@ uint256 CanonicalTXSet::accountKey (AccountID const& account)
     return ret;
 }
 
+void CanonicalTXSet::normalize () const
+{
+    if (mSorted == mEntries.size ())
+        return;
+
+    auto const erased = [](value_type const& v)
+    {
+        return ! v.second;
+    };
+
+    if (mErased != 0)
+    {
+        // Removal keeps the order, so the sorted part just
+        // loses its own tombstones
+        mSorted -= std::count_if (mEntries.begin (),
+            mEntries.begin () + mSorted, erased);
+        mEntries.erase (
+            std::remove_if (mEntries.begin (), mEntries.end (), erased),
+            mEntries.end ());
+        mErased = 0;
+    }
+
+    auto const less = [](value_type const& lhs, value_type const& rhs)
+    {
+        return lhs.first < rhs.first;
+    };
+
+    // Only the entries added since the last sort need sorting
+    auto const middle = mEntries.begin () + mSorted;
+    std::sort (middle, mEntries.end (), less);
+    std::inplace_merge (mEntries.begin (), middle, mEntries.end (), less);
+
+    // The same transaction may have been inserted more than once
+    mEntries.erase (
+        std::unique (mEntries.begin (), mEntries.end (),
+            [](value_type const& lhs, value_type const& rhs)
+            {
+                return lhs.first == rhs.first;
+            }),
+        mEntries.end ());
+    mSorted = mEntries.size ();
+}
+
 void CanonicalTXSet::insert (std::shared_ptr<STTx const> const& txn)
 {
-    mMap.insert (
-        std::make_pair (
-            Key (
-                accountKey (txn->getAccountID(sfAccount)),
-                txn->getSequence (),
-                txn->getTransactionID ()),
-            txn));
+    Key key (
+        accountKey (txn->getAccountID(sfAccount)),
+        txn->getSequence (),
+        txn->getTransactionID ());
+
+    // Appending in order, which is common when the set is being
+    // rebuilt from another ordered source, keeps the set sorted.
+    bool const inOrder = mSorted == mEntries.size () &&
+        (mEntries.empty () || mEntries.back ().first < key);
+
+    mEntries.emplace_back (std::move (key), txn);
+    if (inOrder)
+        ++mSorted;
 }
 
 std::vector<std::shared_ptr<STTx const>>
 CanonicalTXSet::prune(AccountID const& account,
     std::uint32_t const seq)
 {
+    normalize ();
+
     auto effectiveAccount = accountKey (account);
 
     Key keyLow(effectiveAccount, seq, zero);
     Key keyHigh(effectiveAccount, seq+1, zero);
 
-    auto range = boost::make_iterator_range(
-        mMap.lower_bound(keyLow),
-            mMap.lower_bound(keyHigh));
-    auto txRange = boost::adaptors::transform(
-        range,
-    [](auto const& p)
+    auto const less = [](value_type const& v, Key const& key)
     {
-        return p.second;
-    });
+        return v.first < key;
+    };
 
-    std::vector<std::shared_ptr<STTx const>> result(
-        txRange.begin(), txRange.end());
+    auto first = std::lower_bound (
+        mEntries.begin (), mEntries.end (), keyLow, less);
+    auto last = std::lower_bound (
+        first, mEntries.end (), keyHigh, less);
+
+    std::vector<std::shared_ptr<STTx const>> result;
+    result.reserve (std::distance (first, last));
+    for (auto it = first; it != last; ++it)
+    {
+        if (it->second)
+            result.push_back (std::move (it->second));
+        else
+            --mErased;
+    }
 
-    mMap.erase(range.begin(), range.end());
+    mEntries.erase (first, last);
+    mSorted = mEntries.size ();
 
     return result;
 }
 
 CanonicalTXSet::iterator CanonicalTXSet::erase (iterator const& it)
 {
-    iterator tmp = it;
-    ++tmp;
-    mMap.erase (it);
-    return tmp;
+    assert (it != end ());
+    // Leave a tombstone, so the remaining iterators stay valid
+    it.base ()->second.reset ();
+    ++mErased;
+    return std::next (it);
 }
 
 } // ripple
@@ -22,6 +22,8 @@
 
 #include <ripple/protocol/RippleLedgerHash.h>
 #include <ripple/protocol/STTx.h>
+#include <boost/iterator/filter_iterator.hpp>
+#include <vector>
 
 namespace ripple {
 
@@ -31,6 +33,18 @@ namespace ripple {
 
     - Puts transactions from the same account in sequence order
 
+    The set is normally filled all at once, then walked several times
+    while entries are erased as they apply. So rather than a node based
+    map, transactions are appended to a flat vector which is sorted
+    (and de-duplicated) the first time the order is needed. Entries
+    appended after that are sorted on their own and merged in, so
+    interleaving inserts with `prune` doesn't sort the whole set each
+    time. Erasing leaves a tombstone in place, so erasing never moves
+    other entries, and the tombstones are compacted away the next time
+    the set has to be sorted.
+
+    @note Calling `insert`, `prune` or `reset` invalidates all
+          outstanding iterators.
 */
 // VFALCO TODO rename to SortedTxSet
 class CanonicalTXSet
@@ -71,12 +85,30 @@ private:
         std::uint32_t mSeq;
     };
 
+    using value_type = std::pair <Key, std::shared_ptr<STTx const>>;
+    using container_type = std::vector <value_type>;
+
+    // Skips over erased entries
+    struct IsLive
+    {
+        bool operator() (value_type const& v) const
+        {
+            return v.second != nullptr;
+        }
+    };
+
     // Calculate the salted key for the given account
     uint256 accountKey (AccountID const& account);
 
+    // Restore canonical order after an insert. Also drops
+    // duplicates and tombstones.
+    void normalize () const;
+
 public:
-    using iterator = std::map <Key, std::shared_ptr<STTx const>>::iterator;
-    using const_iterator = std::map <Key, std::shared_ptr<STTx const>>::const_iterator;
+    using iterator = boost::filter_iterator <IsLive,
+        container_type::iterator>;
+    using const_iterator = boost::filter_iterator <IsLive,
+        container_type::const_iterator>;
 
 public:
     explicit CanonicalTXSet (LedgerHash const& saltHash)
@@ -94,41 +126,55 @@ public:
     {
         mSetHash = saltHash;
 
-        mMap.clear ();
+        mEntries.clear ();
+        mSorted = 0;
+        mErased = 0;
     }
 
     iterator erase (iterator const& it);
 
     iterator begin ()
     {
-        return mMap.begin ();
+        normalize ();
+        return iterator (mEntries.begin (), mEntries.end ());
     }
     iterator end ()
     {
-        return mMap.end ();
+        normalize ();
+        return iterator (mEntries.end (), mEntries.end ());
     }
     const_iterator begin ()  const
     {
-        return mMap.begin ();
+        normalize ();
+        return const_iterator (mEntries.cbegin (), mEntries.cend ());
     }
     const_iterator end () const
     {
-        return mMap.end ();
+        normalize ();
+        return const_iterator (mEntries.cend (), mEntries.cend ());
     }
     size_t size () const
     {
-        return mMap.size ();
+        normalize ();
+        return mEntries.size () - mErased;
     }
     bool empty () const
     {
-        return mMap.empty ();
+        return size () == 0;
     }
 
 private:
     // Used to salt the accounts so people can't mine for low account numbers
     uint256 mSetHash;
 
-    std::map <Key, std::shared_ptr<STTx const>> mMap;
+    // Sorting is deferred until the order is needed, so these
+    // are mutable to allow sorting from const member functions.
+    mutable container_type mEntries;
+    // Number of leading entries of mEntries that are in canonical
+    // order, without duplicates
+    mutable std::size_t mSorted = 0;
+    // Number of tombstones in mEntries
+    mutable std::size_t mErased = 0;
 };
 
 } // ripple
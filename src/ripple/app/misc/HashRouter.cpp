@@ -22,74 +22,102 @@
 
 namespace ripple {
 
+HashRouter::HashRouter (Stopwatch& clock,
+        std::chrono::seconds entryHoldTimeInSeconds,
+            std::uint32_t recoverLimit, std::size_t shardCount)
+    : shardHash_ {}
+    , holdTime_ (entryHoldTimeInSeconds)
+    , recoverLimit_ (recoverLimit + 1u)
+{
+    assert (shardCount != 0);
+    shards_.reserve (shardCount);
+    for (std::size_t i = 0; i < shardCount; ++i)
+        shards_.push_back (std::make_unique<Shard> (clock));
+}
+
+auto
+HashRouter::shard (uint256 const& key)
+    -> Shard&
+{
+    if (shards_.size () == 1)
+        return *shards_.front ();
+    return *shards_[shardHash_ (key) % shards_.size ()];
+}
+
 auto
-HashRouter::emplace (uint256 const& key)
+HashRouter::emplace (Shard& shard, uint256 const& key)
     -> std::pair<Entry&, bool>
 {
-    auto iter = suppressionMap_.find (key);
+    auto& suppressionMap = shard.suppressionMap;
+    auto iter = suppressionMap.find (key);
 
-    if (iter != suppressionMap_.end ())
+    if (iter != suppressionMap.end ())
     {
-        suppressionMap_.touch(iter);
+        suppressionMap.touch(iter);
         return std::make_pair(
             std::ref(iter->second), false);
     }
 
-    // See if any supressions need to be expired
-    expire(suppressionMap_, holdTime_);
+    // See if any supressions in this shard need to be expired
+    expire(suppressionMap, holdTime_);
 
     return std::make_pair(std::ref(
-        suppressionMap_.emplace (
+        suppressionMap.emplace (
             key, Entry ()).first->second),
                 true);
 }
 
 void HashRouter::addSuppression (uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& s = shard (key);
+    std::lock_guard <std::mutex> lock (s.mutex);
 
-    emplace (key);
+    emplace (s, key);
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& s = shard (key);
+    std::lock_guard <std::mutex> lock (s.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace(s, key);
     result.first.addPeer(peer);
     return result.second;
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer, int& flags)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& s = shard (key);
+    std::lock_guard <std::mutex> lock (s.mutex);
 
-    auto result = emplace(key);
-    auto& s = result.first;
-    s.addPeer (peer);
-    flags = s.getFlags ();
+    auto result = emplace(s, key);
+    auto& e = result.first;
+    e.addPeer (peer);
+    flags = e.getFlags ();
     return result.second;
 }
 
 int HashRouter::getFlags (uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& s = shard (key);
+    std::lock_guard <std::mutex> lock (s.mutex);
 
-    return emplace(key).first.getFlags ();
+    return emplace(s, key).first.getFlags ();
 }
 
 bool HashRouter::setFlags (uint256 const& key, int flags)
 {
     assert (flags != 0);
 
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& s = shard (key);
+    std::lock_guard <std::mutex> lock (s.mutex);
 
-    auto& s = emplace(key).first;
+    auto& e = emplace(s, key).first;
 
-    if ((s.getFlags () & flags) == flags)
+    if ((e.getFlags () & flags) == flags)
         return false;
 
-    s.setFlags (flags);
+    e.setFlags (flags);
     return true;
 }
 
@@ -97,24 +125,26 @@ auto
 HashRouter::shouldRelay (uint256 const& key)
     -> boost::optional<std::set<PeerShortID>>
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& s = shard (key);
+    std::lock_guard <std::mutex> lock (s.mutex);
 
-    auto& s = emplace(key).first;
+    auto& e = emplace(s, key).first;
 
-    if (!s.shouldRelay(suppressionMap_.clock().now(), holdTime_))
+    if (!e.shouldRelay(s.suppressionMap.clock().now(), holdTime_))
         return boost::none;
 
-    return s.releasePeerSet();
+    return e.releasePeerSet();
 }
 
 bool
 HashRouter::shouldRecover(uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock(mutex_);
+    auto& s = shard (key);
+    std::lock_guard <std::mutex> lock(s.mutex);
 
-    auto& s = emplace(key).first;
+    auto& e = emplace(s, key).first;
 
-    return s.shouldRecover(recoverLimit_);
+    return e.shouldRecover(recoverLimit_);
 }
 
 } // ripple
@@ -26,6 +26,9 @@
 #include <ripple/basics/UnorderedContainers.h>
 #include <ripple/beast/container/aged_unordered_map.h>
 #include <boost/optional.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -140,14 +143,21 @@ public:
         return 1;
     }
 
-    HashRouter (Stopwatch& clock, std::chrono::seconds entryHoldTimeInSeconds,
-        std::uint32_t recoverLimit)
-        : suppressionMap_(clock)
-        , holdTime_ (entryHoldTimeInSeconds)
-        , recoverLimit_ (recoverLimit + 1u)
+    static inline std::size_t getDefaultShardCount()
     {
+        return 32;
     }
 
+    /** Create a routing table.
+
+        @param shardCount The number of independently locked slices the
+            table is split into. Each shard ages and expires its own
+            entries when a new entry is added to it. With a single
+            shard, adding any entry expires every stale entry.
+    */
+    HashRouter (Stopwatch& clock, std::chrono::seconds entryHoldTimeInSeconds,
+        std::uint32_t recoverLimit, std::size_t shardCount = 1);
+
     HashRouter& operator= (HashRouter const&) = delete;
 
     virtual ~HashRouter() = default;
@@ -190,14 +200,39 @@ public:
     bool shouldRecover(uint256 const& key);
 
 private:
+    /** A slice of the routing table.
+
+        Peer threads look up every inbound message here, so the table
+        is split by hash, and only lookups that land in the same shard
+        contend with each other. Every call changes the entry it finds,
+        its peer set, flags or relay time, and moves it in the aged
+        map, so the shard is guarded by a plain mutex.
+    */
+    struct Shard
+    {
+        explicit Shard (Stopwatch& clock)
+            : suppressionMap (clock)
+        {
+        }
+
+        std::mutex mutex;
+
+        // Stores the suppressed hashes in this shard and their
+        // expiration time
+        beast::aged_unordered_map<uint256, Entry, Stopwatch::clock_type,
+            hardened_hash<strong_hash>> suppressionMap;
+    };
+
+    Shard& shard (uint256 const& key);
+
     // pair.second indicates whether the entry was created
-    std::pair<Entry&, bool> emplace (uint256 const&);
+    std::pair<Entry&, bool> emplace (Shard&, uint256 const&);
 
-    std::mutex mutable mutex_;
+    std::vector<std::unique_ptr<Shard>> shards_;
 
-    // Stores all suppressed hashes and their expiration time
-    beast::aged_unordered_map<uint256, Entry, Stopwatch::clock_type,
-        hardened_hash<strong_hash>> suppressionMap_;
+    // Picks the shard for a key. Hardened, so that peers
+    // can't aim hashes at a single shard.
+    hardened_hash<strong_hash> const shardHash_;
 
     std::chrono::seconds const holdTime_;
 
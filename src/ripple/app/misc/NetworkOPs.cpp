@@ -31,9 +31,11 @@
 #include <ripple/app/ledger/OpenLedger.h>
 #include <ripple/app/ledger/OrderBookDB.h>
 #include <ripple/app/ledger/TransactionMaster.h>
+#include <ripple/app/main/CollectorManager.h>
 #include <ripple/app/main/LoadManager.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
+#include <ripple/app/misc/SHAMapStore.h>
 #include <ripple/app/misc/Transaction.h>
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/misc/ValidatorKeys.h>
@@ -2213,7 +2215,30 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     //  info[jss::consensus] = mConsensus.getJson();
 
     if (admin)
+    {
         info[jss::load] = m_job_queue.getJson ();
+        info[jss::histograms] = getHistogramJson (
+            *app_.getCollectorManager().collector(), false);
+    }
+
+    if (admin)
+    {
+        if (auto const copy = app_.getSHAMapStore ().getCopyProgress ())
+        {
+            Json::Value od (Json::objectValue);
+            od[jss::state] = ! copy->copying ? "idle" :
+                (copy->rotating ? "rotating" : "copying");
+            od[jss::ledger_index] = copy->ledger;
+            od[jss::next_rotation] = copy->nextRotation;
+            od[jss::nodes] = std::to_string (copy->nodes);
+            od[jss::elapsed_s] = static_cast<Json::UInt> (
+                copy->elapsed.count ());
+            if (copy->eta)
+                od[jss::eta_s] = static_cast<Json::UInt> (
+                    copy->eta->count ());
+            info[jss::online_delete] = od;
+        }
+    }
 
     auto const escalationMetrics = app_.getTxQ().getMetrics(
         *app_.openLedger().current());
@@ -24,6 +24,8 @@
 #include <ripple/nodestore/Manager.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/core/Stoppable.h>
+#include <boost/optional.hpp>
+#include <chrono>
 
 namespace ripple {
 
@@ -48,6 +50,30 @@ public:
         std::uint32_t deleteBatch = 100;
         std::uint32_t backOff = 100;
         std::int32_t ageThreshold = 60;
+        // Nodes per second copied into the writable backend, 0 for no limit
+        std::uint32_t copyRate = 0;
+    };
+
+    /** Progress of copying the validated state into the writable backend.
+
+        Between rotations each validated ledger's state is copied, so
+        the copy made when rotating only covers what changed since the
+        previous ledger.
+    */
+    struct CopyProgress
+    {
+        // A copy is running
+        bool copying = false;
+        // The copy is the one that precedes a rotation
+        bool rotating = false;
+        // The ledger being copied, or the last one copied
+        LedgerIndex ledger = 0;
+        // Backends rotate once this ledger validates
+        LedgerIndex nextRotation = 0;
+        std::uint64_t nodes = 0;
+        std::chrono::seconds elapsed {0};
+        // Only known while copying a full state
+        boost::optional<std::chrono::seconds> eta;
     };
 
     SHAMapStore (Stoppable& parent) : Stoppable ("SHAMapStore", parent) {}
@@ -77,6 +103,9 @@ public:
 
     /** The number of files that are needed. */
     virtual int fdlimit() const = 0;
+
+    /** Progress of the state copy, if online delete is enabled. */
+    virtual boost::optional<CopyProgress> getCopyProgress() const = 0;
 };
 
 //------------------------------------------------------------------------------
@@ -273,14 +273,55 @@ SHAMapStoreImp::fdlimit () const
     return fdlimit_;
 }
 
+boost::optional<SHAMapStore::CopyProgress>
+SHAMapStoreImp::getCopyProgress() const
+{
+    if (! setup_.deleteInterval)
+        return boost::none;
+
+    std::lock_guard <std::mutex> lock (progressMutex_);
+    auto progress = progress_;
+    if (progress.copying)
+    {
+        using namespace std::chrono;
+        auto const elapsed = clock_type::now() - copyStart_;
+        progress.elapsed = duration_cast<seconds> (elapsed);
+        if (fullCopy_ && progress.nodes != 0 &&
+                fullCopyNodes_ > progress.nodes)
+            progress.eta = duration_cast<seconds> (elapsed *
+                double (fullCopyNodes_ - progress.nodes) / progress.nodes);
+    }
+    return progress;
+}
+
+void
+SHAMapStoreImp::throttle (std::uint64_t count,
+    clock_type::time_point start) const
+{
+    // Check every few fetches, so each sleep is short
+    if (! setup_.copyRate || (count % 64))
+        return;
+
+    auto const due = start + std::chrono::microseconds (
+        count * 1000000 / setup_.copyRate);
+    auto const now = clock_type::now();
+    if (due > now)
+        std::this_thread::sleep_for (due - now);
+}
+
 bool
 SHAMapStoreImp::copyNode (std::uint64_t& nodeCount,
         SHAMapAbstractNode const& node)
 {
     // Copy a single record from node to database_
     database_->fetchNode (node.getNodeHash().as_uint256());
-    if (! (++nodeCount % checkHealthInterval_))
+    throttle (++nodeCount, copyStart_);
+    if (! (nodeCount % checkHealthInterval_))
     {
+        {
+            std::lock_guard <std::mutex> lock (progressMutex_);
+            progress_.nodes = nodeCount;
+        }
         if (health())
             return true;
     }
@@ -288,6 +329,57 @@ SHAMapStoreImp::copyNode (std::uint64_t& nodeCount,
     return false;
 }
 
+bool
+SHAMapStoreImp::copyState (Ledger const& ledger,
+    LedgerIndex nextRotation, bool rotating)
+{
+    auto const state = ledger.stateMap().snapShot (false);
+    {
+        std::lock_guard <std::mutex> lock (progressMutex_);
+        progress_.copying = true;
+        progress_.rotating = rotating;
+        progress_.ledger = ledger.info().seq;
+        progress_.nextRotation = nextRotation;
+        progress_.nodes = 0;
+        copyStart_ = clock_type::now();
+        fullCopy_ = ! copiedState_;
+    }
+
+    std::uint64_t nodeCount = 0;
+    bool interrupted = false;
+    try
+    {
+        state->visitNewNodes (copiedState_.get(),
+            [&](SHAMapAbstractNode& node)
+            {
+                interrupted = copyNode (nodeCount, node);
+                return interrupted;
+            });
+    }
+    catch (SHAMapMissingNode const& e)
+    {
+        JLOG(journal_.warn()) << "copy of ledger " << ledger.info().seq
+                << " stopped: " << e;
+        healthy_ = false;
+        interrupted = true;
+    }
+
+    std::lock_guard <std::mutex> lock (progressMutex_);
+    progress_.copying = false;
+    progress_.nodes = nodeCount;
+    progress_.elapsed = std::chrono::duration_cast<std::chrono::seconds> (
+        clock_type::now() - copyStart_);
+    if (interrupted)
+        return true;
+
+    if (fullCopy_)
+        fullCopyNodes_ = nodeCount;
+    copiedState_ = state;
+    JLOG(journal_.debug()) << "copied ledger " << ledger.info().seq
+            << " nodecount " << nodeCount << (fullCopy_ ? " (full)" : "");
+    return false;
+}
+
 void
 SHAMapStoreImp::run()
 {
@@ -366,13 +458,8 @@ SHAMapStoreImp::run()
                     ;
             }
 
-            std::uint64_t nodeCount = 0;
-            validatedLedger->stateMap().snapShot (
-                    false)->visitNodes (
-                    std::bind (&SHAMapStoreImp::copyNode, this,
-                    std::ref(nodeCount), std::placeholders::_1));
-            JLOG(journal_.debug()) << "copied ledger " << validatedSeq
-                    << " nodecount " << nodeCount;
+            copyState (*validatedLedger,
+                lastRotated + setup_.deleteInterval, true);
             switch (health())
             {
                 case Health::stopping:
@@ -431,8 +518,22 @@ SHAMapStoreImp::run()
             }
             JLOG(journal_.debug()) << "finished rotation " << validatedSeq;
 
+            // The new writable backend starts out empty
+            copiedState_.reset();
+            {
+                std::lock_guard <std::mutex> lock (progressMutex_);
+                progress_.nextRotation = lastRotated + setup_.deleteInterval;
+            }
+
             oldBackend->setDeletePath();
         }
+        else if (health() == Health::ok)
+        {
+            // Keep the writable backend current so that rotating
+            // only has to copy what the latest ledgers changed
+            copyState (*validatedLedger,
+                lastRotated + setup_.deleteInterval, false);
+        }
     }
 }
 
@@ -824,6 +925,7 @@ setup_SHAMapStore (Config const& c)
     get_if_exists (setup.nodeDatabase, "delete_batch", setup.deleteBatch);
     get_if_exists (setup.nodeDatabase, "backOff", setup.backOff);
     get_if_exists (setup.nodeDatabase, "age_threshold", setup.ageThreshold);
+    get_if_exists (setup.nodeDatabase, "copy_rate", setup.copyRate);
 
     return setup;
 }
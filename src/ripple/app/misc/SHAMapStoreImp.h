@@ -24,6 +24,7 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/nodestore/DatabaseRotating.h>
+#include <chrono>
 #include <condition_variable>
 #include <thread>
 
@@ -109,6 +110,18 @@ private:
     DatabaseCon* ledgerDb_ = nullptr;
     int fdlimit_ = 0;
 
+    using clock_type = std::chrono::steady_clock;
+
+    // The last state copied in full into the current writable
+    // backend. Later copies skip every subtree it shares.
+    std::shared_ptr<SHAMap const> copiedState_;
+    mutable std::mutex progressMutex_;
+    CopyProgress progress_;
+    clock_type::time_point copyStart_;
+    bool fullCopy_ = false;
+    // Nodes in the last complete copy without copiedState_
+    std::uint64_t fullCopyNodes_ = 0;
+
 public:
     SHAMapStoreImp (Application& app,
             Setup const& setup,
@@ -171,9 +184,23 @@ public:
     void rendezvous() const override;
     int fdlimit() const override;
 
+    boost::optional<CopyProgress> getCopyProgress() const override;
+
 private:
-    // callback for visitNodes
+    // callback for visitNewNodes
     bool copyNode (std::uint64_t& nodeCount, SHAMapAbstractNode const &node);
+    /** Copy a ledger's state into the writable backend.
+
+        Subtrees shared with the last state copied since the backend
+        was rotated in are skipped.
+
+        @return true if the copy was interrupted.
+    */
+    bool copyState (Ledger const& ledger, LedgerIndex nextRotation,
+        bool rotating);
+    // Sleeps as needed to keep `count` fetches since `start`
+    // within the configured copy rate
+    void throttle (std::uint64_t count, clock_type::time_point start) const;
     void run();
     void dbPaths();
     std::shared_ptr <NodeStore::Backend> makeBackendRotating (
@@ -200,11 +227,13 @@ private:
     freshenCache (CacheInstance& cache)
     {
         std::uint64_t check = 0;
+        auto const start = clock_type::now();
 
         for (auto const& key: cache.getKeys())
         {
             database_->fetchNode (key);
-            if (! (++check % checkHealthInterval_) && health())
+            throttle (++check, start);
+            if (! (check % checkHealthInterval_) && health())
                 return true;
         }
 
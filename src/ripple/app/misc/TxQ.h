@@ -21,12 +21,14 @@
 #define RIPPLE_TXQ_H_INCLUDED
 
 #include <ripple/app/tx/applySteps.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/ledger/OpenView.h>
 #include <ripple/ledger/ApplyView.h>
 #include <ripple/protocol/TER.h>
 #include <ripple/protocol/STTx.h>
 #include <boost/intrusive/set.hpp>
 #include <boost/circular_buffer.hpp>
+#include <memory>
 
 namespace ripple {
 
@@ -393,7 +395,55 @@ private:
         < MaybeTx, FeeHook,
         boost::intrusive::compare <GreaterFee> >;
 
-    using AccountMap = std::map <AccountID, TxQAccount>;
+    /* Every queued transaction looks up its account at least
+        once per `apply` and `accept` step, so use a hash map.
+        Nothing depends on the iteration order of the accounts.
+        The keys are chosen by the submitters, so use a hardened hash.
+    */
+    using AccountMap = hardened_hash_map <AccountID, TxQAccount>;
+
+    /* Copy of the queue state needed by `getMetrics`, refreshed
+        every time the queue changes. Readers, like the RPC "fee"
+        command, can use it without waiting for `mutex_`, which may
+        be held for a long time by `accept` when the queue is large.
+        Each copy is immutable and replaced as a whole, so readers
+        always see values from the same change.
+    */
+    struct PublishedMetrics
+    {
+        std::size_t txCount;
+        boost::optional<std::size_t> maxSize;
+        std::uint64_t minFeeLevel;
+        FeeMetrics::Snapshot snapshot;
+    };
+
+    // Holds mutex_ locked for the duration of a change to the
+    // queue. Call `publish` when the change is done, to refresh
+    // `published_` before unlocking. Publishing allocates, so it is
+    // not done on destruction. If the change throws, the published
+    // metrics stay as they were until the next change.
+    class ScopedUpdate
+    {
+    private:
+        TxQ& txq_;
+        std::lock_guard<std::mutex> lock_;
+
+    public:
+        explicit ScopedUpdate(TxQ& txq)
+            : txq_(txq)
+            , lock_(txq.mutex_)
+        {
+        }
+
+        ScopedUpdate(ScopedUpdate const&) = delete;
+        ScopedUpdate& operator=(ScopedUpdate const&) = delete;
+
+        void
+        publish()
+        {
+            txq_.publishMetrics();
+        }
+    };
 
     Setup const setup_;
     beast::Journal j_;
@@ -405,11 +455,20 @@ private:
     AccountMap byAccount_;
     boost::optional<size_t> maxSize_;
 
+    // Written only under locked mutex_, with std::atomic_store, so
+    // readers use std::atomic_load.
+    std::shared_ptr<PublishedMetrics const> published_;
+
     // Most queue operations are done under the master lock,
-    // but use this mutex for the RPC "fee" command, which isn't.
+    // but use this mutex for the RPC commands that inspect the
+    // queue contents, which aren't.
     std::mutex mutable mutex_;
 
 private:
+    // Must be called with mutex_ locked.
+    void
+    publishMetrics();
+
     template<size_t fillPercentage = 100>
     bool
     isFull() const;
@@ -429,6 +488,14 @@ private:
     erase(TxQAccount& txQAccount, TxQAccount::TxMap::const_iterator begin,
         TxQAccount::TxMap::const_iterator end);
 
+    // The part of `apply` that changes the queue. Must be called
+    // with mutex_ locked, through a ScopedUpdate.
+    std::pair<TER, bool>
+    applyLocked(Application& app, OpenView& view,
+        std::shared_ptr<STTx const> const& tx,
+            PreflightResult const& pfresult, ApplyFlags flags,
+                beast::Journal j);
+
     /*
         All-or-nothing attempt to try to apply all the queued txs for `accountIter`
         up to and including `tx`.
@@ -324,6 +324,8 @@ TxQ::TxQ(Setup const& setup,
     , feeMetrics_(setup, j)
     , maxSize_(boost::none)
 {
+    std::lock_guard<std::mutex> lock(mutex_);
+    publishMetrics();
 }
 
 TxQ::~TxQ()
@@ -331,6 +333,32 @@ TxQ::~TxQ()
     byFee_.clear();
 }
 
+void
+TxQ::publishMetrics()
+{
+    PublishedMetrics const metrics{
+        byFee_.size(),
+        maxSize_,
+        isFull() && !byFee_.empty() ?
+            byFee_.rbegin()->feeLevel + 1 : baseLevel,
+        feeMetrics_.getSnapshot()
+    };
+
+    // Most changes to the queue leave the metrics as they were
+    auto const& old = published_;
+    if (old &&
+        old->txCount == metrics.txCount &&
+        old->maxSize == metrics.maxSize &&
+        old->minFeeLevel == metrics.minFeeLevel &&
+        old->snapshot.txnsExpected == metrics.snapshot.txnsExpected &&
+        old->snapshot.escalationMultiplier ==
+            metrics.snapshot.escalationMultiplier)
+        return;
+
+    std::atomic_store(&published_,
+        std::make_shared<PublishedMetrics const>(metrics));
+}
+
 template<size_t fillPercentage>
 bool
 TxQ::isFull() const
@@ -618,10 +646,6 @@ TxQ::apply(Application& app, OpenView& view,
         return ripple::apply(app, view, *tx, flags, j);
     }
 
-    auto const account = (*tx)[sfAccount];
-    auto const transactionID = tx->getTransactionID();
-    auto const tSeq = tx->getSequence();
-
     boost::optional<STAmountSO> saved;
     if (view.rules().enabled(fix1513))
         saved.emplace(view.info().parentCloseTime);
@@ -634,6 +658,22 @@ TxQ::apply(Application& app, OpenView& view,
     if (pfresult.ter != tesSUCCESS)
         return{ pfresult.ter, false };
 
+    ScopedUpdate update(*this);
+    auto const result = applyLocked(app, view, tx, pfresult, flags, j);
+    update.publish();
+    return result;
+}
+
+std::pair<TER, bool>
+TxQ::applyLocked(Application& app, OpenView& view,
+    std::shared_ptr<STTx const> const& tx,
+        PreflightResult const& pfresult, ApplyFlags flags,
+            beast::Journal j)
+{
+    auto const account = (*tx)[sfAccount];
+    auto const transactionID = tx->getTransactionID();
+    auto const tSeq = tx->getSequence();
+
     struct MultiTxn
     {
         boost::optional<ApplyViewImpl> applyView;
@@ -650,8 +690,6 @@ TxQ::apply(Application& app, OpenView& view,
     boost::optional<TxConsequences const> consequences;
     boost::optional<FeeMultiSet::iterator> replacedItemDeleteIter;
 
-    std::lock_guard<std::mutex> lock(mutex_);
-
     auto const metricsSnapshot = feeMetrics_.getSnapshot();
 
     // We may need the base fee for multiple transactions
@@ -1153,7 +1191,7 @@ TxQ::processClosedLedger(Application& app,
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    ScopedUpdate update(*this);
 
     feeMetrics_.update(app, view, timeLeap, setup_);
     auto const& snapshot = feeMetrics_.getSnapshot();
@@ -1189,6 +1227,8 @@ TxQ::processClosedLedger(Application& app,
         else
             ++txQAccountIter;
     }
+
+    update.publish();
 }
 
 /*
@@ -1242,7 +1282,7 @@ TxQ::accept(Application& app,
 
     auto ledgerChanged = false;
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    ScopedUpdate update(*this);
 
     auto const metricSnapshot = feeMetrics_.getSnapshot();
 
@@ -1344,6 +1384,7 @@ TxQ::accept(Application& app,
         }
     }
 
+    update.publish();
     return ledgerChanged;
 }
 
@@ -1358,17 +1399,17 @@ TxQ::getMetrics(OpenView const& view, std::uint32_t txCountPadding) const
 
     Metrics result;
 
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto const snapshot = feeMetrics_.getSnapshot();
+    // Doesn't lock mutex_. Everything needed is published
+    // by the last change to the queue.
+    auto const published = std::atomic_load(&published_);
+    auto const& snapshot = published->snapshot;
 
-    result.txCount = byFee_.size();
-    result.txQMaxSize = maxSize_;
+    result.txCount = published->txCount;
+    result.txQMaxSize = published->maxSize;
     result.txInLedger = view.txCount();
     result.txPerLedger = snapshot.txnsExpected;
     result.referenceFeeLevel = baseLevel;
-    result.minFeeLevel = isFull() ? byFee_.rbegin()->feeLevel + 1 :
-        baseLevel;
+    result.minFeeLevel = published->minFeeLevel;
     result.medFeeLevel = snapshot.escalationMultiplier;
     result.expFeeLevel = FeeMetrics::scaleFeeLevel(snapshot, view,
         txCountPadding);
@@ -705,12 +705,12 @@ int Pathfinder::getPathsOut (
     if (!it.second)
         return it.first->second;
 
-    auto sleAccount = mLedger->read(keylet::account (account));
+    auto sleAccount = mLedger->readLazy(keylet::account (account));
 
     if (!sleAccount)
         return 0;
 
-    int aFlags = sleAccount->getFieldU32 (sfFlags);
+    int aFlags = sleAccount->getFlags ();
     bool const bAuthRequired = (aFlags & lsfRequireAuth) != 0;
     bool const bFrozen = ((aFlags & lsfGlobalFreeze) != 0);
 
@@ -845,13 +845,13 @@ bool Pathfinder::isNoRipple (
     AccountID const& toAccount,
     Currency const& currency)
 {
-    auto sleRipple = mLedger->read(keylet::line(
+    auto sleRipple = mLedger->readLazy(keylet::line(
         toAccount, fromAccount, currency));
 
     auto const flag ((toAccount > fromAccount)
                      ? lsfHighNoRipple : lsfLowNoRipple);
 
-    return sleRipple && (sleRipple->getFieldU32 (sfFlags) & flag);
+    return sleRipple && (sleRipple->getFlags () & flag);
 }
 
 // Does this path end on an account-to-account link whose last account has
@@ -924,12 +924,12 @@ void Pathfinder::addLink (
         else
         {
             // search for accounts to add
-            auto const sleEnd = mLedger->read(keylet::account(uEndAccount));
+            auto const sleEnd = mLedger->readLazy(keylet::account(uEndAccount));
 
             if (sleEnd)
             {
                 bool const bRequireAuth (
-                    sleEnd->getFieldU32 (sfFlags) & lsfRequireAuth);
+                    sleEnd->getFlags () & lsfRequireAuth);
                 bool const bIsEndCurrency (
                     uEndCurrency == mDstAmount.getCurrency ());
                 bool const bIsNoRippleOut (
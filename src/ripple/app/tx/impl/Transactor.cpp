@@ -19,12 +19,14 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/main/CollectorManager.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/app/tx/impl/Transactor.h>
 #include <ripple/app/tx/impl/SignerEntries.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/Log.h>
+#include <ripple/beast/insight/Histogram.h>
 #include <ripple/core/Config.h>
 #include <ripple/json/to_string.h>
 #include <ripple/ledger/View.h>
@@ -187,7 +189,7 @@ Transactor::checkFee (PreclaimContext const& ctx, std::uint64_t baseFee)
         return tesSUCCESS;
 
     auto const id = ctx.tx.getAccountID(sfAccount);
-    auto const sle = ctx.view.read(
+    auto const sle = ctx.view.readLazy(
         keylet::account(id));
     auto const balance = (*sle)[sfBalance].xrp();
 
@@ -232,7 +234,7 @@ Transactor::checkSeq (PreclaimContext const& ctx)
 {
     auto const id = ctx.tx.getAccountID(sfAccount);
 
-    auto const sle = ctx.view.read(
+    auto const sle = ctx.view.readLazy(
         keylet::account(id));
 
     if (!sle)
@@ -244,7 +246,7 @@ Transactor::checkSeq (PreclaimContext const& ctx)
     }
 
     std::uint32_t const t_seq = ctx.tx.getSequence ();
-    std::uint32_t const a_seq = sle->getFieldU32 (sfSequence);
+    std::uint32_t const a_seq = (*sle)[sfSequence];
 
     if (t_seq != a_seq)
     {
@@ -265,7 +267,8 @@ Transactor::checkSeq (PreclaimContext const& ctx)
     }
 
     if (ctx.tx.isFieldPresent (sfAccountTxnID) &&
-            (sle->getFieldH256 (sfAccountTxnID) != ctx.tx.getFieldH256 (sfAccountTxnID)))
+            ((*sle)[~sfAccountTxnID].value_or (beast::zero) !=
+                ctx.tx.getFieldH256 (sfAccountTxnID)))
         return tefWRONG_PRIOR;
 
     if (ctx.tx.isFieldPresent (sfLastLedgerSequence) &&
@@ -347,7 +350,7 @@ Transactor::checkSingleSign (PreclaimContext const& ctx)
 {
     auto const id = ctx.tx.getAccountID(sfAccount);
 
-    auto const sle = ctx.view.read(
+    auto const sle = ctx.view.readLazy(
         keylet::account(id));
     auto const hasAuthKey     = sle->isFieldPresent (sfRegularKey);
 
@@ -371,7 +374,7 @@ Transactor::checkSingleSign (PreclaimContext const& ctx)
             return tefMASTER_DISABLED;
     }
     else if (hasAuthKey &&
-        (pkAccount == sle->getAccountID (sfRegularKey)))
+        (pkAccount == (*sle)[sfRegularKey]))
     {
         // Authorized to continue.
     }
@@ -602,6 +605,12 @@ Transactor::operator()()
     JLOG(j_.trace()) <<
         "applyTransaction>";
 
+    // Time taken by every transactor, in microseconds. The collector
+    // hands back the histogram already registered under this name.
+    auto const applyTime = ctx_.app.getCollectorManager ().collector ()->
+        make_histogram ("tx_apply");
+    auto const start = std::chrono::steady_clock::now();
+
     auto const txID = ctx_.tx.getTransactionID ();
 
     JLOG(j_.debug()) << "Transactor for id: " << txID;
@@ -737,6 +746,7 @@ Transactor::operator()()
         "apply: " << transToken(terResult) <<
         ", " << (didApply ? "true" : "false");
 
+    applyTime.notify (std::chrono::steady_clock::now() - start);
     return { terResult, didApply };
 }
 
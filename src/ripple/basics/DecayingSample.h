@@ -20,8 +20,11 @@
 #ifndef RIPPLE_BASICS_DECAYINGSAMPLE_H_INCLUDED
 #define RIPPLE_BASICS_DECAYINGSAMPLE_H_INCLUDED
 
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 
 namespace ripple {
 
@@ -103,6 +106,125 @@ private:
 
 //------------------------------------------------------------------------------
 
+/** A DecayingSample which may be updated concurrently without a lock.
+
+    The value and the second in which it was last aged are packed into
+    a single atomic word and updated together. Reading the value does
+    not write. The value saturates instead of wrapping.
+
+    @tparam The number of seconds in the decay window.
+*/
+template <int Window, typename Clock>
+class AtomicDecayingSample
+{
+public:
+    using value_type = typename Clock::duration::rep;
+    using time_point = typename Clock::time_point;
+
+    AtomicDecayingSample () = delete;
+    AtomicDecayingSample (AtomicDecayingSample const&) = delete;
+    AtomicDecayingSample& operator= (AtomicDecayingSample const&) = delete;
+
+    /**
+        @param now Start time of AtomicDecayingSample.
+    */
+    explicit AtomicDecayingSample (time_point now)
+        : m_state (pack (0, seconds (now)))
+    {
+    }
+
+    /** Add a new sample.
+        The value is first aged according to the specified time.
+    */
+    value_type add (value_type value, time_point now)
+    {
+        auto const when = seconds (now);
+        auto state = m_state.load ();
+        std::uint32_t next;
+        do
+        {
+            auto const sum = value_type (decay (state, when)) + value;
+            if (sum <= 0)
+                next = 0;
+            else if (sum >= std::numeric_limits<std::uint32_t>::max ())
+                next = std::numeric_limits<std::uint32_t>::max ();
+            else
+                next = static_cast<std::uint32_t> (sum);
+        }
+        while (! m_state.compare_exchange_weak (state,
+            pack (next, later (when, timeOf (state)))));
+        return next / Window;
+    }
+
+    /** Retrieve the current value in normalized units.
+        The samples are aged according to the specified time.
+    */
+    value_type value (time_point now) const
+    {
+        return decay (m_state.load (), seconds (now)) / Window;
+    }
+
+private:
+    static std::uint32_t seconds (time_point now)
+    {
+        // Only differences matter, so wrapping is harmless
+        return static_cast<std::uint32_t> (
+            std::chrono::duration_cast<std::chrono::seconds> (
+                now.time_since_epoch ()).count ());
+    }
+
+    static std::uint64_t pack (std::uint32_t value, std::uint32_t when)
+    {
+        return (std::uint64_t (when) << 32) | value;
+    }
+
+    static std::uint32_t timeOf (std::uint64_t state)
+    {
+        return static_cast<std::uint32_t> (state >> 32);
+    }
+
+    static std::uint32_t valueOf (std::uint64_t state)
+    {
+        return static_cast<std::uint32_t> (state);
+    }
+
+    static std::int32_t since (std::uint32_t now, std::uint32_t then)
+    {
+        return static_cast<std::int32_t> (now - then);
+    }
+
+    // A concurrent update may have aged the value further than us
+    static std::uint32_t later (std::uint32_t a, std::uint32_t b)
+    {
+        return since (a, b) > 0 ? a : b;
+    }
+
+    // Returns the value aged to the specified time
+    static std::uint32_t decay (std::uint64_t state, std::uint32_t now)
+    {
+        auto value = valueOf (state);
+        auto elapsed = since (now, timeOf (state));
+        if (elapsed <= 0 || value == 0)
+            return value;
+
+        // A span larger than four times the window decays the
+        // value to an insignificant amount so just reset it.
+        //
+        if (elapsed > 4 * Window)
+            return 0;
+
+        while (elapsed--)
+            value -= static_cast<std::uint32_t> (
+                (std::uint64_t (value) + Window - 1) / Window);
+        return value;
+    }
+
+    // Last aging time in seconds and value in exponential units
+    std::atomic<std::uint64_t> m_state;
+};
+
+//------------------------------------------------------------------------------
+
 /** Sampling function using exponential decay to provide a continuous value.
     @tparam HalfLife The half life of a sample, in seconds.
 */
@@ -24,10 +24,17 @@
 #include <beast/core/string.hpp>
 #include <ripple/beast/utility/Journal.h>
 #include <boost/filesystem.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -45,7 +52,17 @@ enum LogSeverity
     lsFATAL     = 5     // A severe condition that indicates a server problem
 };
 
-/** Manages partitions for logging. */
+/** Manages partitions for logging.
+
+    Messages are formatted on the calling thread and queued in one of
+    several buffers, chosen per thread so that threads rarely share
+    one. A background thread drains the buffers in order and writes
+    each batch to the log file and the console with a single call.
+    When more than a fixed amount of output is waiting, further
+    messages are dropped and counted instead of blocking the caller;
+    fatal messages are never dropped and are written before `write`
+    returns.
+*/
 class Logs
 {
 private:
@@ -140,18 +157,49 @@ private:
         }
         /** @} */
 
+        /** Write a block of text and flush it to the system file. */
+        void write (char const* data, std::size_t size);
+
     private:
         std::unique_ptr <std::ofstream> m_stream;
         boost::filesystem::path m_path;
     };
 
+    struct Record
+    {
+        std::uint64_t seq;
+        std::string text;
+    };
+
+    struct alignas(64) Buffer
+    {
+        std::mutex mutex;
+        std::vector<Record> records;
+    };
+
     std::mutex mutable mutex_;
     std::map <std::string,
         std::unique_ptr<beast::Journal::Sink>,
             beast::iless> sinks_;
     beast::severities::Severity thresh_;
+    std::atomic<bool> silent_ {false};
+
+    // Held while a batch is written and while the file is reopened
+    std::mutex fileMutex_;
     File file_;
-    bool silent_ = false;
+    std::uint64_t droppedReported_ = 0;
+
+    std::array<Buffer, 16> buffers_;
+    std::atomic<std::uint64_t> seq_ {0};
+    std::atomic<std::size_t> pending_ {0};
+    std::atomic<std::uint64_t> dropped_ {0};
+
+    // The writer thread starts with the first message
+    std::once_flag started_;
+    std::mutex writerMutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    std::thread writer_;
 
 public:
     Logs(beast::severities::Severity level);
@@ -159,7 +207,8 @@ public:
     Logs (Logs const&) = delete;
     Logs& operator= (Logs const&) = delete;
 
-    virtual ~Logs() = default;
+    /** Writes any buffered messages. */
+    virtual ~Logs();
 
     bool
     open (boost::filesystem::path const& pathToLogFile);
@@ -182,13 +231,26 @@ public:
     std::vector<std::pair<std::string, std::string>>
     partition_severities() const;
 
+    /** Format a message and queue it for the writer thread. */
     void
     write (beast::severities::Severity level, std::string const& partition,
         std::string const& text, bool console);
 
+    /** Write all queued messages before returning. */
+    void
+    flush();
+
+    /** Write the queued messages, then close and reopen the log file. */
     std::string
     rotate();
 
+    /** The number of messages dropped because too many were queued. */
+    std::uint64_t
+    dropped() const
+    {
+        return dropped_.load();
+    }
+
     /**
      * Set flag to write logs to stderr (false) or not (true).
      *
@@ -227,9 +289,25 @@ private:
     {
         // Maximum line length for log messages.
         // If the message exceeds this length it will be truncated with elipses.
-        maximumMessageCharacters = 12 * 1024
+        maximumMessageCharacters = 12 * 1024,
+
+        // Queued output beyond which messages are dropped
+        maximumPendingBytes = 32 * 1024 * 1024,
+
+        // Queued output that wakes the writer before its next interval
+        wakePendingBytes = 256 * 1024
     };
 
+    // How often the writer thread drains the buffers
+    static std::chrono::milliseconds const flushInterval;
+
+    void
+    writer();
+
+    // Called with fileMutex_ held
+    void
+    drain();
+
     static
     std::string
     scrub (std::string s);
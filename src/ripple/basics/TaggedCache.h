@@ -490,6 +490,31 @@ public:
         return v;
     }
 
+    /** Return the objects that are still alive.
+
+        Unlike fetch, this leaves the entries as they are: it does not
+        refresh their expiration time, make weak entries strong again,
+        or count as a hit.
+    */
+    std::vector <mapped_ptr> getValues ()
+    {
+        std::vector <mapped_ptr> v;
+
+        {
+            lock_guard lock (m_mutex);
+            v.reserve (m_cache.size());
+            for (auto& _ : m_cache)
+            {
+                auto ptr = _.second.isCached () ?
+                    _.second.ptr : _.second.lock ();
+                if (ptr)
+                    v.push_back (std::move (ptr));
+            }
+        }
+
+        return v;
+    }
+
 private:
     void collect_metrics ()
     {
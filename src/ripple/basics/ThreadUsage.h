@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_THREADUSAGE_H_INCLUDED
+#define RIPPLE_BASICS_THREADUSAGE_H_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+
+namespace ripple {
+
+/** Resources used by the calling thread since it started.
+
+    The values only ever grow, so the work done between two points on
+    the same thread is the difference of two samples. Work that hops
+    between threads, such as a coroutine, must add up the difference
+    for each stretch it spends on a thread.
+
+    Allocated bytes are only counted when RIPPLE_COUNT_ALLOCATIONS is
+    set, which replaces the global operator new. Otherwise they read as
+    zero.
+*/
+struct ThreadUsage
+{
+    /** CPU time spent by the thread. */
+    std::chrono::nanoseconds cpu {0};
+
+    /** Synchronous node store fetches made by the thread. */
+    std::uint64_t fetches = 0;
+
+    /** Bytes requested from operator new by the thread. */
+    std::uint64_t allocated = 0;
+
+    /** Return the usage of the calling thread so far. */
+    static
+    ThreadUsage
+    now();
+
+    /** Count a node store fetch against the calling thread. */
+    static
+    void
+    addFetch();
+
+    ThreadUsage&
+    operator+= (ThreadUsage const& other)
+    {
+        cpu += other.cpu;
+        fetches += other.fetches;
+        allocated += other.allocated;
+        return *this;
+    }
+
+    ThreadUsage&
+    operator-= (ThreadUsage const& other)
+    {
+        cpu -= other.cpu;
+        fetches -= other.fetches;
+        allocated -= other.allocated;
+        return *this;
+    }
+};
+
+inline
+ThreadUsage
+operator+ (ThreadUsage lhs, ThreadUsage const& rhs)
+{
+    return lhs += rhs;
+}
+
+inline
+ThreadUsage
+operator- (ThreadUsage lhs, ThreadUsage const& rhs)
+{
+    return lhs -= rhs;
+}
+
+} // ripple
+
+#endif
@@ -31,6 +31,7 @@
 #include <ripple/basics/hardened_hash.h>
 #include <ripple/beast/utility/Zero.h>
 #include <boost/functional/hash.hpp>
+#include <cstring>
 #include <functional>
 #include <type_traits>
 
@@ -432,17 +433,34 @@ template <std::size_t Bits, class Tag>
 inline int compare (
     base_uint<Bits, Tag> const& a, base_uint<Bits, Tag> const& b)
 {
-    auto ret = std::mismatch (a.cbegin (), a.cend (), b.cbegin ());
-
-    if (ret.first == a.cend ())
-        return 0;
+    // The bytes are stored most significant first, so the first
+    // word that differs, read as big-endian, decides. Compare 64
+    // bits at a time, then the 32-bit word left over in a uint160.
+    auto const pa = a.data ();
+    auto const pb = b.data ();
+    std::size_t i = 0;
+    for (; i + sizeof (std::uint64_t) <= a.size ();
+            i += sizeof (std::uint64_t))
+    {
+        std::uint64_t x;
+        std::uint64_t y;
+        std::memcpy (&x, pa + i, sizeof (x));
+        std::memcpy (&y, pb + i, sizeof (y));
+        if (x != y)
+            return be64toh (x) > be64toh (y) ? 1 : -1;
+    }
 
-    // a > b
-    if (*ret.first > *ret.second)
-        return 1;
+    if (i < a.size ())
+    {
+        std::uint32_t x;
+        std::uint32_t y;
+        std::memcpy (&x, pa + i, sizeof (x));
+        std::memcpy (&y, pb + i, sizeof (y));
+        if (x != y)
+            return be32toh (x) > be32toh (y) ? 1 : -1;
+    }
 
-    // a < b
-    return -1;
+    return 0;
 }
 
 template <std::size_t Bits, class Tag>
@@ -21,11 +21,14 @@
 #include <ripple/basics/chrono.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/contract.h>
+#include <ripple/beast/core/CurrentThreadName.h>
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <mutex>
 
@@ -113,16 +116,40 @@ void Logs::File::writeln (char const* text)
     }
 }
 
+void Logs::File::write (char const* data, std::size_t size)
+{
+    if (m_stream != nullptr)
+    {
+        m_stream->write (data, size);
+        m_stream->flush ();
+    }
+}
+
 //------------------------------------------------------------------------------
 
+std::chrono::milliseconds const Logs::flushInterval {100};
+
 Logs::Logs(beast::severities::Severity thresh)
     : thresh_ (thresh) // default severity
 {
 }
 
+Logs::~Logs()
+{
+    {
+        std::lock_guard <std::mutex> lock (writerMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (writer_.joinable())
+        writer_.join();
+    flush();
+}
+
 bool
 Logs::open (boost::filesystem::path const& pathToLogFile)
 {
+    std::lock_guard <std::mutex> lock (fileMutex_);
     return file_.open(pathToLogFile);
 }
 
@@ -180,19 +207,123 @@ Logs::write (beast::severities::Severity level, std::string const& partition,
 {
     std::string s;
     format (s, text, level, partition);
-    std::lock_guard <std::mutex> lock (mutex_);
-    file_.writeln (s);
-    if (! silent_)
-        std::cerr << s << '\n';
+
+    // Fatal messages are written even when the buffers are full
+    auto const size = s.size();
+    bool const fatal = level >= beast::severities::kFatal;
+    auto const pending = pending_.fetch_add (size) + size;
+    if (! fatal && pending > maximumPendingBytes)
+    {
+        pending_ -= size;
+        ++dropped_;
+        return;
+    }
+
+    std::call_once (started_, [this]
+        {
+            writer_ = std::thread (&Logs::writer, this);
+        });
+
+    // Each thread keeps to one buffer
+    static std::atomic<std::size_t> nextBuffer {0};
+    static thread_local std::size_t const index = nextBuffer++;
+    auto& buffer = buffers_[index % buffers_.size()];
+    {
+        std::lock_guard <std::mutex> lock (buffer.mutex);
+        buffer.records.push_back ({seq_++, std::move (s)});
+    }
+
+    if (fatal)
+        flush();
+    else if (pending >= wakePendingBytes && pending - size < wakePendingBytes)
+        wake_.notify_one();
     // VFALCO TODO Fix console output
     //if (console)
     //    out_.write_console(s);
 }
 
+void
+Logs::flush()
+{
+    std::lock_guard <std::mutex> lock (fileMutex_);
+    drain();
+}
+
+void
+Logs::writer()
+{
+    beast::setCurrentThreadName ("Logs");
+    std::unique_lock <std::mutex> lock (writerMutex_);
+    while (! stop_)
+    {
+        wake_.wait_for (lock, flushInterval);
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void
+Logs::drain()
+{
+    std::vector<Record> records;
+    for (auto& buffer : buffers_)
+    {
+        std::lock_guard <std::mutex> lock (buffer.mutex);
+        if (records.empty())
+        {
+            records.swap (buffer.records);
+            continue;
+        }
+        std::move (buffer.records.begin(), buffer.records.end(),
+            std::back_inserter (records));
+        buffer.records.clear();
+    }
+
+    // Messages from different buffers are put back in the order
+    // they were written
+    std::sort (records.begin(), records.end(),
+        [](Record const& lhs, Record const& rhs)
+        {
+            return lhs.seq < rhs.seq;
+        });
+
+    std::size_t bytes = 0;
+    for (auto const& r : records)
+        bytes += r.text.size();
+
+    std::string out;
+    out.reserve (bytes + records.size());
+    for (auto const& r : records)
+    {
+        out += r.text;
+        out += '\n';
+    }
+    pending_ -= bytes;
+
+    auto const dropped = dropped_.load();
+    if (dropped != droppedReported_)
+    {
+        std::string s;
+        format (s, std::to_string (dropped - droppedReported_) +
+            " log messages dropped", beast::severities::kWarning, "Logs");
+        out += s;
+        out += '\n';
+        droppedReported_ = dropped;
+    }
+
+    if (out.empty())
+        return;
+    file_.write (out.data(), out.size());
+    if (! silent_)
+        std::cerr.write (out.data(), out.size());
+}
+
 std::string
 Logs::rotate()
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    std::lock_guard <std::mutex> lock (fileMutex_);
+    drain();
     bool const wasOpened = file_.closeAndReopen ();
     if (wasOpened)
         return "The log file was closed and reopened.";
@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/basics/ThreadUsage.h>
+#include <cstdlib>
+#include <new>
+
+#if BEAST_WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace ripple {
+
+namespace detail {
+
+// Plain integers so that operator new can use them on any thread,
+// including while the thread is being set up or torn down.
+static thread_local std::uint64_t threadFetches = 0;
+static thread_local std::uint64_t threadAllocated = 0;
+
+static
+std::chrono::nanoseconds
+threadCpuTime()
+{
+#if BEAST_WIN32
+    FILETIME creation, exit, kernel, user;
+    if (! GetThreadTimes (GetCurrentThread(),
+            &creation, &exit, &kernel, &user))
+        return {};
+    auto const ticks = [](FILETIME const& ft)
+    {
+        return (std::uint64_t(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+    };
+    // FILETIME counts in units of 100 nanoseconds
+    return std::chrono::nanoseconds (100 * (ticks (kernel) + ticks (user)));
+#else
+    timespec ts;
+    if (clock_gettime (CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return {};
+    return std::chrono::seconds (ts.tv_sec) +
+        std::chrono::nanoseconds (ts.tv_nsec);
+#endif
+}
+
+} // detail
+
+ThreadUsage
+ThreadUsage::now()
+{
+    ThreadUsage usage;
+    usage.cpu = detail::threadCpuTime();
+    usage.fetches = detail::threadFetches;
+    usage.allocated = detail::threadAllocated;
+    return usage;
+}
+
+void
+ThreadUsage::addFetch()
+{
+    ++detail::threadFetches;
+}
+
+} // ripple
+
+//------------------------------------------------------------------------------
+
+#if RIPPLE_COUNT_ALLOCATIONS
+
+namespace ripple {
+namespace detail {
+
+static
+void*
+countedAlloc (std::size_t size, bool nothrow)
+{
+    if (size == 0)
+        size = 1;
+    for (;;)
+    {
+        if (auto const p = std::malloc (size))
+        {
+            threadAllocated += size;
+            return p;
+        }
+        auto const handler = std::get_new_handler();
+        if (! handler)
+        {
+            if (nothrow)
+                return nullptr;
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+} // detail
+} // ripple
+
+void*
+operator new (std::size_t size)
+{
+    return ripple::detail::countedAlloc (size, false);
+}
+
+void*
+operator new[] (std::size_t size)
+{
+    return ripple::detail::countedAlloc (size, false);
+}
+
+void*
+operator new (std::size_t size, std::nothrow_t const&) noexcept
+{
+    try
+    {
+        return ripple::detail::countedAlloc (size, true);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void*
+operator new[] (std::size_t size, std::nothrow_t const&) noexcept
+{
+    try
+    {
+        return ripple::detail::countedAlloc (size, true);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void
+operator delete (void* p) noexcept
+{
+    std::free (p);
+}
+
+void
+operator delete[] (void* p) noexcept
+{
+    std::free (p);
+}
+
+void
+operator delete (void* p, std::size_t) noexcept
+{
+    std::free (p);
+}
+
+void
+operator delete[] (void* p, std::size_t) noexcept
+{
+    std::free (p);
+}
+
+void
+operator delete (void* p, std::nothrow_t const&) noexcept
+{
+    std::free (p);
+}
+
+void
+operator delete[] (void* p, std::nothrow_t const&) noexcept
+{
+    std::free (p);
+}
+
+#endif
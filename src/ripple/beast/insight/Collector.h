@@ -23,10 +23,12 @@
 #include <ripple/beast/insight/Counter.h>
 #include <ripple/beast/insight/Event.h>
 #include <ripple/beast/insight/Gauge.h>
+#include <ripple/beast/insight/Histogram.h>
 #include <ripple/beast/insight/Hook.h>
 #include <ripple/beast/insight/Meter.h>
 
 #include <string>
+#include <vector>
 
 namespace beast {
 namespace insight {
@@ -35,10 +37,10 @@ namespace insight {
 
     To export metrics from a class, pass and save a shared_ptr to this
     interface in the class constructor. Create the metric objects
-    as desired (counters, events, gauges, meters, and an optional hook)
-    using the interface.
+    as desired (counters, events, gauges, histograms, meters, and an
+    optional hook) using the interface.
 
-    @see Counter, Event, Gauge, Hook, Meter
+    @see Counter, Event, Gauge, Histogram, Hook, Meter
     @see NullCollector, StatsDCollector
 */
 class Collector
@@ -125,6 +127,30 @@ public:
         return make_meter (prefix + "." + name);
     }
     /** @} */
+
+    /** Create a histogram with the specified name.
+        Creating a histogram again with the same name, while the first
+        one is still in use, returns the same histogram.
+        @see Histogram
+    */
+    /** @{ */
+    virtual Histogram make_histogram (std::string const& name) = 0;
+
+    Histogram make_histogram (std::string const& prefix,
+        std::string const& name)
+    {
+        if (prefix.empty ())
+            return make_histogram (name);
+        return make_histogram (prefix + "." + name);
+    }
+    /** @} */
+
+    /** Return the contents of every histogram, ordered by name.
+
+        Histograms are kept in memory and only read when reported, so
+        every collector records them, including the NullCollector.
+    */
+    virtual std::vector <HistogramSnapshot> histograms () = 0;
 };
 
 }
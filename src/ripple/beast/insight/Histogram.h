@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BEAST_INSIGHT_HISTOGRAM_H_INCLUDED
+#define BEAST_INSIGHT_HISTOGRAM_H_INCLUDED
+
+#include <ripple/beast/insight/Base.h>
+#include <ripple/beast/insight/HistogramImpl.h>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace beast {
+namespace insight {
+
+/** A metric for reporting the distribution of a latency.
+
+    Unlike an Event, which hands every value to the collector, a
+    histogram only counts the value in memory. The totals are read
+    when they are reported, by Collector::histograms.
+
+    This is a lightweight reference wrapper which is cheap to copy and assign.
+    When the last reference goes away, the metric is no longer collected.
+*/
+class Histogram : public Base
+{
+public:
+    using value_type = HistogramImpl::value_type;
+
+    /** Create a null metric.
+        A null metric reports no information.
+    */
+    Histogram ()
+        { }
+
+    /** Create the metric reference the specified implementation.
+        Normally this won't be called directly. Instead, call the
+        appropriate factory function in the Collector interface.
+        @see Collector.
+    */
+    explicit Histogram (std::shared_ptr <HistogramImpl> const& impl)
+        : m_impl (impl)
+        { }
+
+    /** Record a duration, in microseconds. */
+    template <class Rep, class Period>
+    void
+    notify (std::chrono::duration <Rep, Period> const& value) const
+    {
+        using namespace std::chrono;
+        if (m_impl)
+        {
+            auto const us = duration_cast <microseconds> (value).count();
+            m_impl->record (us > 0 ? static_cast <value_type> (us) : 0);
+        }
+    }
+
+    /** Record a value. */
+    void
+    record (value_type value) const
+    {
+        if (m_impl)
+            m_impl->record (value);
+    }
+
+    std::shared_ptr <HistogramImpl> const& impl () const
+    {
+        return m_impl;
+    }
+
+private:
+    std::shared_ptr <HistogramImpl> m_impl;
+};
+
+/** The histograms made by one collector.
+
+    A histogram is read from memory when it is reported, rather than
+    sent anywhere, so the collector that made it keeps it here. A name
+    always gives the same histogram while it is in use.
+
+    Thread Safety:
+
+        May be called concurrently.
+*/
+class HistogramSet
+{
+public:
+    /** Return the histogram with this name, creating it if needed. */
+    Histogram
+    make (std::string const& name);
+
+    /** Return the contents of every histogram, ordered by name. */
+    std::vector <HistogramSnapshot>
+    snapshot ();
+
+private:
+    std::mutex mutex_;
+    std::map <std::string, std::weak_ptr <HistogramImpl>> map_;
+};
+
+/** Write histograms in the Prometheus text format.
+
+    Each histogram is written as a summary with a few quantiles.
+    Characters that are not allowed in a metric name are replaced
+    with underscores.
+*/
+void
+writePrometheus (std::ostream& os, std::string const& prefix,
+    std::vector <HistogramSnapshot> const& histograms);
+
+}
+}
+
+#endif
@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef BEAST_INSIGHT_HISTOGRAMIMPL_H_INCLUDED
+#define BEAST_INSIGHT_HISTOGRAMIMPL_H_INCLUDED
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace beast {
+namespace insight {
+
+namespace detail {
+
+// Values below 32 have a bucket each. Above that, every power of two
+// is split into 16 buckets, so a bucket is never wider than 1/16 of
+// the values it holds. Values from 2^40 up share the last bucket.
+std::size_t const histogramBuckets = 32 + 35 * 16;
+
+inline
+std::size_t
+histogramBucket (std::uint64_t value)
+{
+    if (value < 32)
+        return static_cast<std::size_t>(value);
+
+    // The position of the highest set bit
+    int magnitude = 0;
+    for (auto v = value, shift = decltype(v){32}; shift > 0; shift /= 2)
+    {
+        if ((v >> shift) != 0)
+        {
+            v >>= shift;
+            magnitude += static_cast<int>(shift);
+        }
+    }
+    if (magnitude >= 40)
+        return histogramBuckets - 1;
+    return 32 + (magnitude - 5) * 16 + static_cast<std::size_t>(
+        (value >> (magnitude - 4)) & 15);
+}
+
+/** The smallest value counted in a bucket. */
+std::uint64_t
+histogramBucketFloor (std::size_t bucket);
+
+} // detail
+
+/** The contents of a histogram at one moment. */
+struct HistogramSnapshot
+{
+    std::string name;
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t max = 0;
+    std::vector<std::uint64_t> buckets;
+
+    /** The value below which a fraction `p` of the values fall.
+
+        The result is within one bucket of the exact value.
+    */
+    std::uint64_t
+    percentile (double p) const;
+
+    std::uint64_t
+    mean() const
+    {
+        return count ? sum / count : 0;
+    }
+
+    /** Add the values recorded in another histogram. */
+    void
+    merge (HistogramSnapshot const& other);
+
+    /** The values recorded since an earlier snapshot of the same histogram.
+
+        The maximum is estimated from the highest bucket in use.
+    */
+    HistogramSnapshot
+    since (HistogramSnapshot const& earlier) const;
+};
+
+/** Records a distribution of integral values.
+
+    Recording is lock free. Each thread adds to one of several shards
+    of counters, picked once per thread, so threads recording at the
+    same time rarely touch the same memory. A snapshot adds up the
+    shards; it may miss values recorded while it is being taken.
+*/
+class HistogramImpl
+{
+public:
+    using value_type = std::uint64_t;
+
+    explicit
+    HistogramImpl (std::string const& name);
+
+    HistogramImpl (HistogramImpl const&) = delete;
+    HistogramImpl& operator= (HistogramImpl const&) = delete;
+
+    std::string const&
+    name() const
+    {
+        return name_;
+    }
+
+    void
+    record (value_type value)
+    {
+        auto& shard = shards_[shardIndex()];
+        shard.buckets[detail::histogramBucket (value)].fetch_add (
+            1, std::memory_order_relaxed);
+        shard.sum.fetch_add (value, std::memory_order_relaxed);
+        auto max = shard.max.load (std::memory_order_relaxed);
+        while (value > max && ! shard.max.compare_exchange_weak (
+                max, value, std::memory_order_relaxed))
+            ;
+    }
+
+    HistogramSnapshot
+    snapshot() const;
+
+private:
+    static std::size_t const shardCount = 8;
+
+    // The padding keeps the counters of neighbouring shards off each
+    // other's cache lines. Over-aligning the type would not: before
+    // C++17, operator new[] ignores alignment beyond the default.
+    struct Shard
+    {
+        std::atomic<std::uint64_t> sum;
+        std::atomic<std::uint64_t> max;
+        std::array<std::atomic<std::uint64_t>,
+            detail::histogramBuckets> buckets;
+        char pad[64];
+    };
+
+    // The shard used by the calling thread
+    static
+    std::size_t
+    shardIndex();
+
+    std::string const name_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+}
+}
+
+#endif
@@ -84,6 +84,16 @@ public:
         return m_collector->make_meter (make_name (name));
     }
 
+    Histogram make_histogram (std::string const& name)
+    {
+        return m_collector->make_histogram (make_name (name));
+    }
+
+    std::vector <HistogramSnapshot> histograms ()
+    {
+        return m_collector->histograms ();
+    }
+
 private:
     GroupImp& operator= (GroupImp const&);
 };
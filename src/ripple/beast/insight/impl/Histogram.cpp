@@ -0,0 +1,233 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <ripple/beast/insight/Histogram.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace beast {
+namespace insight {
+
+namespace detail {
+
+std::uint64_t
+histogramBucketFloor (std::size_t bucket)
+{
+    if (bucket < 32)
+        return bucket;
+    auto const magnitude = 5 + (bucket - 32) / 16;
+    auto const step = (bucket - 32) % 16;
+    return std::uint64_t (16 + step) << (magnitude - 4);
+}
+
+} // detail
+
+std::uint64_t
+HistogramSnapshot::percentile (double p) const
+{
+    if (count == 0)
+        return 0;
+
+    // The rank of the value sought, counting from 1
+    auto const rank = std::max<std::uint64_t> (1,
+        static_cast<std::uint64_t> (p * count + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+        {
+            // Report the middle of the bucket, but never more than
+            // the largest value recorded
+            auto const floor = detail::histogramBucketFloor (i);
+            auto const next = i + 1 < detail::histogramBuckets ?
+                detail::histogramBucketFloor (i + 1) : floor + 1;
+            return std::min (floor + (next - floor - 1) / 2, max);
+        }
+    }
+    return max;
+}
+
+void
+HistogramSnapshot::merge (HistogramSnapshot const& other)
+{
+    count += other.count;
+    sum += other.sum;
+    max = std::max (max, other.max);
+    if (buckets.size() < other.buckets.size())
+        buckets.resize (other.buckets.size(), 0);
+    for (std::size_t i = 0; i < other.buckets.size(); ++i)
+        buckets[i] += other.buckets[i];
+}
+
+HistogramSnapshot
+HistogramSnapshot::since (HistogramSnapshot const& earlier) const
+{
+    HistogramSnapshot result;
+    result.name = name;
+    result.buckets.resize (buckets.size(), 0);
+    for (std::size_t i = 0; i < buckets.size(); ++i)
+    {
+        auto const before =
+            i < earlier.buckets.size() ? earlier.buckets[i] : 0;
+        if (buckets[i] <= before)
+            continue;
+        result.buckets[i] = buckets[i] - before;
+        result.count += result.buckets[i];
+        auto const next = i + 1 < detail::histogramBuckets ?
+            detail::histogramBucketFloor (i + 1) : max + 1;
+        result.max = std::min (next - 1, max);
+    }
+    result.sum = sum >= earlier.sum ? sum - earlier.sum : 0;
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+HistogramImpl::HistogramImpl (std::string const& name)
+    : name_ (name)
+    , shards_ (new Shard[shardCount])
+{
+    for (std::size_t i = 0; i < shardCount; ++i)
+    {
+        auto& shard = shards_[i];
+        shard.sum = 0;
+        shard.max = 0;
+        for (auto& bucket : shard.buckets)
+            bucket = 0;
+    }
+}
+
+HistogramSnapshot
+HistogramImpl::snapshot() const
+{
+    HistogramSnapshot result;
+    result.name = name_;
+    result.buckets.resize (detail::histogramBuckets, 0);
+    for (std::size_t i = 0; i < shardCount; ++i)
+    {
+        auto const& shard = shards_[i];
+        for (std::size_t j = 0; j < detail::histogramBuckets; ++j)
+        {
+            auto const n = shard.buckets[j].load (std::memory_order_relaxed);
+            result.buckets[j] += n;
+            result.count += n;
+        }
+        result.sum += shard.sum.load (std::memory_order_relaxed);
+        result.max = std::max (result.max,
+            shard.max.load (std::memory_order_relaxed));
+    }
+    return result;
+}
+
+std::size_t
+HistogramImpl::shardIndex()
+{
+    static std::atomic<std::size_t> next {0};
+    static thread_local std::size_t const index = next++ % shardCount;
+    return index;
+}
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+std::string
+metricName (std::string const& prefix, std::string const& name)
+{
+    std::string result = prefix.empty() ? name : prefix + "_" + name;
+    for (auto& c : result)
+    {
+        if (! ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                (c >= '0' && c <= '9') || c == '_' || c == ':'))
+            c = '_';
+    }
+    if (! result.empty() && result[0] >= '0' && result[0] <= '9')
+        result.insert (result.begin(), '_');
+    return result + "_us";
+}
+
+}
+
+Histogram
+HistogramSet::make (std::string const& name)
+{
+    std::lock_guard <std::mutex> lock (mutex_);
+    auto& entry = map_[name];
+    auto impl = entry.lock();
+    if (! impl)
+    {
+        impl = std::make_shared <HistogramImpl> (name);
+        entry = impl;
+    }
+    return Histogram (impl);
+}
+
+std::vector <HistogramSnapshot>
+HistogramSet::snapshot ()
+{
+    std::vector <std::shared_ptr <HistogramImpl>> live;
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        live.reserve (map_.size());
+        for (auto iter = map_.begin(); iter != map_.end();)
+        {
+            if (auto impl = iter->second.lock())
+            {
+                live.push_back (std::move (impl));
+                ++iter;
+            }
+            else
+            {
+                iter = map_.erase (iter);
+            }
+        }
+    }
+
+    std::vector <HistogramSnapshot> result;
+    result.reserve (live.size());
+    for (auto const& impl : live)
+        result.push_back (impl->snapshot());
+    return result;
+}
+
+void
+writePrometheus (std::ostream& os, std::string const& prefix,
+    std::vector <HistogramSnapshot> const& histograms)
+{
+    static std::pair<char const*, double> const quantiles[] =
+        {{"0.5", 0.5}, {"0.9", 0.9}, {"0.99", 0.99}, {"0.999", 0.999}};
+
+    for (auto const& h : histograms)
+    {
+        auto const name = metricName (prefix, h.name);
+        os << "# TYPE " << name << " summary\n";
+        for (auto const& q : quantiles)
+            os << name << "{quantile=\"" << q.first << "\"} " <<
+                h.percentile (q.second) << "\n";
+        os << name << "_sum " << h.sum << "\n";
+        os << name << "_count " << h.count << "\n";
+    }
+}
+
+}
+}
@@ -91,6 +91,8 @@ private:
 class NullCollectorImp : public NullCollector
 {
 private:
+    HistogramSet m_histograms;
+
 public:
     NullCollectorImp ()
     {
@@ -124,6 +126,16 @@ public:
     {
         return Meter (std::make_shared <detail::NullMeterImpl> ());
     }
+
+    Histogram make_histogram (std::string const& name)
+    {
+        return m_histograms.make (name);
+    }
+
+    std::vector <HistogramSnapshot> histograms ()
+    {
+        return m_histograms.snapshot ();
+    }
 };
 
 }
@@ -208,6 +208,7 @@ private:
     std::deque <std::string> m_data;
     std::recursive_mutex metricsLock_;
     List <StatsDMetricBase> metrics_;
+    HistogramSet m_histograms;
 
     // Must come last for order of init
     std::thread m_thread;
@@ -283,6 +284,16 @@ public:
             name, shared_from_this ()));
     }
 
+    Histogram make_histogram (std::string const& name)
+    {
+        return m_histograms.make (name);
+    }
+
+    std::vector <HistogramSnapshot> histograms ()
+    {
+        return m_histograms.snapshot ();
+    }
+
     //--------------------------------------------------------------------------
 
     void add (StatsDMetricBase& metric)
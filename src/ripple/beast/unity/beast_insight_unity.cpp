@@ -24,6 +24,7 @@
 #include <ripple/beast/insight/impl/Collector.cpp>
 #include <ripple/beast/insight/impl/Group.cpp>
 #include <ripple/beast/insight/impl/Groups.cpp>
+#include <ripple/beast/insight/impl/Histogram.cpp>
 #include <ripple/beast/insight/impl/Hook.cpp>
 #include <ripple/beast/insight/impl/Metric.cpp>
 #include <ripple/beast/insight/impl/NullCollector.cpp>
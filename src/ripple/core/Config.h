@@ -57,9 +57,12 @@ enum SizedItemName
     siLedgerSize,
     siLedgerAge,
     siLedgerFetch,
+    siLedgerPinned,
+    siFlagLedgerPinned,
     siHashNodeDBCache,
     siTxnDBCache,
     siLgrDBCache,
+    siRPCCacheSize,
 };
 
 struct SizedItem
@@ -109,7 +109,9 @@ resume()
     detail::getLocalValues().reset(&lvs_);
     std::lock_guard<std::mutex> lock(mutex_);
     assert (coro_);
+    segmentStart_ = ThreadUsage::now();
     coro_();
+    usage_ += ThreadUsage::now() - segmentStart_;
     detail::getLocalValues().release();
     detail::getLocalValues().reset(saved);
     std::lock_guard<std::mutex> lk(mutex_run_);
@@ -161,6 +163,14 @@ join()
         });
 }
 
+inline
+ThreadUsage
+JobQueue::Coro::
+usage() const
+{
+    return usage_ + (ThreadUsage::now() - segmentStart_);
+}
+
 } // ripple
 
 #endif
@@ -21,6 +21,7 @@
 #define RIPPLE_CORE_JOBQUEUE_H_INCLUDED
 
 #include <ripple/basics/LocalValue.h>
+#include <ripple/basics/ThreadUsage.h>
 #include <ripple/basics/win32_workaround.h>
 #include <ripple/core/JobTypes.h>
 #include <ripple/core/JobTypeData.h>
@@ -63,6 +64,8 @@ public:
         std::condition_variable cv_;
         boost::coroutines::asymmetric_coroutine<void>::pull_type coro_;
         boost::coroutines::asymmetric_coroutine<void>::push_type* yield_;
+        ThreadUsage usage_;
+        ThreadUsage segmentStart_;
     #ifndef NDEBUG
         bool finished_ = false;
     #endif
@@ -124,6 +127,13 @@ public:
 
         /** Waits until coroutine returns from the user function. */
         void join();
+
+        /** Returns the resources used by the coroutine so far.
+            Only the stretches spent running on a job thread are counted,
+            up to and including the current one.
+            Undefined behavior if called from outside the coroutine.
+        */
+        ThreadUsage usage() const;
     };
 
     using JobFunction = std::function <void(Job&)>;
@@ -23,6 +23,7 @@
 #include <ripple/basics/Log.h>
 #include <ripple/core/JobTypeInfo.h>
 #include <ripple/beast/insight/Collector.h>
+#include <ripple/beast/insight/Histogram.h>
 
 namespace ripple
 {
@@ -52,6 +53,10 @@ public:
     beast::insight::Event dequeue;
     beast::insight::Event execute;
 
+    /* Latency distributions, in microseconds */
+    beast::insight::Histogram dequeueTime;
+    beast::insight::Histogram executeTime;
+
     JobTypeData (JobTypeInfo const& info_,
             beast::insight::Collector::ptr const& collector, Logs& logs) noexcept
         : m_load (logs.journal ("LoadMonitor"))
@@ -69,6 +74,10 @@ public:
         {
             dequeue = m_collector->make_event (info.name () + "_q");
             execute = m_collector->make_event (info.name ());
+            dequeueTime = m_collector->make_histogram (
+                info.name () + "_q_time");
+            executeTime = m_collector->make_histogram (
+                info.name () + "_time");
         }
     }
 
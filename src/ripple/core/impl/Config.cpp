@@ -564,10 +564,14 @@ int Config::getSize (SizedItemName item) const
 
         { siLedgerSize,         {   32,     128,    256,    384,        768     } },
         { siLedgerAge,          {   30,     90,     180,    240,        900     } },
+        { siLedgerPinned,       {   8,      32,     128,    256,        256     } },
+        { siFlagLedgerPinned,   {   0,      1,      2,      4,          8       } },
 
         { siHashNodeDBCache,    {   4,      12,     24,     64,         128     } },
         { siTxnDBCache,         {   4,      12,     24,     64,         128     } },
         { siLgrDBCache,         {   4,      8,      16,     32,         128     } },
+
+        { siRPCCacheSize,       {   4,      16,     32,     128,        256     } },
     };
 
     for (int i = 0; i < (sizeof (sizeTable) / sizeof (SizedItem)); ++i)
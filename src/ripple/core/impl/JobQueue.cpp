@@ -410,9 +410,11 @@ void JobQueue::on_dequeue (JobType type,
 {
     using namespace std::chrono;
     auto const ms = ceil<milliseconds>(value);
+    auto& data = getJobTypeData (type);
 
+    data.dequeueTime.notify (value);
     if (ms >= 10ms)
-        getJobTypeData (type).dequeue.notify (ms);
+        data.dequeue.notify (ms);
 }
 
 template <class Rep, class Period>
@@ -421,9 +423,11 @@ void JobQueue::on_execute (JobType type,
 {
     using namespace std::chrono;
     auto const ms (ceil <milliseconds> (value));
+    auto& data = getJobTypeData (type);
 
+    data.executeTime.notify (value);
     if (ms >= 10ms)
-        getJobTypeData (type).execute.notify (ms);
+        data.execute.notify (ms);
 }
 
 void
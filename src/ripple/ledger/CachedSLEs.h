@@ -21,14 +21,24 @@
 #define RIPPLE_LEDGER_CACHEDSLES_H_INCLUDED
 
 #include <ripple/basics/chrono.h>
+#include <ripple/basics/hardened_hash.h>
 #include <ripple/protocol/STLedgerEntry.h>
 #include <ripple/beast/container/aged_unordered_map.h>
+#include <cassert>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
-/** Caches SLEs by their digest. */
+/** Caches SLEs by their digest.
+
+    The cache is split into independently locked shards, picked by the
+    digest, so that RPC and pathfinding threads reading the same ledger
+    rarely wait on each other. Every shard keeps at most its share of
+    the target size and drops its oldest entries to stay within it.
+*/
 class CachedSLEs
 {
 public:
@@ -37,16 +47,43 @@ public:
     using value_type =
         std::shared_ptr<SLE const>;
 
+    /** Counters reported by get_counts. */
+    struct Stats
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        // Lookups answered by a CachedView without reaching this cache
+        std::uint64_t viewHits = 0;
+        // Lock acquisitions that found the lock held by another thread
+        std::uint64_t contended = 0;
+        std::uint64_t evicted = 0;
+        std::size_t size = 0;
+    };
+
+    static std::size_t const defaultShardCount = 16;
+
     CachedSLEs (CachedSLEs const&) = delete;
     CachedSLEs& operator= (CachedSLEs const&) = delete;
 
+    /** Create the cache.
+
+        @param targetSize The most entries kept across all shards.
+            Zero means the size is limited only by the time to live.
+        @param shardCount The number of independently locked shards.
+    */
     template <class Rep, class Period>
     CachedSLEs (std::chrono::duration<
         Rep, Period> const& timeToLive,
-            Stopwatch& clock)
+            Stopwatch& clock, std::size_t targetSize = 0,
+                std::size_t shardCount = defaultShardCount)
         : timeToLive_ (timeToLive)
-        , map_ (clock)
+        , shardSize_ (targetSize == 0 ? 0 :
+            (targetSize + shardCount - 1) / shardCount)
     {
+        assert (shardCount != 0);
+        shards_.reserve (shardCount);
+        for (std::size_t i = 0; i < shardCount; ++i)
+            shards_.push_back (std::make_unique<Shard> (clock));
     }
 
     /** Discard expired entries.
@@ -68,44 +105,97 @@ public:
     fetch (digest_type const& digest,
         Handler const& h)
     {
+        auto& s = shard (digest);
         {
-            std::lock_guard<
-                std::mutex> lock(mutex_);
+            auto lock = s.lock();
             auto iter =
-                map_.find(digest);
-            if (iter != map_.end())
+                s.map.find(digest);
+            if (iter != s.map.end())
             {
-                ++hit_;
-                map_.touch(iter);
+                ++s.hits;
+                s.map.touch(iter);
                 return iter->second;
             }
         }
         auto sle = h();
         if (! sle)
             return nullptr;
-        std::lock_guard<
-            std::mutex> lock(mutex_);
-        ++miss_;
+        auto lock = s.lock();
+        ++s.misses;
         auto const result =
-            map_.emplace(
+            s.map.emplace(
                 digest, std::move(sle));
         if (! result.second)
-            map_.touch(result.first);
-        return  result.first->second;
+        {
+            s.map.touch(result.first);
+            return result.first->second;
+        }
+        auto const found = result.first->second;
+        if (shardSize_ != 0)
+            s.trim (shardSize_);
+        return found;
     }
 
+    /** Record lookups that a CachedView answered on its own. */
+    void
+    addViewStats (std::uint64_t hits, std::uint64_t contended);
+
     /** Returns the fraction of cache hits. */
     double
     rate() const;
 
+    Stats
+    getStats() const;
+
 private:
-    std::size_t hit_ = 0;
-    std::size_t miss_ = 0;
-    std::mutex mutable mutex_;
+    struct Shard
+    {
+        explicit Shard (Stopwatch& clock)
+            : map (clock)
+        {
+        }
+
+        std::unique_lock<std::mutex>
+        lock()
+        {
+            std::unique_lock<std::mutex> lock (
+                mutex, std::try_to_lock);
+            if (! lock.owns_lock())
+            {
+                lock.lock();
+                ++contended;
+            }
+            return lock;
+        }
+
+        // Drops the oldest entries beyond `size`
+        void
+        trim (std::size_t size);
+
+        std::mutex mutex;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t contended = 0;
+        std::uint64_t evicted = 0;
+        beast::aged_unordered_map <digest_type,
+            value_type, Stopwatch::clock_type,
+                hardened_hash<strong_hash>> map;
+    };
+
+    Shard&
+    shard (digest_type const& digest)
+    {
+        // The digest is already a cryptographic hash
+        return *shards_[*digest.begin() % shards_.size()];
+    }
+
     Stopwatch::duration timeToLive_;
-    beast::aged_unordered_map <digest_type,
-        value_type, Stopwatch::clock_type,
-            hardened_hash<strong_hash>> map_;
+    std::size_t const shardSize_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    std::mutex mutable viewMutex_;
+    std::uint64_t viewHits_ = 0;
+    std::uint64_t viewContended_ = 0;
 };
 
 } // ripple
@@ -23,10 +23,12 @@
 #include <ripple/ledger/CachedSLEs.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/basics/hardened_hash.h>
-#include <map>
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <type_traits>
+#include <unordered_map>
 
 namespace ripple {
 
@@ -36,12 +38,37 @@ class CachedViewImpl
     : public DigestAwareReadView
 {
 private:
+    // Readers of one ledger are spread over this
+    // many independently locked maps by key.
+    static std::size_t const shardCount = 8;
+
+    // Entries each shard holds at most. The SLEs are shared with
+    // CachedSLEs, so a full view only stops remembering new keys.
+    static std::size_t const shardLimit = 8192;
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::uint64_t hits = 0;
+        std::uint64_t contended = 0;
+        std::unordered_map<key_type,
+            std::shared_ptr<SLE const>,
+                hardened_hash<>> map;
+
+        std::unique_lock<std::mutex>
+        lock();
+    };
+
     DigestAwareReadView const& base_;
     CachedSLEs& cache_;
-    std::mutex mutable mutex_;
-    std::unordered_map<key_type,
-        std::shared_ptr<SLE const>,
-            hardened_hash<>> mutable map_;
+    std::array<Shard, shardCount> mutable shards_;
+
+    Shard&
+    shard (key_type const& key) const
+    {
+        // Keys are already hashes
+        return shards_[*key.begin() % shardCount];
+    }
 
 public:
     CachedViewImpl() = delete;
@@ -55,6 +82,8 @@ public:
     {
     }
 
+    ~CachedViewImpl() override;
+
     //
     // ReadView
     //
@@ -65,6 +94,9 @@ public:
     std::shared_ptr<SLE const>
     read (Keylet const& k) const override;
 
+    boost::optional<LazySLE>
+    readLazy (Keylet const& k) const override;
+
     bool
     open() const override
     {
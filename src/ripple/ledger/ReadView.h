@@ -23,6 +23,7 @@
 #include <ripple/ledger/detail/ReadViewFwdRange.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/LazySLE.h>
 #include <ripple/protocol/IOUAmount.h>
 #include <ripple/protocol/Protocol.h>
 #include <ripple/protocol/STLedgerEntry.h>
@@ -304,6 +305,25 @@ public:
     std::shared_ptr<SLE const>
     read (Keylet const& k) const = 0;
 
+    /** Return the state item associated with a key, decoded on demand.
+
+        This is meant for callers that look at a few fields of
+        an entry. Views backed by serialized state skip decoding
+        the fields that are never read; other views wrap the
+        result of `read`.
+
+        @return `boost::none` if the key is not present or
+                if the type does not match.
+    */
+    virtual
+    boost::optional<LazySLE>
+    readLazy (Keylet const& k) const
+    {
+        if (auto sle = read(k))
+            return LazySLE(std::move(sle));
+        return boost::none;
+    }
+
     // Accounts in a payment are not allowed to use assets acquired during that
     // payment. The PaymentSandbox tracks the debits, credits, and owner count
     // changes that accounts make during a payment. `balanceHook` adjusts balances
@@ -27,6 +27,7 @@
 #include <ripple/protocol/TER.h>
 #include <ripple/protocol/XRPAmount.h>
 #include <ripple/beast/utility/Journal.h>
+#include <boost/container/flat_map.hpp>
 #include <memory>
 
 namespace ripple {
@@ -47,14 +48,34 @@ private:
         modify,
     };
 
-    using items_t = std::map<key_type,
+    // A transaction touches a handful of entries, so the table is a
+    // sorted vector: lookups are a short binary search over contiguous
+    // keys and insertion does not allocate a node per entry.
+    using items_t = boost::container::flat_map<key_type,
         std::pair<Action, std::shared_ptr<SLE>>>;
 
+    // Enough for most transactions without growing
+    static std::size_t const initialCapacity = 16;
+
     items_t items_;
     XRPAmount dropsDestroyed_ = 0;
 
+    // Room is reserved on the first insert rather than on construction,
+    // since many tables, like those of strands that fail early, are
+    // never written to. Returns `hint`, which is still valid afterwards.
+    items_t::iterator
+    reserve (items_t::iterator hint)
+    {
+        if (items_.capacity() != 0)
+            return hint;
+        // Nothing was inserted yet, so the only position is the end
+        items_.reserve (initialCapacity);
+        return items_.end();
+    }
+
 public:
     ApplyStateTable() = default;
+
     ApplyStateTable (ApplyStateTable&&) = default;
 
     ApplyStateTable (ApplyStateTable const&) = delete;
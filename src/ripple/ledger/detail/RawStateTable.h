@@ -67,6 +67,10 @@ public:
     read (ReadView const& base,
         Keylet const& k) const;
 
+    boost::optional<LazySLE>
+    readLazy (ReadView const& base,
+        Keylet const& k) const;
+
     void
     destroyXRP (XRPAmount const& fee);
 
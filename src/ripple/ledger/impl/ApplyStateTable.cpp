@@ -354,7 +354,7 @@ ApplyStateTable::peek (ReadView const& base,
             return nullptr;
         // Make our own copy
         using namespace std;
-        iter = items_.emplace_hint (iter,
+        iter = items_.emplace_hint (reserve (iter),
             piecewise_construct,
                 forward_as_tuple(sle->key()),
                     forward_as_tuple(Action::cache,
@@ -409,6 +409,7 @@ ApplyStateTable::rawErase (ReadView const& base,
     std::shared_ptr<SLE> const& sle)
 {
     using namespace std;
+    reserve (items_.end());
     auto const result = items_.emplace(
         piecewise_construct,
             forward_as_tuple(sle->key()),
@@ -442,7 +443,7 @@ ApplyStateTable::insert (ReadView const& base,
         iter->first != sle->key())
     {
         using namespace std;
-        items_.emplace_hint(iter,
+        items_.emplace_hint(reserve (iter),
             piecewise_construct,
                 forward_as_tuple(sle->key()),
                     forward_as_tuple(Action::insert, sle));
@@ -474,7 +475,7 @@ ApplyStateTable::replace (ReadView const& base,
         iter->first != sle->key())
     {
         using namespace std;
-        items_.emplace_hint(iter, piecewise_construct,
+        items_.emplace_hint(reserve (iter), piecewise_construct,
             forward_as_tuple(sle->key()),
                 forward_as_tuple(Action::modify, sle));
         return;
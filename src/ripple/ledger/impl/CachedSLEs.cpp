@@ -23,18 +23,28 @@
 
 namespace ripple {
 
+void
+CachedSLEs::Shard::trim (std::size_t size)
+{
+    while (map.size() > size)
+    {
+        map.erase (map.chronological.begin());
+        ++evicted;
+    }
+}
+
 void
 CachedSLEs::expire()
 {
-    std::vector<
-        std::shared_ptr<void const>> trash;
+    for (auto& s : shards_)
     {
+        std::vector<
+            std::shared_ptr<void const>> trash;
         auto const expireTime =
-            map_.clock().now() - timeToLive_;
-        std::lock_guard<
-            std::mutex> lock(mutex_);
-        for (auto iter = map_.chronological.begin();
-            iter != map_.chronological.end(); ++iter)
+            s->map.clock().now() - timeToLive_;
+        auto lock = s->lock();
+        for (auto iter = s->map.chronological.begin();
+            iter != s->map.chronological.end();)
         {
             if (iter.when() > expireTime)
                 break;
@@ -42,21 +52,57 @@ CachedSLEs::expire()
             {
                 trash.emplace_back(
                     std::move(iter->second));
-                iter = map_.erase(iter);
+                iter = s->map.erase(iter);
+            }
+            else
+            {
+                ++iter;
             }
         }
     }
 }
 
+void
+CachedSLEs::addViewStats (
+    std::uint64_t hits, std::uint64_t contended)
+{
+    std::lock_guard<
+        std::mutex> lock(viewMutex_);
+    viewHits_ += hits;
+    viewContended_ += contended;
+}
+
 double
 CachedSLEs::rate() const
 {
-    std::lock_guard<
-        std::mutex> lock(mutex_);
-    auto const tot = hit_ + miss_;
+    auto const stats = getStats();
+    auto const tot = stats.hits + stats.misses;
     if (tot == 0)
         return 0;
-    return double(hit_) / tot;
+    return double(stats.hits) / tot;
+}
+
+auto
+CachedSLEs::getStats() const
+    -> Stats
+{
+    Stats stats;
+    for (auto& s : shards_)
+    {
+        // Reading the counters is not contention worth reporting
+        std::lock_guard<
+            std::mutex> lock(s->mutex);
+        stats.hits += s->hits;
+        stats.misses += s->misses;
+        stats.contended += s->contended;
+        stats.evicted += s->evicted;
+        stats.size += s->map.size();
+    }
+    std::lock_guard<
+        std::mutex> lock(viewMutex_);
+    stats.viewHits = viewHits_;
+    stats.contended += viewContended_;
+    return stats;
 }
 
 } // ripple
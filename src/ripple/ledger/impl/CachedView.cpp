@@ -25,6 +25,31 @@
 namespace ripple {
 namespace detail {
 
+std::unique_lock<std::mutex>
+CachedViewImpl::Shard::lock()
+{
+    std::unique_lock<std::mutex> lock (
+        mutex, std::try_to_lock);
+    if (! lock.owns_lock())
+    {
+        lock.lock();
+        ++contended;
+    }
+    return lock;
+}
+
+CachedViewImpl::~CachedViewImpl()
+{
+    std::uint64_t hits = 0;
+    std::uint64_t contended = 0;
+    for (auto const& s : shards_)
+    {
+        hits += s.hits;
+        contended += s.contended;
+    }
+    cache_.addViewStats (hits, contended);
+}
+
 bool
 CachedViewImpl::exists (Keylet const& k) const
 {
@@ -34,12 +59,13 @@ CachedViewImpl::exists (Keylet const& k) const
 std::shared_ptr<SLE const>
 CachedViewImpl::read (Keylet const& k) const
 {
+    auto& s = shard(k.key);
     {
-        std::lock_guard<
-            std::mutex> lock(mutex_);
-        auto const iter = map_.find(k.key);
-        if (iter != map_.end())
+        auto lock = s.lock();
+        auto const iter = s.map.find(k.key);
+        if (iter != s.map.end())
         {
+            ++s.hits;
             if (! k.check(*iter->second))
                 return nullptr;
             return iter->second;
@@ -51,13 +77,13 @@ CachedViewImpl::read (Keylet const& k) const
         return nullptr;
     auto sle = cache_.fetch(*digest,
         [&]() { return base_.read(k); });
-    std::lock_guard<
-        std::mutex> lock(mutex_);
+    auto lock = s.lock();
     auto const iter =
-        map_.find(k.key);
-    if (iter == map_.end())
+        s.map.find(k.key);
+    if (iter == s.map.end())
     {
-        map_.emplace(k.key, sle);
+        if (s.map.size() < shardLimit)
+            s.map.emplace(k.key, sle);
         return sle;
     }
     if (! k.check(*iter->second))
@@ -66,5 +92,24 @@ CachedViewImpl::read (Keylet const& k) const
 
 }
 
+boost::optional<LazySLE>
+CachedViewImpl::readLazy (Keylet const& k) const
+{
+    {
+        auto& s = shard(k.key);
+        auto lock = s.lock();
+        auto const iter = s.map.find(k.key);
+        if (iter != s.map.end())
+        {
+            ++s.hits;
+            if (! k.check(*iter->second))
+                return boost::none;
+            return LazySLE(iter->second);
+        }
+    }
+    // Entries that were never fully read are not cached
+    return base_.readLazy(k);
+}
+
 } // detail
 } // ripple
@@ -167,6 +167,12 @@ OpenView::read (Keylet const& k) const
     return items_.read(*base_, k);
 }
 
+boost::optional<LazySLE>
+OpenView::readLazy (Keylet const& k) const
+{
+    return items_.readLazy(*base_, k);
+}
+
 auto
 OpenView::slesBegin() const ->
     std::unique_ptr<sles_type::iter_base>
@@ -332,6 +332,18 @@ RawStateTable::read (ReadView const& base,
     return sle;
 }
 
+boost::optional<LazySLE>
+RawStateTable::readLazy (ReadView const& base,
+    Keylet const& k) const
+{
+    // Modified entries are already deserialized
+    if (items_.find(k.key) == items_.end())
+        return base.readLazy(k);
+    if (auto sle = read(base, k))
+        return LazySLE(std::move(sle));
+    return boost::none;
+}
+
 void
 RawStateTable::destroyXRP(XRPAmount const& fee)
 {
@@ -130,7 +130,7 @@ isGlobalFrozen (ReadView const& view,
     if (isXRP (issuer))
         return false;
     auto const sle =
-        view.read(keylet::account(issuer));
+        view.readLazy(keylet::account(issuer));
     if (sle && sle->isFlag (lsfGlobalFreeze))
         return true;
     return false;
@@ -146,13 +146,13 @@ isFrozen (ReadView const& view, AccountID const& account,
     if (isXRP (currency))
         return false;
     auto sle =
-        view.read(keylet::account(issuer));
+        view.readLazy(keylet::account(issuer));
     if (sle && sle->isFlag (lsfGlobalFreeze))
         return true;
     if (issuer != account)
     {
         // Check if the issuer froze the line
-        sle = view.read(keylet::line(
+        sle = view.readLazy(keylet::line(
             account, issuer, currency));
         if (sle && sle->isFlag(
             (issuer > account) ?
@@ -440,10 +440,10 @@ Rate
 transferRate (ReadView const& view,
     AccountID const& issuer)
 {
-    auto const sle = view.read(keylet::account(issuer));
+    auto const sle = view.readLazy(keylet::account(issuer));
 
     if (sle && sle->isFieldPresent (sfTransferRate))
-        return Rate{ sle->getFieldU32 (sfTransferRate) };
+        return Rate{ (*sle)[sfTransferRate] };
 
     return parityRate;
 }
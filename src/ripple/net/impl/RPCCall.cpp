@@ -1091,6 +1091,8 @@ public:
     //      {   "profile",              &RPCParser::parseProfile,               1,  9   },
             {   "random",               &RPCParser::parseAsIs,                  0,  0   },
             {   "ripple_path_find",     &RPCParser::parseRipplePathFind,        1,  2   },
+            {   "rpc_cache",            &RPCParser::parseFetchInfo,             0,  1   },
+            {   "rpc_costs",            &RPCParser::parseAsIs,                  0,  0   },
             {   "sign",                 &RPCParser::parseSignSubmit,            2,  3   },
             {   "sign_for",             &RPCParser::parseSignFor,               3,  4   },
             {   "submit",               &RPCParser::parseSignSubmit,            1,  3   },
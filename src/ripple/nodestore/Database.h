@@ -155,6 +155,13 @@ public:
     virtual std::uint32_t getStoreSize () const = 0;
     virtual std::uint32_t getFetchSize () const = 0;
 
+    /** Gather statistics pertaining to the key filter.
+        Return the writes skipped because the object was already stored,
+        and the reads of missing objects answered without the backend.
+     */
+    virtual std::uint32_t getStoreDuplicateCount () const = 0;
+    virtual std::uint32_t getFetchFilteredCount () const = 0;
+
     /** Return the number of files needed by our backend */
     virtual int fdlimit() const = 0;
 };
@@ -29,7 +29,7 @@ namespace NodeStore {
 /** Contains information about a fetch operation. */
 struct FetchReport
 {
-    std::chrono::milliseconds elapsed;
+    std::chrono::microseconds elapsed;
     bool isAsync;
     bool wentToDisk;
     bool wasFound;
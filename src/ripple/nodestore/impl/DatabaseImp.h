@@ -22,9 +22,11 @@
 
 #include <ripple/nodestore/Database.h>
 #include <ripple/nodestore/Scheduler.h>
+#include <ripple/nodestore/impl/KeyFilter.h>
 #include <ripple/nodestore/impl/Tuning.h>
 #include <ripple/basics/KeyCache.h>
 #include <ripple/basics/chrono.h>
+#include <ripple/basics/ThreadUsage.h>
 #include <ripple/beast/core/CurrentThreadName.h>
 
 namespace ripple {
@@ -45,6 +47,9 @@ protected:
     // Negative cache
     KeyCache <uint256> m_negCache;
 private:
+    // Keys that may be in the backend, or null if not configured
+    std::unique_ptr <KeyFilter> m_filter;
+
     std::mutex                m_readLock;
     std::condition_variable   m_readCondVar;
     std::condition_variable   m_readGenCondVar;
@@ -59,6 +64,8 @@ private:
     std::atomic <std::uint32_t> m_fetchHitCount;
     std::atomic <std::uint32_t> m_storeSize;
     std::atomic <std::uint32_t> m_fetchSize;
+    std::atomic <std::uint32_t> m_storeDuplicateCount;
+    std::atomic <std::uint32_t> m_fetchFilteredCount;
 
 public:
     DatabaseImp (std::string const& name,
@@ -66,7 +73,8 @@ public:
                  int readThreads,
                  Stoppable& parent,
                  std::unique_ptr <Backend> backend,
-                 beast::Journal journal)
+                 beast::Journal journal,
+                 std::unique_ptr <KeyFilter> filter = {})
         : Database (name, parent)
         , m_journal (journal)
         , m_scheduler (scheduler)
@@ -75,6 +83,7 @@ public:
             stopwatch(), journal)
         , m_negCache ("NodeStore", stopwatch(),
             cacheTargetSize, cacheTargetSeconds)
+        , m_filter (std::move (filter))
         , m_readShut (false)
         , m_readGen (0)
         , fdlimit_ (0)
@@ -83,6 +92,8 @@ public:
         , m_fetchHitCount (0)
         , m_storeSize (0)
         , m_fetchSize (0)
+        , m_storeDuplicateCount (0)
+        , m_fetchFilteredCount (0)
     {
         for (int i = 0; i < readThreads; ++i)
             m_readThreads.emplace_back (&DatabaseImp::threadEntry, this);
@@ -100,6 +111,11 @@ public:
         // these threads after the derived class is destroyed but before
         // this base class is destroyed.
         stopThreads();
+
+        // Nothing is written after this, so the journal can be folded
+        // into the snapshot
+        if (m_filter)
+            m_filter->close();
     }
 
     std::string
@@ -117,6 +133,12 @@ public:
         if (object || m_negCache.touch_if_exists (hash))
             return true;
 
+        if (m_filter && ! m_filter->mayContain (hash))
+        {
+            ++m_fetchFilteredCount;
+            return true;
+        }
+
         {
             // No. Post a read
             std::lock_guard <std::mutex> lock (m_readLock);
@@ -163,9 +185,11 @@ public:
 
         auto const before = std::chrono::steady_clock::now();
         std::shared_ptr<NodeObject> ret = doFetch (hash, report);
-        report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
+        report.elapsed = std::chrono::duration_cast <std::chrono::microseconds>
             (std::chrono::steady_clock::now() - before);
 
+        if (! isAsync)
+            ThreadUsage::addFetch();
         report.wasFound = (ret != nullptr);
         m_scheduler.onFetch (report);
 
@@ -184,6 +208,18 @@ public:
         if (m_negCache.touch_if_exists (hash))
             return obj;
 
+        if (m_filter && ! m_filter->mayContain (hash))
+        {
+            // The key was never stored, don't look for it
+            ++m_fetchFilteredCount;
+
+            // Just in case a write occurred
+            obj = m_cache.fetch (hash);
+            if (obj == nullptr)
+                m_negCache.insert (hash);
+            return obj;
+        }
+
         // Check the database(s).
 
         report.wentToDisk = true;
@@ -283,7 +319,20 @@ public:
         std::shared_ptr<NodeObject> object = NodeObject::createObject(
             type, std::move(data), hash);
 
-        m_cache.canonicalize (hash, object, true);
+        bool const known = m_filter && m_filter->mayContain (hash);
+
+        // Everything in the positive cache was either read from the
+        // backend or already handed to it, so a key that passes the
+        // filter and is cached needs no second write.
+        if (m_cache.canonicalize (hash, object, true) && known)
+        {
+            ++m_storeDuplicateCount;
+            m_negCache.erase (hash);
+            return;
+        }
+
+        if (m_filter)
+            m_filter->insert (hash);
 
         backend.store (object);
         ++m_storeCount;
@@ -390,6 +439,8 @@ public:
             }
 
             b.push_back (object);
+            if (m_filter)
+                m_filter->insert (object->getHash());
             ++m_storeCount;
             if (object)
                 m_storeSize += object->getData().size();
@@ -424,6 +475,16 @@ public:
         return m_fetchSize;
     }
 
+    std::uint32_t getStoreDuplicateCount () const override
+    {
+        return m_storeDuplicateCount;
+    }
+
+    std::uint32_t getFetchFilteredCount () const override
+    {
+        return m_fetchFilteredCount;
+    }
+
     int fdlimit() const override
     {
         return fdlimit_;
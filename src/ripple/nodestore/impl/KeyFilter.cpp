@@ -0,0 +1,543 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/nodestore/impl/KeyFilter.h>
+#include <ripple/nodestore/Backend.h>
+#include <ripple/basics/Log.h>
+#include <ripple/basics/random.h>
+#include <ripple/beast/core/CurrentThreadName.h>
+#include <ripple/beast/hash/xxhasher.h>
+#include <ripple/protocol/digest.h>
+#include <boost/filesystem.hpp>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace ripple {
+namespace NodeStore {
+
+namespace {
+
+// Bits of filter per expected key, for about 1% false positives
+std::size_t const bitsPerKey = 10;
+
+// Bits set per key, each one picked by 9 bits of the key
+int const probeCount = 7;
+
+// Identifies a snapshot, and its byte order
+std::uint64_t const snapshotMagic = 0x3330544c4946594bull; // "KYFILT03"
+
+std::uint64_t
+keyWord (uint256 const& key, int i)
+{
+    std::uint64_t w;
+    std::memcpy (&w, key.data() + 8 * i, sizeof(w));
+    return w;
+}
+
+// The journal of keys inserted since the snapshot
+boost::filesystem::path
+journalPath (boost::filesystem::path const& snapshot)
+{
+    return snapshot.string() + ".log";
+}
+
+// The previous journal, while a new snapshot is being written
+boost::filesystem::path
+oldJournalPath (boost::filesystem::path const& snapshot)
+{
+    return snapshot.string() + ".log.old";
+}
+
+// The key of the marker object stored for a generation
+uint256
+markerKey (std::uint64_t generation)
+{
+    return sha512Half (std::string ("KeyFilter"), generation);
+}
+
+bool
+hasMarker (Backend& backend, std::uint64_t generation)
+{
+    auto const key = markerKey (generation);
+    std::shared_ptr<NodeObject> object;
+    return backend.fetch (key.data(), &object) == ok && object;
+}
+
+void
+storeMarker (Backend& backend, std::uint64_t generation)
+{
+    Blob data (sizeof(generation));
+    std::memcpy (data.data(), &generation, sizeof(generation));
+    backend.store (NodeObject::createObject (
+        hotUNKNOWN, std::move (data), markerKey (generation)));
+}
+
+} // namespace
+
+std::chrono::milliseconds const KeyFilter::journalInterval {100};
+
+KeyFilter::KeyFilter (std::size_t expectedKeys)
+    : blocks_ (std::max<std::size_t> (1,
+        (expectedKeys * bitsPerKey + 8 * blockBytes - 1) / (8 * blockBytes)))
+    , words_ (new std::atomic<std::uint64_t>[blocks_ * blockWords])
+{
+    for (std::size_t i = 0; i < blocks_ * blockWords; ++i)
+        words_[i].store (0, std::memory_order_relaxed);
+}
+
+template <class Word>
+Word*
+KeyFilter::block (Word* words, std::size_t blocks, uint256 const& key,
+    std::uint64_t& probes)
+{
+    probes = keyWord (key, 1);
+    return words + (keyWord (key, 0) % blocks) * blockWords;
+}
+
+void
+KeyFilter::set (uint256 const& key)
+{
+    std::uint64_t probes;
+    auto const b = block (words_.get(), blocks_, key, probes);
+    for (int i = 0; i < probeCount; ++i, probes >>= 9)
+    {
+        auto const bit = probes & 511;
+        auto const mask = std::uint64_t(1) << (bit & 63);
+        auto& w = b[bit >> 6];
+        // Skip the locked operation when the bit is already set
+        if (! (w.load (std::memory_order_relaxed) & mask))
+            w.fetch_or (mask, std::memory_order_relaxed);
+    }
+}
+
+void
+KeyFilter::insert (uint256 const& key)
+{
+    set (key);
+
+    std::lock_guard<std::mutex> lock (journalMutex_);
+    if (! journaling_)
+        return;
+    pending_.push_back (key);
+    if (pending_.size() == journalBatch)
+        journalCond_.notify_one();
+}
+
+bool
+KeyFilter::mayContain (uint256 const& key) const
+{
+    std::uint64_t probes;
+    auto const b = block (words_.get(), blocks_, key, probes);
+    for (int i = 0; i < probeCount; ++i, probes >>= 9)
+    {
+        auto const bit = probes & 511;
+        if (! (b[bit >> 6].load (std::memory_order_relaxed) &
+                (std::uint64_t(1) << (bit & 63))))
+            return false;
+    }
+    return true;
+}
+
+bool
+KeyFilter::save (boost::filesystem::path const& path) const
+{
+    auto const temp = path.string() + ".tmp";
+    {
+        std::ofstream out (temp, std::ios::binary | std::ios::trunc);
+        if (! out)
+            return false;
+
+        std::uint64_t const header[3] = {
+            snapshotMagic, blocks_, generation_ };
+        out.write (reinterpret_cast<char const*>(header), sizeof(header));
+
+        beast::xxhasher h;
+        std::uint64_t buf[512];
+        std::size_t const total = blocks_ * blockWords;
+        for (std::size_t i = 0; i < total && out;)
+        {
+            std::size_t n = 0;
+            for (; n < 512 && i < total; ++n, ++i)
+                buf[n] = words_[i].load (std::memory_order_relaxed);
+            h (buf, n * sizeof(buf[0]));
+            out.write (reinterpret_cast<char const*>(buf), n * sizeof(buf[0]));
+        }
+
+        std::uint64_t const checksum = static_cast<std::size_t> (h);
+        out.write (reinterpret_cast<char const*>(&checksum),
+            sizeof(checksum));
+
+        out.flush();
+        if (! out)
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove (temp, ec);
+            return false;
+        }
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename (temp, path, ec);
+    return ! ec;
+}
+
+std::unique_ptr<KeyFilter>
+KeyFilter::load (boost::filesystem::path const& path, std::size_t expectedKeys)
+{
+    std::unique_ptr<KeyFilter> filter;
+
+    std::ifstream in (path.string(), std::ios::binary);
+    if (! in)
+        return filter;
+
+    filter = std::make_unique<KeyFilter> (expectedKeys);
+
+    std::uint64_t header[3];
+    if (! in.read (reinterpret_cast<char*>(header), sizeof(header)) ||
+        header[0] != snapshotMagic || header[1] != filter->blocks_)
+    {
+        filter.reset();
+        return filter;
+    }
+    filter->generation_ = header[2];
+
+    beast::xxhasher h;
+    std::uint64_t buf[512];
+    std::size_t const total = filter->blocks_ * blockWords;
+    for (std::size_t i = 0; i < total;)
+    {
+        auto const n = std::min<std::size_t> (512, total - i);
+        if (! in.read (reinterpret_cast<char*>(buf), n * sizeof(buf[0])))
+        {
+            filter.reset();
+            return filter;
+        }
+        h (buf, n * sizeof(buf[0]));
+        for (std::size_t j = 0; j < n; ++j, ++i)
+            filter->words_[i].store (buf[j], std::memory_order_relaxed);
+    }
+
+    // The checksum must match and end the file
+    std::uint64_t checksum;
+    if (! in.read (reinterpret_cast<char*>(&checksum), sizeof(checksum)) ||
+        checksum != static_cast<std::size_t> (h) ||
+        in.peek() != std::ifstream::traits_type::eof())
+    {
+        filter.reset();
+        return filter;
+    }
+
+    // Keys inserted after the snapshot was written
+    if (! filter->replay (oldJournalPath (path)) ||
+            ! filter->replay (journalPath (path)))
+        filter.reset();
+    return filter;
+}
+
+bool
+KeyFilter::replay (boost::filesystem::path const& path)
+{
+    std::ifstream in (path.string(), std::ios::binary);
+    if (! in)
+    {
+        // There may be no journal, but one that exists must be read
+        boost::system::error_code ec;
+        return ! boost::filesystem::exists (path, ec);
+    }
+
+    // A partial key at the end was never handed to the backend
+    uint256 key;
+    while (in.read (reinterpret_cast<char*>(key.data()), uint256::bytes))
+        set (key);
+    return in.eof();
+}
+
+void
+KeyFilter::remove (boost::filesystem::path const& path)
+{
+    boost::system::error_code ec;
+    boost::filesystem::remove (path, ec);
+    boost::filesystem::remove (journalPath (path), ec);
+    boost::filesystem::remove (oldJournalPath (path), ec);
+}
+
+bool
+KeyFilter::journal (boost::filesystem::path const& path,
+    std::uint64_t generation)
+{
+    assert (! writer_.joinable());
+    snapshot_ = path;
+    generation_ = generation;
+
+    boost::system::error_code ec;
+    if (save (snapshot_))
+    {
+        boost::filesystem::remove (oldJournalPath (snapshot_), ec);
+        if (! ec)
+        {
+            journal_.open (journalPath (snapshot_).string(),
+                std::ios::binary | std::ios::trunc);
+            journalKeys_ = 0;
+            if (journal_)
+            {
+                journaling_ = true;
+                writer_ = std::thread (&KeyFilter::run, this);
+                return true;
+            }
+        }
+    }
+
+    discard();
+    return false;
+}
+
+void
+KeyFilter::close()
+{
+    if (! stop())
+        return;
+
+    journal_.close();
+    boost::system::error_code ec;
+    if (save (snapshot_))
+        boost::filesystem::remove (journalPath (snapshot_), ec);
+    else
+        discard();
+}
+
+KeyFilter::~KeyFilter()
+{
+    stop();
+}
+
+bool
+KeyFilter::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock (journalMutex_);
+        if (! writer_.joinable())
+            return false;
+        stopping_ = true;
+    }
+    journalCond_.notify_one();
+    writer_.join();
+    return journal_.is_open();
+}
+
+void
+KeyFilter::run()
+{
+    beast::setCurrentThreadName ("keyfilter");
+
+    std::vector<uint256> keys;
+    std::unique_lock<std::mutex> lock (journalMutex_);
+    while (journaling_)
+    {
+        journalCond_.wait_for (lock, journalInterval, [this]
+            {
+                return stopping_ || pending_.size() >= journalBatch;
+            });
+        keys.swap (pending_);
+        bool const stopping = stopping_;
+        lock.unlock();
+
+        bool ok = append (keys);
+        keys.clear();
+        if (ok && stopping && checkpoint_.joinable())
+            ok = finishCheckpoint();
+        if (! ok)
+            discard();
+
+        lock.lock();
+        if (! ok)
+        {
+            journaling_ = false;
+            pending_.clear();
+        }
+        if (stopping)
+            break;
+    }
+}
+
+bool
+KeyFilter::append (std::vector<uint256> const& keys)
+{
+    static_assert (sizeof(uint256) == uint256::bytes, "");
+
+    if (checkpointDone_ && ! finishCheckpoint())
+        return false;
+
+    if (! keys.empty())
+    {
+        journal_.write (reinterpret_cast<char const*>(keys.data()),
+            keys.size() * uint256::bytes);
+        journal_.flush();
+        if (! journal_)
+            return false;
+        journalKeys_ += keys.size();
+    }
+
+    // Replaying the journal should cost no more than the snapshot
+    if (journalKeys_ * uint256::bytes < bytes() || checkpoint_.joinable())
+        return true;
+    return startCheckpoint();
+}
+
+bool
+KeyFilter::startCheckpoint()
+{
+    // Start a new journal. The snapshot written next holds at least
+    // every key in the old one, and a crash before it is in place
+    // leaves the previous snapshot and both journals.
+    journal_.close();
+    boost::system::error_code ec;
+    boost::filesystem::rename (journalPath (snapshot_),
+        oldJournalPath (snapshot_), ec);
+    if (ec)
+        return false;
+    journal_.open (journalPath (snapshot_).string(),
+        std::ios::binary | std::ios::trunc);
+    journalKeys_ = 0;
+    if (! journal_)
+        return false;
+
+    checkpointDone_ = false;
+    checkpoint_ = std::thread ([this]
+        {
+            beast::setCurrentThreadName ("keyfilter save");
+            checkpointSaved_ = save (snapshot_);
+            checkpointDone_ = true;
+        });
+    return true;
+}
+
+bool
+KeyFilter::finishCheckpoint()
+{
+    checkpoint_.join();
+    checkpointDone_ = false;
+    if (! checkpointSaved_)
+        return false;
+
+    boost::system::error_code ec;
+    boost::filesystem::remove (oldJournalPath (snapshot_), ec);
+    return ! ec;
+}
+
+void
+KeyFilter::discard()
+{
+    // Files that no longer describe the backend must not be loaded,
+    // nor written again by a snapshot still in progress
+    if (checkpoint_.joinable())
+        checkpoint_.join();
+    journal_.close();
+    remove (snapshot_);
+}
+
+//------------------------------------------------------------------------------
+
+std::unique_ptr<KeyFilter>
+make_KeyFilter (Section const& parameters, Backend& backend,
+    beast::Journal journal)
+{
+    boost::filesystem::path snapshot;
+    auto const dir = get<std::string> (parameters, "path");
+    boost::system::error_code ec;
+    if (! dir.empty() && boost::filesystem::is_directory (dir, ec))
+        snapshot = boost::filesystem::path (dir) / "keyfilter";
+
+    std::size_t expectedKeys = 0;
+    if (! get_if_exists (parameters, "filter_keys", expectedKeys) ||
+        expectedKeys == 0)
+    {
+        // Keys stored from now on would be missing from the files
+        if (! snapshot.empty())
+            KeyFilter::remove (snapshot);
+        return {};
+    }
+
+    std::unique_ptr<KeyFilter> filter;
+    if (! snapshot.empty())
+        filter = KeyFilter::load (snapshot, expectedKeys);
+
+    if (filter && ! hasMarker (backend, filter->generation()))
+    {
+        JLOG(journal.warn()) <<
+            "Key filter: " << snapshot.string() <<
+            " was not kept for the contents of " << backend.getName();
+        filter.reset();
+    }
+
+    if (filter)
+    {
+        JLOG(journal.info()) <<
+            "Key filter loaded from " << snapshot.string();
+    }
+    else
+    {
+        JLOG(journal.warn()) <<
+            "Key filter: reading every key in " << backend.getName();
+
+        auto const start = std::chrono::steady_clock::now();
+        filter = std::make_unique<KeyFilter> (expectedKeys);
+        std::size_t count = 0;
+        backend.for_each (
+            [&](std::shared_ptr<NodeObject> object)
+            {
+                filter->insert (object->getHash());
+                ++count;
+            });
+
+        JLOG(journal.warn()) <<
+            "Key filter: " << count << " keys, " << filter->bytes() <<
+            " bytes, built in " <<
+            std::chrono::duration_cast<std::chrono::seconds> (
+                std::chrono::steady_clock::now() - start).count() << "s";
+        if (count > expectedKeys)
+        {
+            JLOG(journal.warn()) <<
+                "Key filter: filter_keys is smaller than the store, "
+                "false positives will be frequent";
+        }
+    }
+
+    if (snapshot.empty())
+        return filter;
+
+    // The marker is stored before any snapshot names it
+    auto const generation = rand_int<std::uint64_t> (
+        1, std::numeric_limits<std::uint64_t>::max());
+    storeMarker (backend, generation);
+    if (! filter->journal (snapshot, generation))
+    {
+        JLOG(journal.warn()) <<
+            "Key filter: unable to write " << snapshot.string() <<
+            ", it will be rebuilt at the next start";
+    }
+    return filter;
+}
+
+}
+}
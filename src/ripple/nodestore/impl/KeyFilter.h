@@ -0,0 +1,244 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_NODESTORE_KEYFILTER_H_INCLUDED
+#define RIPPLE_NODESTORE_KEYFILTER_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/beast/utility/Journal.h>
+#include <boost/filesystem/path.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+class Backend;
+
+/** A probabilistic set of the keys held by a backend.
+
+    This is a blocked bloom filter: each key selects one 64 byte block
+    and sets a few bits inside it, so a lookup touches a single cache
+    line. A negative answer is exact, the key was never inserted. A
+    positive answer is wrong about one time in a hundred when the
+    filter holds the number of keys it was sized for.
+
+    Keys are already uniformly distributed hashes, so their bits are
+    used directly instead of being hashed again.
+
+    A filter can be kept on disk as a snapshot plus a journal of the
+    keys inserted since the snapshot was written. A background thread
+    appends the inserted keys to the journal in batches, at least every
+    journalInterval, and writes new snapshots, so insert never waits on
+    the disk. The backends hold their own writes back for longer (NuDB
+    commits once a second), so if the process stops without warning
+    the journal lacks at most the keys stored in its last moments. Such
+    a key reads as absent until it is stored again. The snapshot also
+    records a generation, which the owner uses to tie the files to the
+    backend contents they describe.
+
+    Thread Safety:
+
+        insert and mayContain may be called concurrently.
+*/
+class KeyFilter
+{
+public:
+    /** Create an empty filter sized for `expectedKeys` keys. */
+    explicit
+    KeyFilter (std::size_t expectedKeys);
+
+    /** Stop the journal without a final snapshot.
+
+        The files are left as a crash would leave them. Call close
+        first to fold the journal into the snapshot.
+    */
+    ~KeyFilter();
+
+    KeyFilter (KeyFilter const&) = delete;
+    KeyFilter& operator= (KeyFilter const&) = delete;
+
+    /** Add a key, queuing it for the journal if there is one. */
+    void
+    insert (uint256 const& key);
+
+    /** Returns `false` if the key was certainly never inserted. */
+    bool
+    mayContain (uint256 const& key) const;
+
+    /** Returns the number of bytes in the filter. */
+    std::size_t
+    bytes() const
+    {
+        return blocks_ * blockBytes;
+    }
+
+    /** Returns the generation recorded in the snapshot files. */
+    std::uint64_t
+    generation() const
+    {
+        return generation_;
+    }
+
+    /** Write a snapshot of the filter to a file.
+
+        The file is replaced atomically, carries a checksum and
+        records the generation.
+
+        @return `false` if the file could not be written.
+    */
+    bool
+    save (boost::filesystem::path const& path) const;
+
+    /** Read a snapshot written by save, and replay its journal.
+
+        @return `nullptr` if the snapshot is missing, damaged or was
+                written for a different size.
+    */
+    static
+    std::unique_ptr<KeyFilter>
+    load (boost::filesystem::path const& path, std::size_t expectedKeys);
+
+    /** Remove a snapshot and its journals. */
+    static
+    void
+    remove (boost::filesystem::path const& path);
+
+    /** Keep the filter on disk from now on.
+
+        Writes a snapshot to `path`, recording `generation`, and starts
+        a journal next to it. Once the journal is as large as the
+        snapshot, a new snapshot is written in the background and the
+        journal starts over.
+
+        @return `false` if the files could not be written. Any files
+                left at `path` are removed, and the filter is then
+                only kept in memory.
+    */
+    bool
+    journal (boost::filesystem::path const& path,
+        std::uint64_t generation);
+
+    /** Write out the queued keys, then a final snapshot.
+
+        Called after the last insert, so that the next load need not
+        replay anything.
+    */
+    void
+    close();
+
+private:
+    static std::size_t const blockBytes = 64;
+    static std::size_t const blockWords = blockBytes / 8;
+
+    template <class Word>
+    static
+    Word*
+    block (Word* words, std::size_t blocks, uint256 const& key,
+        std::uint64_t& probes);
+
+    void
+    set (uint256 const& key);
+
+    bool
+    replay (boost::filesystem::path const& path);
+
+    // The journal writer thread
+    void
+    run();
+
+    // The rest are only called by the writer, or once it has stopped
+
+    bool
+    append (std::vector<uint256> const& keys);
+
+    bool
+    startCheckpoint();
+
+    bool
+    finishCheckpoint();
+
+    void
+    discard();
+
+    // Stops the writer, returns `true` if the journal is still good
+    bool
+    stop();
+
+    // The longest a key waits to be written to the journal
+    static std::chrono::milliseconds const journalInterval;
+
+    // Queued keys that wake the writer early
+    static std::size_t const journalBatch = 1024;
+
+    std::size_t const blocks_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> words_;
+    std::uint64_t generation_ = 0;
+
+    // Keys waiting for the writer, see journal()
+    std::mutex journalMutex_;
+    std::condition_variable journalCond_;
+    std::vector<uint256> pending_;
+    bool journaling_ = false;
+    bool stopping_ = false;
+    std::thread writer_;
+
+    // Owned by the writer
+    boost::filesystem::path snapshot_;
+    std::ofstream journal_;
+    std::size_t journalKeys_ = 0;
+
+    // Writes a new snapshot while the journal carries on
+    std::thread checkpoint_;
+    std::atomic<bool> checkpointDone_ {false};
+    bool checkpointSaved_ = false;
+};
+
+/** Create the key filter configured for a backend.
+
+    Returns `nullptr` unless the section sets "filter_keys", and then
+    removes any filter files left in the backend's directory, since
+    nothing would record the keys stored while it is off.
+
+    The filter is kept in the backend's directory and read back from
+    there when the database is opened again, after a clean shutdown or
+    not. Each time the filter starts its journal, a marker object named
+    after a new generation is stored in the backend. A snapshot whose
+    marker is not in the backend, such as one left next to a restored
+    backup, is not used. If the files are missing, damaged or do not
+    match, every key in the backend is read once.
+*/
+std::unique_ptr<KeyFilter>
+make_KeyFilter (Section const& parameters, Backend& backend,
+    beast::Journal journal);
+
+}
+}
+
+#endif
@@ -89,16 +89,24 @@ ManagerImp::make_Database (
     Section const& backendParameters,
     beast::Journal journal)
 {
+    auto backend = make_Backend (
+        backendParameters,
+        scheduler,
+        journal);
+
+    auto filter = make_KeyFilter (
+        backendParameters,
+        *backend,
+        journal);
+
     return std::make_unique <DatabaseImp> (
         name,
         scheduler,
         readThreads,
         parent,
-        make_Backend (
-            backendParameters,
-            scheduler,
-            journal),
-        journal);
+        std::move (backend),
+        journal,
+        std::move (filter));
 }
 
 std::unique_ptr <DatabaseRotating>
@@ -49,7 +49,11 @@ JSS ( OfferSequence );              // field.
 JSS ( Paths );                      // in/out: TransactionSign
 JSS ( TransferRate );               // in: TransferRate
 JSS ( historical_perminute );       // historical_perminute
+JSS ( SLE_cache_contended );        // out: GetCounts
+JSS ( SLE_cache_evicted );          // out: GetCounts
+JSS ( SLE_cache_size );             // out: GetCounts
 JSS ( SLE_hit_rate );               // out: GetCounts
+JSS ( SLE_view_hits );              // out: GetCounts
 JSS ( SettleDelay );                // in: TransactionSign
 JSS ( SendMax );                    // in: TransactionSign
 JSS ( Sequence );                   // in/out: TransactionSign; field.
@@ -78,6 +82,7 @@ JSS ( acquiring );                  // out: LedgerRequest
 JSS ( address );                    // out: PeerImp
 JSS ( affected );                   // out: AcceptedLedgerTx
 JSS ( age );                        // out: NetworkOPs, Peers
+JSS ( allocated_bytes );            // out: RPCCosts
 JSS ( alternatives );               // out: PathRequest, RipplePathFind
 JSS ( amendment_blocked );          // out: NetworkOPs
 JSS ( amendments );                 // in: AccountObjects, out: NetworkOPs
@@ -101,12 +106,13 @@ JSS ( both );                       // in: Subscribe, Unsubscribe
 JSS ( both_sides );                 // in: Subscribe, Unsubscribe
 JSS ( build_path );                 // in: TransactionSign
 JSS ( build_version );              // out: NetworkOPs
+JSS ( bytes );                      // out: RPCCache
 JSS ( cancel_after );               // out: AccountChannels
 JSS ( can_delete );                 // out: CanDelete
 JSS ( channel_id );                 // out: AccountChannels
 JSS ( channels );                   // out: AccountChannels
 JSS ( check_nodes );                // in: LedgerCleaner
-JSS ( clear );                      // in/out: FetchInfo
+JSS ( clear );                      // in/out: FetchInfo, RPCCache
 JSS ( close_flags );                // out: LedgerToJson
 JSS ( close_time );                 // in: Application, out: NetworkOPs,
                                     //      RCLCxPeerPos, LedgerToJson
@@ -126,6 +132,7 @@ JSS ( consensus );                  // out: NetworkOPs, LedgerConsensus
 JSS ( converge_time );              // out: NetworkOPs
 JSS ( converge_time_s );            // out: NetworkOPs
 JSS ( count );                      // in: AccountTx*, ValidatorList
+JSS ( cpu_us );                     // out: RPCCosts
 JSS ( currency );                   // in: paths/PathRequest, STAmount
                                     // out: paths/Node, STPathSet, STAmount
 JSS ( current );                    // out: OwnerInfo
@@ -152,10 +159,13 @@ JSS ( dir_root );                   // out: DirectoryEntryIterator
 JSS ( directory );                  // in: LedgerEntry
 JSS ( drops );                      // out: TxQ
 JSS ( duration_us );                // out: NetworkOPs
+JSS ( elapsed_s );                  // out: NetworkOPs
 JSS ( enabled );                    // out: AmendmentTable
 JSS ( engine_result );              // out: NetworkOPs, TransactionSign, Submit
 JSS ( engine_result_code );         // out: NetworkOPs, TransactionSign, Submit
 JSS ( engine_result_message );      // out: NetworkOPs, TransactionSign, Submit
+JSS ( entries );                    // out: RPCCache
+JSS ( eta_s );                      // out: NetworkOPs
 JSS ( error );                      // out: error
 JSS ( error_code );                 // out: error
 JSS ( error_exception );            // out: Submit
@@ -176,6 +186,7 @@ JSS ( fee_level );                  // out: AccountInfo
 JSS ( fee_mult_max );               // in: TransactionSign
 JSS ( fee_ref );                    // out: NetworkOPs
 JSS ( fetch_pack );                 // out: NetworkOPs
+JSS ( fetches );                    // out: RPCCosts
 JSS ( first );                      // out: rpc/Version
 JSS ( fix_txns );                   // in: LedgerCleaner
 JSS ( flags );                      // out: paths/Node, AccountOffers,
@@ -196,6 +207,9 @@ JSS ( have_header );                // out: InboundLedger
 JSS ( have_state );                 // out: InboundLedger
 JSS ( have_transactions );          // out: InboundLedger
 JSS ( highest_sequence );           // out: AccountInfo
+JSS ( histograms );                 // out: GetCounts, NetworkOPs
+JSS ( hit_rate );                   // out: RPCCache
+JSS ( hits );                       // out: RPCCache
 JSS ( hostid );                     // out: NetworkOPs
 JSS ( hotwallet );                  // in: GatewayBalances
 JSS ( id );                         // websocket.
@@ -233,12 +247,17 @@ JSS ( ledger_hash );                // in: RPCHelpers, LedgerRequest,
                                     //     handlers/Ledger
                                     // out: NetworkOPs, RPCHelpers,
                                     //      LedgerClosed, LedgerData
+JSS ( ledger_history_hits );        // out: GetCounts
+JSS ( ledger_history_misses );      // out: GetCounts
 JSS ( ledger_hit_rate );            // out: GetCounts
 JSS ( ledger_index );               // in/out: many
 JSS ( ledger_index_max );           // in, out: AccountTx*
 JSS ( ledger_index_min );           // in, out: AccountTx*
 JSS ( ledger_max );                 // in, out: AccountTx*
 JSS ( ledger_min );                 // in, out: AccountTx*
+JSS ( ledger_read_max_wait_us );    // out: GetCounts
+JSS ( ledger_read_wait_us );        // out: GetCounts
+JSS ( ledger_reads );               // out: GetCounts
 JSS ( ledger_time );                // out: NetworkOPs
 JSS ( levels );                     // LogLevels
 JSS ( limit );                      // in/out: AccountTx*, AccountOffers,
@@ -261,6 +280,7 @@ JSS ( load_fee );                   // out: LoadFeeTrackImp, NetworkOPs
 JSS ( local );                      // out: resource/Logic.h
 JSS ( local_txs );                  // out: GetCounts
 JSS ( local_static_keys );          // out: ValidatorList
+JSS ( log_messages_dropped );       // out: GetCounts
 JSS ( lowest_sequence );            // out: AccountInfo
 JSS ( majority );                   // out: RPC feature
 JSS ( marker );                     // in/out: AccountTx, AccountOffers,
@@ -271,10 +291,15 @@ JSS ( master_key );                 // out: WalletPropose
 JSS ( master_seed );                // out: WalletPropose
 JSS ( master_seed_hex );            // out: WalletPropose
 JSS ( master_signature );           // out: pubManifest
+JSS ( max );                        // out: RPCCosts
+JSS ( max_bytes );                  // out: RPCCache
 JSS ( max_ledger );                 // in/out: LedgerCleaner
 JSS ( max_queue_size );             // out: TxQ
 JSS ( max_spend_drops );            // out: AccountInfo
 JSS ( max_spend_drops_total );      // out: AccountInfo
+JSS ( max_us );                     // out: GetCounts, NetworkOPs
+JSS ( mean );                       // out: RPCCosts
+JSS ( mean_us );                    // out: GetCounts
 JSS ( median_fee );                 // out: TxQ
 JSS ( median_level );               // out: TxQ
 JSS ( message );                    // error.
@@ -282,24 +307,29 @@ JSS ( meta );                       // out: NetworkOPs, AccountTx*, Tx
 JSS ( metaData );
 JSS ( metadata );                   // out: TransactionEntry
 JSS ( method );                     // RPC
+JSS ( methods );                    // out: RPCCosts
 JSS ( min_count );                  // in: GetCounts
 JSS ( min_ledger );                 // in: LedgerCleaner
 JSS ( minimum_fee );                // out: TxQ
 JSS ( minimum_level );              // out: TxQ
+JSS ( misses );                     // out: RPCCache
 JSS ( missingCommand );             // error
 JSS ( name );                       // out: AmendmentTableImpl, PeerImp
 JSS ( needed_state_hashes );        // out: InboundLedger
 JSS ( needed_transaction_hashes );  // out: InboundLedger
 JSS ( network_ledger );             // out: NetworkOPs
+JSS ( next_rotation );              // out: NetworkOPs
 JSS ( no_ripple );                  // out: AccountLines
 JSS ( no_ripple_peer );             // out: AccountLines
 JSS ( node );                       // out: LedgerEntry
 JSS ( node_binary );                // out: LedgerEntry
 JSS ( node_hit_rate );              // out: GetCounts
 JSS ( node_read_bytes );            // out: GetCounts
+JSS ( node_reads_filtered );        // out: GetCounts
 JSS ( node_reads_hit );             // out: GetCounts
 JSS ( node_reads_total );           // out: GetCounts
 JSS ( node_writes );                // out: GetCounts
+JSS ( node_writes_duplicate );      // out: GetCounts
 JSS ( node_written_bytes );         // out: GetCounts
 JSS ( nodes );                      // out: PathState
 JSS ( obligations );                // out: GatewayBalances
@@ -307,11 +337,18 @@ JSS ( offer );                      // in: LedgerEntry
 JSS ( offers );                     // out: NetworkOPs, AccountOffers, Subscribe
 JSS ( offline );                    // in: TransactionSign
 JSS ( offset );                     // in/out: AccountTxOld
+JSS ( online_delete );              // out: NetworkOPs
 JSS ( open );                       // out: handlers/Ledger
 JSS ( open_ledger_fee );            // out: TxQ
 JSS ( open_ledger_level );          // out: TxQ
 JSS ( owner );                      // in: LedgerEntry, out: NetworkOPs
 JSS ( owner_funds );                // in/out: Ledger, NetworkOPs, AcceptedLedgerTx
+JSS ( p50 );                        // out: RPCCosts
+JSS ( p50_us );                     // out: GetCounts, NetworkOPs
+JSS ( p90 );                        // out: RPCCosts
+JSS ( p90_us );                     // out: GetCounts
+JSS ( p99 );                        // out: RPCCosts
+JSS ( p99_us );                     // out: GetCounts, NetworkOPs
 JSS ( params );                     // RPC
 JSS ( parent_close_time );          // out: LedgerToJson
 JSS ( parent_hash );                // out: LedgerToJson
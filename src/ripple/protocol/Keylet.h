@@ -25,6 +25,7 @@
 
 namespace ripple {
 
+class LazySLE;
 class STLedgerEntry;
 
 /** A pair of SHAMap key and LedgerEntryType.
@@ -50,6 +51,13 @@ struct Keylet
     /** Returns true if the SLE matches the type */
     bool
     check (STLedgerEntry const&) const;
+
+    bool
+    check (LazySLE const&) const;
+
+private:
+    bool
+    check (LedgerEntryType other) const;
 };
 
 }
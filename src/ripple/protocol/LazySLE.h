@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_PROTOCOL_LAZYSLE_H_INCLUDED
+#define RIPPLE_PROTOCOL_LAZYSLE_H_INCLUDED
+
+#include <ripple/basics/contract.h>
+#include <ripple/basics/Slice.h>
+#include <ripple/protocol/SField.h>
+#include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/STBlob.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <boost/optional.hpp>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace ripple {
+
+/** A read-only ledger entry that decodes its fields on demand.
+
+    A LazySLE either refers to the serialized bytes of an entry, or
+    wraps an entry that was already deserialized. In the first case
+    nothing is parsed until a field is requested; the first request
+    records where each field starts, and each request after that
+    decodes only the one field it asks for. Variable length fields
+    are returned as slices of the original bytes.
+
+    Field access follows the rules of STObject: a missing field
+    with a default value in the entry's format reads as that
+    default, and any other missing field throws missing_field_error.
+
+    Thread Safety:
+
+        Distinct objects may be used concurrently. A single object
+        may not, since the field index is built on first use.
+*/
+class LazySLE
+{
+public:
+    /** Wrap an entry that is already deserialized. */
+    explicit
+    LazySLE (std::shared_ptr<SLE const> sle);
+
+    /** Refer to a serialized entry.
+
+        @param owner Keeps the memory that `data` points to alive.
+    */
+    LazySLE (uint256 const& key, Slice data,
+        std::shared_ptr<void const> owner);
+
+    uint256 const&
+    key() const
+    {
+        return key_;
+    }
+
+    LedgerEntryType
+    getType() const;
+
+    bool
+    isFieldPresent (SField const& field) const;
+
+    std::uint32_t
+    getFlags() const;
+
+    bool
+    isFlag (std::uint32_t f) const
+    {
+        return (getFlags() & f) == f;
+    }
+
+    /** Return the value of a field.
+
+        Throws:
+
+            missing_field_error if the field is
+            not present.
+    */
+    template <class T>
+    std::decay_t<typename T::value_type>
+    operator[] (TypedField<T> const& f) const;
+
+    /** Return the value of a field as boost::optional
+
+        @return boost::none if the field is not present.
+    */
+    template <class T>
+    boost::optional<std::decay_t<typename T::value_type>>
+    operator[] (OptionaledField<T> const& of) const;
+
+    /** Return the fully deserialized entry. */
+    std::shared_ptr<SLE const>
+    sle() const;
+
+private:
+    struct Field
+    {
+        int code;
+        Slice data;
+    };
+
+    // Returns the serialized value of a field, or nullptr
+    Slice const*
+    find (SField const& field) const;
+
+    void
+    index() const;
+
+    // Returns true if a missing field reads as its default
+    bool
+    hasDefault (SField const& field) const;
+
+    template <class T>
+    static
+    std::decay_t<typename T::value_type>
+    decode (Slice const& data, SField const& field, T const*)
+    {
+        SerialIter sit (data);
+        return T (sit, field).value();
+    }
+
+    static
+    Slice
+    decode (Slice const& data, SField const& field, STBlob const*);
+
+    std::shared_ptr<SLE const> sle_;
+    std::shared_ptr<void const> owner_;
+    Slice data_;
+    uint256 key_;
+    mutable std::vector<Field> fields_;
+    mutable LedgerEntryType type_ = ltINVALID;
+    mutable bool indexed_ = false;
+};
+
+//------------------------------------------------------------------------------
+
+template <class T>
+std::decay_t<typename T::value_type>
+LazySLE::operator[] (TypedField<T> const& f) const
+{
+    if (sle_)
+        return (*sle_)[f];
+    if (auto const data = find (f))
+        return decode (*data, f, static_cast<T const*>(nullptr));
+    if (! hasDefault (f))
+        Throw<missing_field_error> (f);
+    return std::decay_t<typename T::value_type>{};
+}
+
+template <class T>
+boost::optional<std::decay_t<typename T::value_type>>
+LazySLE::operator[] (OptionaledField<T> const& of) const
+{
+    if (sle_)
+        return (*sle_)[of];
+    if (auto const data = find (*of.f))
+        return decode (*data, *of.f, static_cast<T const*>(nullptr));
+    if (! hasDefault (*of.f))
+        return boost::none;
+    return std::decay_t<typename T::value_type>{};
+}
+
+} // ripple
+
+#endif
@@ -340,6 +340,16 @@ public:
     void set (const SOTemplate&);
     bool set (SerialIter& u, int depth = 0);
 
+    /** Deserialize straight into the layout of a template.
+
+        This is equivalent to set(sit) followed by setType(type),
+        but each field is placed in its template slot as it is
+        read, so the fields are never reordered or copied into a
+        second list. The return value has the same meaning as the
+        one from setType.
+    */
+    bool set (SOTemplate const& type, SerialIter& sit);
+
     virtual SerializedTypeID getSType () const override
     {
         return STI_OBJECT;
@@ -36,6 +36,15 @@ namespace ripple {
 
 class CKey; // forward declaration
 
+/** A growable byte buffer for serializing objects.
+
+    The storage of a Serializer is taken from a small per-thread cache
+    of buffers and handed back to it when the Serializer is destroyed,
+    so the temporaries used for hashing, signing and writing tree nodes
+    reuse memory rather than allocate it. A cached buffer is only used
+    when its capacity is at most twice the size asked for, since storage
+    moved out through modData() can end up in a long lived object.
+*/
 class Serializer
 {
 private:
@@ -45,20 +54,40 @@ private:
 public:
     explicit
     Serializer (int n = 256)
+        : mData (acquireBuffer (n))
     {
-        mData.reserve (n);
     }
 
     Serializer (void const* data,
         std::size_t size)
+        : mData (acquireBuffer (size))
     {
-        mData.resize(size);
-        std::memcpy(mData.data(),
-            reinterpret_cast<
-                unsigned char const*>(
-                    data), size);
+        auto const p = reinterpret_cast<
+            unsigned char const*>(data);
+        mData.assign (p, p + size);
     }
 
+    Serializer (Serializer const& other)
+        : mData (acquireBuffer (other.mData.size()))
+    {
+        mData.assign (other.mData.begin(), other.mData.end());
+    }
+
+    Serializer (Serializer&&) = default;
+
+    Serializer& operator= (Serializer const&) = default;
+    Serializer& operator= (Serializer&&) = default;
+
+    ~Serializer()
+    {
+        releaseBuffer (mData);
+    }
+
+    /** Buffers this thread allocated because none could be reused. */
+    static
+    std::size_t
+    buffersAllocated();
+
     Slice slice() const noexcept
     {
         return Slice(mData.data(), mData.size());
@@ -275,6 +304,9 @@ public:
     static int decodeVLLength (int b1, int b2);
     static int decodeVLLength (int b1, int b2, int b3);
 private:
+    static Blob acquireBuffer (std::size_t size);
+    static void releaseBuffer (Blob& buffer);
+
     static int lengthVL (int length)
     {
         return length + encodeLengthLength (length);
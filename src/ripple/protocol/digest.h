@@ -21,6 +21,7 @@
 #define RIPPLE_PROTOCOL_DIGEST_H_INCLUDED
 
 #include <ripple/basics/base_uint.h>
+#include <ripple/basics/Slice.h>
 #include <ripple/beast/crypto/ripemd.h>
 #include <ripple/beast/crypto/sha2.h>
 #include <ripple/beast/hash/endian.h>
@@ -274,6 +275,16 @@ sha512Half (Args const&... args)
         sha512_half_hasher::result_type>(h);
 }
 
+/** Computes the SHA512-Half of several independent messages.
+
+    On return, `hashes[i]` holds the SHA512-Half of `messages[i]`.
+    When the CPU supports AVX2, messages are hashed four at a time in
+    SIMD lanes; otherwise they are hashed one after another.
+*/
+void
+sha512HalfBatch (Slice const* messages, uint256* hashes,
+    std::size_t count);
+
 /** Returns the SHA512-Half of a series of objects.
 
     Postconditions:
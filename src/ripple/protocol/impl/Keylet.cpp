@@ -19,12 +19,25 @@
 
 #include <BeastConfig.h>
 #include <ripple/protocol/Keylet.h>
+#include <ripple/protocol/LazySLE.h>
 #include <ripple/protocol/STLedgerEntry.h>
 
 namespace ripple {
 
 bool
 Keylet::check (SLE const& sle) const
+{
+    return check (sle.getType());
+}
+
+bool
+Keylet::check (LazySLE const& sle) const
+{
+    return check (sle.getType());
+}
+
+bool
+Keylet::check (LedgerEntryType other) const
 {
     if (type == ltANY)
         return true;
@@ -32,11 +45,11 @@ Keylet::check (SLE const& sle) const
         return false;
     if (type == ltCHILD)
     {
-        assert(sle.getType() != ltDIR_NODE);
-        return sle.getType() != ltDIR_NODE;
+        assert(other != ltDIR_NODE);
+        return other != ltDIR_NODE;
     }
-    assert(sle.getType() == type);
-    return sle.getType() == type;
+    assert(other == type);
+    return other == type;
 }
 
 } // ripple
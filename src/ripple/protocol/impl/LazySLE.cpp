@@ -0,0 +1,258 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/protocol/LazySLE.h>
+#include <ripple/protocol/LedgerFormats.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STPathSet.h>
+#include <algorithm>
+
+namespace ripple {
+
+namespace detail {
+
+static
+void
+skipField (SerialIter& sit, int type);
+
+// Skips the fields of an inner object, up to and including its end marker
+static
+void
+skipObject (SerialIter& sit)
+{
+    for (;;)
+    {
+        int type;
+        int name;
+        sit.getFieldID (type, name);
+        if (type == STI_OBJECT && name == 1)
+            return;
+        skipField (sit, type);
+    }
+}
+
+static
+void
+skipField (SerialIter& sit, int type)
+{
+    switch (type)
+    {
+    case STI_UINT8:
+        sit.skip (1);
+        break;
+    case STI_UINT16:
+        sit.skip (2);
+        break;
+    case STI_UINT32:
+        sit.skip (4);
+        break;
+    case STI_UINT64:
+        sit.skip (8);
+        break;
+    case STI_HASH128:
+        sit.skip (16);
+        break;
+    case STI_HASH160:
+        sit.skip (20);
+        break;
+    case STI_HASH256:
+        sit.skip (32);
+        break;
+    case STI_AMOUNT:
+        // Non-native amounts carry a currency and an issuer
+        if (sit.get64() & STAmount::cNotNative)
+            sit.skip (40);
+        break;
+    case STI_VL:
+    case STI_ACCOUNT:
+    case STI_VECTOR256:
+        sit.skip (sit.getVLDataLength());
+        break;
+    case STI_PATHSET:
+        for (;;)
+        {
+            auto const t = sit.get8();
+            if (t == STPathElement::typeNone)
+                break;
+            if (t == STPathElement::typeBoundary)
+                continue;
+            if (t & ~STPathElement::typeAll)
+                Throw<std::runtime_error> ("bad path element");
+            if (t & STPathElement::typeAccount)
+                sit.skip (20);
+            if (t & STPathElement::typeCurrency)
+                sit.skip (20);
+            if (t & STPathElement::typeIssuer)
+                sit.skip (20);
+        }
+        break;
+    case STI_OBJECT:
+        skipObject (sit);
+        break;
+    case STI_ARRAY:
+        for (;;)
+        {
+            int t;
+            int name;
+            sit.getFieldID (t, name);
+            if (t == STI_ARRAY && name == 1)
+                break;
+            if (t != STI_OBJECT)
+                Throw<std::runtime_error> ("non-object in array");
+            skipObject (sit);
+        }
+        break;
+    default:
+        Throw<std::runtime_error> ("unknown field type " +
+            std::to_string (type));
+    }
+}
+
+} // detail
+
+//------------------------------------------------------------------------------
+
+LazySLE::LazySLE (std::shared_ptr<SLE const> sle)
+    : sle_ (std::move (sle))
+    , key_ (sle_->key())
+{
+}
+
+LazySLE::LazySLE (uint256 const& key, Slice data,
+        std::shared_ptr<void const> owner)
+    : owner_ (std::move (owner))
+    , data_ (data)
+    , key_ (key)
+{
+}
+
+LedgerEntryType
+LazySLE::getType() const
+{
+    if (sle_)
+        return sle_->getType();
+    index();
+    return type_;
+}
+
+bool
+LazySLE::isFieldPresent (SField const& field) const
+{
+    if (sle_)
+        return sle_->isFieldPresent (field);
+    return find (field) != nullptr;
+}
+
+std::uint32_t
+LazySLE::getFlags() const
+{
+    if (sle_)
+        return sle_->getFlags();
+    if (auto const data = find (sfFlags))
+        return decode (*data, sfFlags, static_cast<STUInt32 const*>(nullptr));
+    return 0;
+}
+
+std::shared_ptr<SLE const>
+LazySLE::sle() const
+{
+    if (sle_)
+        return sle_;
+    SerialIter sit (data_);
+    return std::make_shared<SLE const> (sit, key_);
+}
+
+Slice const*
+LazySLE::find (SField const& field) const
+{
+    index();
+    auto const iter = std::find_if (fields_.begin(), fields_.end(),
+        [code = field.fieldCode](Field const& f)
+        {
+            return f.code == code;
+        });
+    if (iter == fields_.end())
+        return nullptr;
+    return &iter->data;
+}
+
+void
+LazySLE::index() const
+{
+    if (indexed_)
+        return;
+
+    std::vector<Field> fields;
+    SerialIter sit (data_);
+    while (! sit.empty())
+    {
+        int type;
+        int name;
+        sit.getFieldID (type, name);
+        auto const begin = sit.getBytesLeft();
+        auto const start = data_.data() + (data_.size() - begin);
+        detail::skipField (sit, type);
+        fields.push_back ({field_code (type, name),
+            Slice (start, begin - sit.getBytesLeft())});
+    }
+
+    auto type = ltINVALID;
+    auto const iter = std::find_if (fields.begin(), fields.end(),
+        [](Field const& f)
+        {
+            return f.code == sfLedgerEntryType.fieldCode;
+        });
+    if (iter != fields.end())
+    {
+        auto const format = LedgerFormats::getInstance().findByType (
+            static_cast <LedgerEntryType> (decode (iter->data,
+                sfLedgerEntryType, static_cast<STUInt16 const*>(nullptr))));
+        if (format == nullptr)
+            Throw<std::runtime_error> ("invalid ledger entry type");
+        type = format->getType();
+    }
+
+    fields_ = std::move (fields);
+    type_ = type;
+    indexed_ = true;
+}
+
+bool
+LazySLE::hasDefault (SField const& field) const
+{
+    index();
+    auto const format =
+        LedgerFormats::getInstance().findByType (type_);
+    if (format == nullptr)
+        return false;
+    auto const& elements = format->elements;
+    return elements.getIndex (field) != -1 &&
+        elements.style (field) == SOE_DEFAULT;
+}
+
+Slice
+LazySLE::decode (Slice const& data, SField const&, STBlob const*)
+{
+    SerialIter sit (data);
+    auto const size = sit.getVLDataLength();
+    return sit.getSlice (size);
+}
+
+} // ripple
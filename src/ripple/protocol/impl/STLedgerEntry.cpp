@@ -51,6 +51,36 @@ STLedgerEntry::STLedgerEntry (
     : STObject (sfLedgerEntry)
     , key_ (index)
 {
+    // A canonically serialized entry starts with its type, which
+    // lets us deserialize straight into the layout of its format.
+    SerialIter peek (sit);
+    int type;
+    int field;
+    peek.getFieldID (type, field);
+
+    if ((type == STI_UINT16) && (field == sfLedgerEntryType.fieldValue))
+    {
+        auto const format = LedgerFormats::getInstance().findByType (
+            static_cast <LedgerEntryType> (peek.get16 ()));
+
+        if (format == nullptr)
+            Throw<std::runtime_error> ("invalid ledger entry type");
+
+        type_ = format->getType ();
+
+        if (!set (format->elements, sit))
+        {
+            if (auto j = debugLog().error())
+            {
+                j << "Ledger entry not valid for type " << format->getName ();
+                j << "Object: " << getJson (0);
+            }
+
+            Throw<std::runtime_error> ("ledger entry not valid for type");
+        }
+        return;
+    }
+
     set (sit);
     setSLEType ();
 }
@@ -24,6 +24,8 @@
 #include <ripple/protocol/STArray.h>
 #include <ripple/protocol/STBlob.h>
 #include <ripple/basics/Log.h>
+#include <boost/container/small_vector.hpp>
+#include <algorithm>
 
 namespace ripple {
 
@@ -220,6 +222,95 @@ bool STObject::set (SerialIter& sit, int depth)
     return reachedEndOfObject;
 }
 
+bool STObject::set (SOTemplate const& type, SerialIter& sit)
+{
+    bool valid = true;
+    mType = &type;
+
+    v_.clear();
+    v_.reserve(type.size());
+    for (auto const& e : type.all())
+        v_.emplace_back(detail::nonPresentObject, e->e_field);
+
+    while (!sit.empty ())
+    {
+        int fieldType;
+        int fieldName;
+
+        sit.getFieldID (fieldType, fieldName);
+
+        if ((fieldType == STI_OBJECT) && (fieldName == 1))
+            break;
+
+        if ((fieldType == STI_ARRAY) && (fieldName == 1))
+        {
+            JLOG (debugLog().error())
+                << "Encountered object with end of array marker";
+            Throw<std::runtime_error> ("Illegal terminator in object");
+        }
+
+        auto const& fn = SField::getField (fieldType, fieldName);
+
+        if (fn.isInvalid ())
+        {
+            JLOG (debugLog().error())
+                << "Unknown field: field_type=" << fieldType
+                << ", field_name=" << fieldName;
+            Throw<std::runtime_error> ("Unknown field");
+        }
+
+        detail::STVar var (sit, fn);
+
+        STObject* const obj = dynamic_cast <STObject*> (&var.get());
+        if (obj && (obj->setTypeFromSField (fn) == typeSetFail))
+        {
+            Throw<std::runtime_error> ("field deserialization error");
+        }
+
+        // Fields the template doesn't know about, and repeats of
+        // ones already seen, are dropped just as setType drops its
+        // leftovers.
+        auto const index = type.getIndex (fn);
+        if (index < 0 || v_[index]->getSType () != STI_NOTPRESENT)
+        {
+            if (! fn.isDiscardable())
+            {
+                JLOG (debugLog().error())
+                    << "setType(" << getFName().getName()
+                    << "): non-discardable leftover " << fn.getName ();
+                valid = false;
+            }
+            continue;
+        }
+
+        auto const style = type.style (fn);
+        if ((style == SOE_DEFAULT) && var->isDefault())
+        {
+            JLOG (debugLog().error())
+                << "setType(" << getFName().getName()
+                << "): explicit default " << fn.fieldName;
+            valid = false;
+        }
+        v_[index] = std::move (var);
+    }
+
+    auto iter = v_.cbegin();
+    for (auto const& e : type.all())
+    {
+        auto const& var = *iter++;
+        if ((e->flags == SOE_REQUIRED) &&
+            (var->getSType () == STI_NOTPRESENT))
+        {
+            JLOG (debugLog().error())
+                << "setType(" << getFName().getName()
+                << "): missing " << e->e_field.fieldName;
+            valid = false;
+        }
+    }
+
+    return valid;
+}
+
 bool STObject::hasMatchingEntry (const STBase& t)
 {
     const STBase* o = peekAtPField (t.getFName ());
@@ -695,22 +786,32 @@ bool STObject::operator== (const STObject& obj) const
 
 void STObject::add (Serializer& s, bool withSigningFields) const
 {
-    std::map<int, STBase const*> fields;
+    // Objects rarely have more fields than fit in the inline
+    // storage, so serializing one does not allocate.
+    boost::container::small_vector<STBase const*, 32> fields;
     for (auto const& e : v_)
     {
         // pick out the fields and sort them
         if ((e->getSType() != STI_NOTPRESENT) &&
             e->getFName().shouldInclude (withSigningFields))
         {
-            fields.insert (std::make_pair (
-                e->getFName().fieldCode, &e.get()));
+            auto const code = e->getFName().fieldCode;
+            auto const iter = std::lower_bound (
+                fields.begin(), fields.end(), code,
+                [](STBase const* field, int c)
+                {
+                    return field->getFName().fieldCode < c;
+                });
+            // Only the first of any duplicate fields is written
+            if (iter == fields.end() ||
+                    (*iter)->getFName().fieldCode != code)
+                fields.insert (iter, &e.get());
         }
     }
 
     // insert sorted
-    for (auto const& e : fields)
+    for (auto const field : fields)
     {
-        auto const field = e.second;
 
         // When we serialize an object inside another object,
         // the type associated by rule with this field name
@@ -75,11 +75,29 @@ STTx::STTx (SerialIter& sit)
     if ((length < txMinSizeBytes) || (length > txMaxSizeBytes))
         Throw<std::runtime_error> ("Transaction length invalid");
 
-    set (sit);
-    tx_type_ = static_cast<TxType> (getFieldU16 (sfTransactionType));
+    // The type is the first field of a canonically serialized
+    // transaction, which lets us deserialize straight into the
+    // layout of its format.
+    SerialIter peek (sit);
+    int type;
+    int field;
+    peek.getFieldID (type, field);
+
+    if ((type == STI_UINT16) && (field == sfTransactionType.fieldValue))
+    {
+        tx_type_ = static_cast<TxType> (peek.get16 ());
 
-    if (!setType (getTxFormat (tx_type_)->elements))
-        Throw<std::runtime_error> ("transaction not valid");
+        if (!set (getTxFormat (tx_type_)->elements, sit))
+            Throw<std::runtime_error> ("transaction not valid");
+    }
+    else
+    {
+        set (sit);
+        tx_type_ = static_cast<TxType> (getFieldU16 (sfTransactionType));
+
+        if (!setType (getTxFormat (tx_type_)->elements))
+            Throw<std::runtime_error> ("transaction not valid");
+    }
 
     tid_ = getHash(HashPrefix::transactionID);
 }
@@ -139,12 +157,12 @@ STTx::getMentionedAccounts () const
     return list;
 }
 
-static Blob getSigningData (STTx const& that)
+static Serializer getSigningData (STTx const& that)
 {
     Serializer s;
     s.add32 (HashPrefix::txSign);
     that.addWithoutSigningFields (s);
-    return s.getData();
+    return s;
 }
 
 uint256
@@ -174,7 +192,7 @@ void STTx::sign (
     auto const sig = ripple::sign (
         publicKey,
         secretKey,
-        makeSlice(data));
+        data.slice());
 
     setFieldVL (sfTxnSignature, sig);
     tid_ = getHash(HashPrefix::transactionID);
@@ -190,8 +208,8 @@ std::pair<bool, std::string> STTx::checkSign(bool allowMultiSign) const
             // Determine whether we're single- or multi-signing by looking
             // at the SigningPubKey.  It it's empty we must be
             // multi-signing.  Otherwise we're single-signing.
-            Blob const& signingPubKey = getFieldVL (sfSigningPubKey);
-            ret = signingPubKey.empty () ?
+            auto const signingPubKey = (*this)[~sfSigningPubKey];
+            ret = (! signingPubKey || signingPubKey->empty ()) ?
                 checkMultiSign () : checkSingleSign ();
         }
         else
@@ -273,17 +291,18 @@ std::pair<bool, std::string> STTx::checkSingleSign () const
     try
     {
         bool const fullyCanonical = (getFlags() & tfFullyCanonicalSig);
-        auto const spk = getFieldVL (sfSigningPubKey);
+        auto const spk = (*this)[~sfSigningPubKey].value_or (Slice ());
 
-        if (publicKeyType (makeSlice(spk)))
+        if (publicKeyType (spk))
         {
-            Blob const signature = getFieldVL (sfTxnSignature);
-            Blob const data = getSigningData (*this);
+            auto const signature =
+                (*this)[~sfTxnSignature].value_or (Slice ());
+            auto const data = getSigningData (*this);
 
             validSig = verify (
-                PublicKey (makeSlice(spk)),
-                makeSlice(data),
-                makeSlice(signature),
+                PublicKey (spk),
+                data.slice(),
+                signature,
                 fullyCanonical);
         }
     }
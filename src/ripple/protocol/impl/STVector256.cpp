@@ -28,19 +28,12 @@ namespace ripple {
 STVector256::STVector256(SerialIter& sit, SField const& name)
     : STBase(name)
 {
-    Blob data = sit.getVL ();
-    auto const count = data.size () / (256 / 8);
+    auto const data = sit.getSlice (sit.getVLDataLength ());
+    auto const count = data.size () / uint256::bytes;
     mValue.reserve (count);
-    Blob::iterator begin = data.begin ();
-    unsigned int uStart  = 0;
-    for (unsigned int i = 0; i != count; i++)
-    {
-        unsigned int uEnd = uStart + (256 / 8);
-        // This next line could be optimized to construct a default
-        // uint256 in the vector and then copy into it
-        mValue.push_back (uint256 (Blob (begin + uStart, begin + uEnd)));
-        uStart  = uEnd;
-    }
+    for (std::size_t i = 0; i != count; i++)
+        mValue.push_back (uint256::fromVoid (
+            data.data () + i * uint256::bytes));
 }
 
 void
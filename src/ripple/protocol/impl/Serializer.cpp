@@ -25,6 +25,107 @@
 
 namespace ripple {
 
+namespace detail {
+
+// Buffers released by Serializers on this thread
+struct SerializerBuffers
+{
+    // Larger buffers go back to the heap
+    static std::size_t const maxCapacity = 16 * 1024;
+    static std::size_t const maxBuffers = 16;
+
+    std::vector<Blob> free;
+    std::size_t allocated = 0;
+
+    SerializerBuffers()
+    {
+        free.reserve (maxBuffers);
+    }
+};
+
+// The cache is reached through a plain pointer so that Serializers
+// destroyed late in thread or program exit, after the cache is gone,
+// simply free their storage.
+static thread_local SerializerBuffers* serializerBuffers = nullptr;
+static thread_local bool serializerBuffersExited = false;
+
+struct SerializerBuffersOwner
+{
+    ~SerializerBuffersOwner()
+    {
+        serializerBuffersExited = true;
+        delete serializerBuffers;
+        serializerBuffers = nullptr;
+    }
+};
+
+static
+SerializerBuffers*
+localSerializerBuffers()
+{
+    if (! serializerBuffers && ! serializerBuffersExited)
+    {
+        static thread_local SerializerBuffersOwner owner;
+        serializerBuffers = new SerializerBuffers;
+    }
+    return serializerBuffers;
+}
+
+} // detail
+
+Blob Serializer::acquireBuffer (std::size_t size)
+{
+    Blob buffer;
+    auto const buffers = detail::localSerializerBuffers ();
+    if (buffers && size != 0)
+    {
+        // The storage may be moved out into a long lived object, such
+        // as a SHAMapItem or a NodeObject, so only take a buffer that
+        // is not much larger than what was asked for.
+        auto& free = buffers->free;
+        auto best = free.end ();
+        for (auto iter = free.begin (); iter != free.end (); ++iter)
+        {
+            auto const capacity = iter->capacity ();
+            if (capacity >= size && capacity <= 2 * size &&
+                    (best == free.end () || capacity < best->capacity ()))
+                best = iter;
+        }
+        if (best != free.end ())
+        {
+            buffer = std::move (*best);
+            *best = std::move (free.back ());
+            free.pop_back ();
+            buffer.clear ();
+        }
+    }
+    if (buffer.capacity () < size)
+    {
+        if (buffers)
+            ++buffers->allocated;
+        buffer.reserve (size);
+    }
+    return buffer;
+}
+
+void Serializer::releaseBuffer (Blob& buffer)
+{
+    if (buffer.capacity () == 0 ||
+            buffer.capacity () > detail::SerializerBuffers::maxCapacity)
+        return;
+    auto const buffers = detail::localSerializerBuffers ();
+    if (! buffers ||
+            buffers->free.size () == detail::SerializerBuffers::maxBuffers)
+        return;
+    buffers->free.push_back (std::move (buffer));
+}
+
+std::size_t Serializer::buffersAllocated ()
+{
+    auto const buffers = detail::localSerializerBuffers ();
+    return buffers ? buffers->allocated : 0;
+}
+
 int Serializer::addZeros (size_t uBytes)
 {
     int ret = mData.size ();
@@ -19,10 +19,21 @@
 
 #include <BeastConfig.h>
 #include <ripple/protocol/digest.h>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
 #include <type_traits>
+#include <vector>
 #include <openssl/ripemd.h>
 #include <openssl/sha.h>
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#define RIPPLE_SHA512_AVX2 1
+#include <immintrin.h>
+#else
+#define RIPPLE_SHA512_AVX2 0
+#endif
+
 namespace ripple {
 
 openssl_ripemd160_hasher::openssl_ripemd160_hasher()
@@ -113,4 +124,278 @@ openssl_sha256_hasher::operator result_type() noexcept
     return digest;
 }
 
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+#if RIPPLE_SHA512_AVX2
+
+// Round constants and initial hash value from FIPS 180-4
+static std::uint64_t const sha512K[80] =
+{
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL,
+    0xe9b5dba58189dbbcULL, 0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
+    0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL, 0xd807aa98a3030242ULL,
+    0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL,
+    0xc19bf174cf692694ULL, 0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
+    0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL, 0x2de92c6f592b0275ULL,
+    0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL,
+    0xbf597fc7beef0ee4ULL, 0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+    0x06ca6351e003826fULL, 0x142929670a0e6e70ULL, 0x27b70a8546d22ffcULL,
+    0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL,
+    0x92722c851482353bULL, 0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
+    0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL, 0xd192e819d6ef5218ULL,
+    0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL,
+    0x34b0bcb5e19b48a8ULL, 0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
+    0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL, 0x748f82ee5defb2fcULL,
+    0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL,
+    0xc67178f2e372532bULL, 0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
+    0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL, 0x06f067aa72176fbaULL,
+    0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL,
+    0x431d67c49c100d4cULL, 0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
+    0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+static std::uint64_t const sha512H0[8] =
+{
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+    0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+    0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+// A message laid out as SHA-512 input blocks. The full blocks are read
+// in place; the last one or two blocks, which carry the padding and the
+// length, are built in `tail`.
+class PaddedMessage
+{
+private:
+    std::uint8_t const* data_ = nullptr;
+    std::size_t fullBlocks_ = 0;
+    std::size_t blocks_ = 0;
+    std::uint8_t tail_[256];
+
+public:
+    void
+    reset (Slice const& message)
+    {
+        auto const size = message.size ();
+        data_ = message.data ();
+        fullBlocks_ = size / 128;
+
+        auto const rest = size % 128;
+        auto const tailSize = (rest + 17 <= 128) ? 128 : 256;
+        std::memset (tail_, 0, tailSize);
+        if (rest != 0)
+            std::memcpy (tail_, data_ + fullBlocks_ * 128, rest);
+        tail_[rest] = 0x80;
+
+        // The length in bits, as a 128-bit big endian number
+        std::uint64_t const bits = static_cast<std::uint64_t> (size) << 3;
+        for (int i = 0; i < 8; ++i)
+            tail_[tailSize - 1 - i] = static_cast<std::uint8_t> (bits >> (8 * i));
+        tail_[tailSize - 9] = static_cast<std::uint8_t> (size >> 61);
+
+        blocks_ = fullBlocks_ + tailSize / 128;
+    }
+
+    std::size_t
+    blocks () const
+    {
+        return blocks_;
+    }
+
+    std::uint64_t
+    word (std::size_t block, int i) const
+    {
+        std::uint8_t const* p = (block < fullBlocks_)
+            ? data_ + block * 128
+            : tail_ + (block - fullBlocks_) * 128;
+        std::uint64_t w;
+        std::memcpy (&w, p + 8 * i, sizeof (w));
+        return __builtin_bswap64 (w);
+    }
+};
+
+#define RIPPLE_TARGET_AVX2 __attribute__((target("avx2")))
+
+RIPPLE_TARGET_AVX2 static inline
+__m256i
+rotr (__m256i x, int n)
+{
+    return _mm256_or_si256 (
+        _mm256_srli_epi64 (x, n), _mm256_slli_epi64 (x, 64 - n));
+}
+
+RIPPLE_TARGET_AVX2 static inline
+__m256i
+add (__m256i a, __m256i b)
+{
+    return _mm256_add_epi64 (a, b);
+}
+
+RIPPLE_TARGET_AVX2 static inline
+__m256i
+xor3 (__m256i a, __m256i b, __m256i c)
+{
+    return _mm256_xor_si256 (_mm256_xor_si256 (a, b), c);
+}
+
+// Hashes four messages at once, one per 64-bit lane. Lanes whose
+// message has fewer blocks than the others keep their state once they
+// run out of input.
+RIPPLE_TARGET_AVX2 static
+void
+sha512HalfLanes (PaddedMessage const* const (&in)[4], uint256* const (&out)[4])
+{
+    std::size_t blocks = 0;
+    for (auto const m : in)
+        blocks = std::max (blocks, m->blocks ());
+
+    __m256i state[8];
+    for (int i = 0; i < 8; ++i)
+        state[i] = _mm256_set1_epi64x (sha512H0[i]);
+
+    for (std::size_t b = 0; b < blocks; ++b)
+    {
+        auto const lane = [&](int l, int i) -> long long
+        {
+            return (b < in[l]->blocks ()) ? in[l]->word (b, i) : 0;
+        };
+
+        __m256i w[80];
+        for (int i = 0; i < 16; ++i)
+            w[i] = _mm256_set_epi64x (
+                lane (3, i), lane (2, i), lane (1, i), lane (0, i));
+        for (int i = 16; i < 80; ++i)
+        {
+            auto const s0 = xor3 (rotr (w[i - 15], 1), rotr (w[i - 15], 8),
+                _mm256_srli_epi64 (w[i - 15], 7));
+            auto const s1 = xor3 (rotr (w[i - 2], 19), rotr (w[i - 2], 61),
+                _mm256_srli_epi64 (w[i - 2], 6));
+            w[i] = add (add (w[i - 16], s0), add (w[i - 7], s1));
+        }
+
+        auto a = state[0], bb = state[1], c = state[2], d = state[3];
+        auto e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int i = 0; i < 80; ++i)
+        {
+            auto const S1 = xor3 (rotr (e, 14), rotr (e, 18), rotr (e, 41));
+            auto const ch = _mm256_xor_si256 (
+                _mm256_and_si256 (e, f), _mm256_andnot_si256 (e, g));
+            auto const t1 = add (add (add (h, S1), add (ch, w[i])),
+                _mm256_set1_epi64x (sha512K[i]));
+            auto const S0 = xor3 (rotr (a, 28), rotr (a, 34), rotr (a, 39));
+            auto const maj = _mm256_or_si256 (
+                _mm256_and_si256 (a, bb),
+                _mm256_and_si256 (c, _mm256_or_si256 (a, bb)));
+            auto const t2 = add (S0, maj);
+
+            h = g;
+            g = f;
+            f = e;
+            e = add (d, t1);
+            d = c;
+            c = bb;
+            bb = a;
+            a = add (t1, t2);
+        }
+
+        auto const active = _mm256_set_epi64x (
+            (b < in[3]->blocks ()) ? -1 : 0, (b < in[2]->blocks ()) ? -1 : 0,
+            (b < in[1]->blocks ()) ? -1 : 0, (b < in[0]->blocks ()) ? -1 : 0);
+        __m256i const next[8] = { a, bb, c, d, e, f, g, h };
+        for (int i = 0; i < 8; ++i)
+            state[i] = _mm256_blendv_epi8 (
+                state[i], add (state[i], next[i]), active);
+    }
+
+    // The half digest is the first four state words, big endian
+    std::uint64_t words[4][4];
+    for (int i = 0; i < 4; ++i)
+        _mm256_storeu_si256 (reinterpret_cast<__m256i*> (words[i]), state[i]);
+    for (int l = 0; l < 4; ++l)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            auto const w = __builtin_bswap64 (words[i][l]);
+            std::memcpy (out[l]->data () + 8 * i, &w, sizeof (w));
+        }
+    }
+}
+
+#undef RIPPLE_TARGET_AVX2
+
+static
+bool
+hasAVX2 ()
+{
+    static bool const result = []
+    {
+        __builtin_cpu_init ();
+        return __builtin_cpu_supports ("avx2") != 0;
+    }();
+    return result;
+}
+
+#endif
+
+} // detail
+
+void
+sha512HalfBatch (Slice const* messages, uint256* hashes, std::size_t count)
+{
+    std::size_t done = 0;
+
+#if RIPPLE_SHA512_AVX2
+    if (count >= 4 && detail::hasAVX2 ())
+    {
+        // Lanes are busy until their longest message is done, so hash
+        // messages of similar length together.
+        std::vector<std::size_t> order (count);
+        std::iota (order.begin (), order.end (), 0);
+        std::stable_sort (order.begin (), order.end (),
+            [messages](std::size_t a, std::size_t b)
+            {
+                return messages[a].size () / 128 < messages[b].size () / 128;
+            });
+
+        detail::PaddedMessage padded[4];
+        for (; done + 4 <= count; done += 4)
+        {
+            for (int l = 0; l < 4; ++l)
+                padded[l].reset (messages[order[done + l]]);
+            detail::PaddedMessage const* const in[4] =
+                { &padded[0], &padded[1], &padded[2], &padded[3] };
+            uint256* const out[4] =
+                { &hashes[order[done]], &hashes[order[done + 1]],
+                  &hashes[order[done + 2]], &hashes[order[done + 3]] };
+            detail::sha512HalfLanes (in, out);
+        }
+
+        for (; done < count; ++done)
+        {
+            auto const i = order[done];
+            sha512_half_hasher h;
+            h (messages[i].data (), messages[i].size ());
+            hashes[i] = static_cast<sha512_half_hasher::result_type> (h);
+        }
+        return;
+    }
+#endif
+
+    for (; done < count; ++done)
+    {
+        sha512_half_hasher h;
+        h (messages[done].data (), messages[done].size ());
+        hashes[done] = static_cast<sha512_half_hasher::result_type> (h);
+    }
+}
+
 } // ripple
@@ -25,6 +25,7 @@
 #include <ripple/resource/impl/Tuning.h>
 #include <ripple/beast/clock/abstract_clock.h>
 #include <ripple/beast/core/List.h>
+#include <atomic>
 #include <cassert>
 
 namespace ripple {
@@ -46,7 +47,7 @@ struct Entry
         : refcount (0)
         , local_balance (now)
         , remote_balance (0)
-        , lastWarningTime ()
+        , lastWarningTime (0)
         , whenExpires ()
     {
     }
@@ -76,7 +77,7 @@ struct Entry
     }
 
     // Balance including remote contributions
-    int balance (clock_type::time_point const now)
+    int balance (clock_type::time_point const now) const
     {
         return local_balance.value (now) + remote_balance;
     }
@@ -91,17 +92,17 @@ struct Entry
     // Back pointer to the map key (bit of a hack here)
     Key const* key;
 
-    // Number of Consumer references
+    // Number of Consumer references, guarded by the shard's mutex
     int refcount;
 
     // Exponentially decaying balance of resource consumption
-    DecayingSample <decayWindowSeconds, clock_type> local_balance;
+    AtomicDecayingSample <decayWindowSeconds, clock_type> local_balance;
 
     // Normalized balance contribution from imports
-    int remote_balance;
+    std::atomic<int> remote_balance;
 
-    // Time of the last warning
-    clock_type::time_point lastWarningTime;
+    // Time of the last warning, as a count of clock ticks
+    std::atomic<clock_type::rep> lastWarningTime;
 
     // For inactive entries, time after which this entry will be erased
     clock_type::time_point whenExpires;
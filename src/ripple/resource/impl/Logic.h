@@ -31,6 +31,7 @@
 #include <ripple/beast/clock/abstract_clock.h>
 #include <ripple/beast/insight/Insight.h>
 #include <ripple/beast/utility/PropertyStream.h>
+#include <array>
 #include <cassert>
 #include <mutex>
 
@@ -57,34 +58,67 @@ private:
         beast::insight::Meter drop;
     };
 
-    Stats m_stats;
-    Stopwatch& m_clock;
-    beast::Journal m_journal;
+    // A part of the consumer table, chosen by the hash of the key.
+    //
+    // Only adding, removing and referencing entries takes the lock.
+    // Balances are atomic and charged without it.
+    struct Shard
+    {
+        std::mutex mutex;
+
+        // Table of the entries in this shard
+        Table table;
+
+        // Because the following are intrusive lists, a given Entry may be in
+        // at most list at a given instant.  The Entry must be removed from
+        // one list before placing it in another.
+
+        // List of all active inbound entries
+        EntryIntrusiveList inbound;
 
-    std::recursive_mutex lock_;
+        // List of all active outbound entries
+        EntryIntrusiveList outbound;
 
-    // Table of all entries
-    Table table_;
+        // List of all active admin entries
+        EntryIntrusiveList admin;
 
-    // Because the following are intrusive lists, a given Entry may be in
-    // at most list at a given instant.  The Entry must be removed from
-    // one list before placing it in another.
+        // List of all inactve entries
+        EntryIntrusiveList inactive;
 
-    // List of all active inbound entries
-    EntryIntrusiveList inbound_;
+        EntryIntrusiveList& active (Kind kind)
+        {
+            switch (kind)
+            {
+            case kindInbound:
+                return inbound;
+            case kindOutbound:
+                return outbound;
+            case kindUnlimited:
+                return admin;
+            default:
+                break;
+            }
+            assert(false);
+            return inbound;
+        }
+    };
 
-    // List of all active outbound entries
-    EntryIntrusiveList outbound_;
+    Stats m_stats;
+    Stopwatch& m_clock;
+    beast::Journal m_journal;
 
-    // List of all active admin entries
-    EntryIntrusiveList admin_;
+    std::array <Shard, consumerShards> shards_;
 
-    // List of all inactve entries
-    EntryIntrusiveList inactive_;
+    std::mutex importLock_;
 
     // All imported gossip data
     Imports importTable_;
 
+    std::mutex gossipLock_;
+
+    // Consumers to gossip about, as of the last periodic sweep
+    Gossip gossip_;
+
     //--------------------------------------------------------------------------
 public:
 
@@ -104,67 +138,28 @@ public:
         // destroyed before the consumer table.
         //
         importTable_.clear();
-        table_.clear();
+        for (auto& shard : shards_)
+            shard.table.clear();
     }
 
     Consumer newInboundEndpoint (beast::IP::Endpoint const& address)
     {
-        Entry* entry (nullptr);
-
-        {
-            std::lock_guard<std::recursive_mutex> _(lock_);
-            auto result =
-                table_.emplace (std::piecewise_construct,
-                    std::make_tuple (kindInbound, address.at_port (0)), // Key
-                    std::make_tuple (m_clock.now()));                   // Entry
-
-            entry = &result.first->second;
-            entry->key = &result.first->first;
-            ++entry->refcount;
-            if (entry->refcount == 1)
-            {
-                if (! result.second)
-                {
-                    inactive_.erase (
-                        inactive_.iterator_to (*entry));
-                }
-                inbound_.push_back (*entry);
-            }
-        }
+        Entry& entry (activate (Key (kindInbound, address.at_port (0))));
 
         JLOG(m_journal.debug()) <<
-            "New inbound endpoint " << *entry;
+            "New inbound endpoint " << entry;
 
-        return Consumer (*this, *entry);
+        return Consumer (*this, entry);
     }
 
     Consumer newOutboundEndpoint (beast::IP::Endpoint const& address)
     {
-        Entry* entry (nullptr);
-
-        {
-            std::lock_guard<std::recursive_mutex> _(lock_);
-            auto result =
-                table_.emplace (std::piecewise_construct,
-                    std::make_tuple (kindOutbound, address),            // Key
-                    std::make_tuple (m_clock.now()));                   // Entry
-
-            entry = &result.first->second;
-            entry->key = &result.first->first;
-            ++entry->refcount;
-            if (entry->refcount == 1)
-            {
-                if (! result.second)
-                    inactive_.erase (
-                        inactive_.iterator_to (*entry));
-                outbound_.push_back (*entry);
-            }
-        }
+        Entry& entry (activate (Key (kindOutbound, address)));
 
         JLOG(m_journal.debug()) <<
-            "New outbound endpoint " << *entry;
+            "New outbound endpoint " << entry;
 
-        return Consumer (*this, *entry);
+        return Consumer (*this, entry);
     }
 
     /**
@@ -174,31 +169,12 @@ public:
      */
     Consumer newUnlimitedEndpoint (std::string const& name)
     {
-        Entry* entry (nullptr);
-
-        {
-            std::lock_guard<std::recursive_mutex> _(lock_);
-            auto result =
-                table_.emplace (std::piecewise_construct,
-                    std::make_tuple (name),                             // Key
-                    std::make_tuple (m_clock.now()));                   // Entry
-
-            entry = &result.first->second;
-            entry->key = &result.first->first;
-            ++entry->refcount;
-            if (entry->refcount == 1)
-            {
-                if (! result.second)
-                    inactive_.erase (
-                        inactive_.iterator_to (*entry));
-                admin_.push_back (*entry);
-            }
-        }
+        Entry& entry (activate (Key (name)));
 
         JLOG(m_journal.debug()) <<
-            "New unlimited endpoint " << *entry;
+            "New unlimited endpoint " << entry;
 
-        return Consumer (*this, *entry);
+        return Consumer (*this, entry);
     }
 
     Json::Value getJson ()
@@ -212,69 +188,39 @@ public:
         clock_type::time_point const now (m_clock.now());
 
         Json::Value ret (Json::objectValue);
-        std::lock_guard<std::recursive_mutex> _(lock_);
-
-        for (auto& inboundEntry : inbound_)
-        {
-            int localBalance = inboundEntry.local_balance.value (now);
-            if ((localBalance + inboundEntry.remote_balance) >= threshold)
-            {
-                Json::Value& entry = (ret[inboundEntry.to_string()] = Json::objectValue);
-                entry[jss::local] = localBalance;
-                entry[jss::remote] = inboundEntry.remote_balance;
-                entry[jss::type] = "inbound";
-            }
 
-        }
-        for (auto& outboundEntry : outbound_)
+        auto const add = [&](EntryIntrusiveList const& list, char const* type)
         {
-            int localBalance = outboundEntry.local_balance.value (now);
-            if ((localBalance + outboundEntry.remote_balance) >= threshold)
+            for (auto const& listEntry : list)
             {
-                Json::Value& entry = (ret[outboundEntry.to_string()] = Json::objectValue);
-                entry[jss::local] = localBalance;
-                entry[jss::remote] = outboundEntry.remote_balance;
-                entry[jss::type] = "outbound";
+                int localBalance = listEntry.local_balance.value (now);
+                int remoteBalance = listEntry.remote_balance;
+                if ((localBalance + remoteBalance) >= threshold)
+                {
+                    Json::Value& entry = (ret[listEntry.to_string()] = Json::objectValue);
+                    entry[jss::local] = localBalance;
+                    entry[jss::remote] = remoteBalance;
+                    entry[jss::type] = type;
+                }
             }
+        };
 
-        }
-        for (auto& adminEntry : admin_)
+        for (auto& shard : shards_)
         {
-            int localBalance = adminEntry.local_balance.value (now);
-            if ((localBalance + adminEntry.remote_balance) >= threshold)
-            {
-                Json::Value& entry = (ret[adminEntry.to_string()] = Json::objectValue);
-                entry[jss::local] = localBalance;
-                entry[jss::remote] = adminEntry.remote_balance;
-                entry[jss::type] = "admin";
-            }
-
+            std::lock_guard<std::mutex> _(shard.mutex);
+            add (shard.inbound, "inbound");
+            add (shard.outbound, "outbound");
+            add (shard.admin, "admin");
         }
 
         return ret;
     }
 
+    /** Returns the consumers found by the last periodic sweep. */
     Gossip exportConsumers ()
     {
-        clock_type::time_point const now (m_clock.now());
-
-        Gossip gossip;
-        std::lock_guard<std::recursive_mutex> _(lock_);
-
-        gossip.items.reserve (inbound_.size());
-
-        for (auto& inboundEntry : inbound_)
-        {
-            Gossip::Item item;
-            item.balance = inboundEntry.local_balance.value (now);
-            if (item.balance >= minimumGossipBalance)
-            {
-                item.address = inboundEntry.key->address;
-                gossip.items.push_back (item);
-            }
-        }
-
-        return gossip;
+        std::lock_guard<std::mutex> _(gossipLock_);
+        return gossip_;
     }
 
     //--------------------------------------------------------------------------
@@ -283,7 +229,7 @@ public:
     {
         auto const elapsed = m_clock.now();
         {
-            std::lock_guard<std::recursive_mutex> _(lock_);
+            std::lock_guard<std::mutex> _(importLock_);
             auto result =
                 importTable_.emplace (std::piecewise_construct,
                     std::make_tuple(origin),                  // Key
@@ -335,47 +281,72 @@ public:
 
     //--------------------------------------------------------------------------
 
-    // Called periodically to expire entries and groom the table.
+    // Called periodically to expire entries and groom the table,
+    // and to collect the consumers to gossip about.
     //
     void periodicActivity ()
     {
-        std::lock_guard<std::recursive_mutex> _(lock_);
-
         auto const elapsed = m_clock.now();
 
-        for (auto iter (inactive_.begin()); iter != inactive_.end();)
+        for (auto& shard : shards_)
         {
-            if (iter->whenExpires <= elapsed)
+            std::lock_guard<std::mutex> _(shard.mutex);
+            for (auto iter (shard.inactive.begin()); iter != shard.inactive.end();)
             {
-                JLOG(m_journal.debug()) << "Expired " << *iter;
-                auto table_iter =
-                    table_.find (*iter->key);
-                ++iter;
-                erase (table_iter);
+                if (iter->whenExpires <= elapsed)
+                {
+                    JLOG(m_journal.debug()) << "Expired " << *iter;
+                    auto table_iter =
+                        shard.table.find (*iter->key);
+                    ++iter;
+                    erase (shard, table_iter);
+                }
+                else
+                {
+                    break;
+                }
             }
-            else
+        }
+
+        {
+            std::lock_guard<std::mutex> _(importLock_);
+            auto iter = importTable_.begin();
+            while (iter != importTable_.end())
             {
-                break;
+                Import& import (iter->second);
+                if (iter->second.whenExpires <= elapsed)
+                {
+                    for (auto item_iter (import.items.begin());
+                        item_iter != import.items.end(); ++item_iter)
+                    {
+                        item_iter->consumer.entry().remote_balance -= item_iter->balance;
+                    }
+
+                    iter = importTable_.erase (iter);
+                }
+                else
+                    ++iter;
             }
         }
 
-        auto iter = importTable_.begin();
-        while (iter != importTable_.end())
+        Gossip gossip;
+        for (auto& shard : shards_)
         {
-            Import& import (iter->second);
-            if (iter->second.whenExpires <= elapsed)
+            std::lock_guard<std::mutex> _(shard.mutex);
+            for (auto& inboundEntry : shard.inbound)
             {
-                for (auto item_iter (import.items.begin());
-                    item_iter != import.items.end(); ++item_iter)
+                Gossip::Item item;
+                item.balance = inboundEntry.local_balance.value (elapsed);
+                if (item.balance >= minimumGossipBalance)
                 {
-                    item_iter->consumer.entry().remote_balance -= item_iter->balance;
+                    item.address = inboundEntry.key->address;
+                    gossip.items.push_back (item);
                 }
-
-                iter = importTable_.erase (iter);
             }
-            else
-                ++iter;
         }
+
+        std::lock_guard<std::mutex> _(gossipLock_);
+        std::swap (gossip_, gossip);
     }
 
     //--------------------------------------------------------------------------
@@ -392,56 +363,31 @@ public:
         return Disposition::ok;
     }
 
-    void erase (Table::iterator iter)
-    {
-        std::lock_guard<std::recursive_mutex> _(lock_);
-        Entry& entry (iter->second);
-        assert (entry.refcount == 0);
-        inactive_.erase (
-            inactive_.iterator_to (entry));
-        table_.erase (iter);
-    }
-
     void acquire (Entry& entry)
     {
-        std::lock_guard<std::recursive_mutex> _(lock_);
+        auto& shard (shardFor (*entry.key));
+        std::lock_guard<std::mutex> _(shard.mutex);
         ++entry.refcount;
     }
 
     void release (Entry& entry)
     {
-        std::lock_guard<std::recursive_mutex> _(lock_);
+        auto& shard (shardFor (*entry.key));
+        std::lock_guard<std::mutex> _(shard.mutex);
         if (--entry.refcount == 0)
         {
             JLOG(m_journal.debug()) <<
                 "Inactive " << entry;
 
-            switch (entry.key->kind)
-            {
-            case kindInbound:
-                inbound_.erase (
-                    inbound_.iterator_to (entry));
-                break;
-            case kindOutbound:
-                outbound_.erase (
-                    outbound_.iterator_to (entry));
-                break;
-            case kindUnlimited:
-                admin_.erase (
-                    admin_.iterator_to (entry));
-                break;
-            default:
-                assert(false);
-                break;
-            }
-            inactive_.push_back (entry);
+            auto& list (shard.active (entry.key->kind));
+            list.erase (list.iterator_to (entry));
+            shard.inactive.push_back (entry);
             entry.whenExpires = m_clock.now() + secondsUntilExpiration;
         }
     }
 
     Disposition charge (Entry& entry, Charge const& fee)
     {
-        std::lock_guard<std::recursive_mutex> _(lock_);
         clock_type::time_point const now (m_clock.now());
         int const balance (entry.add (fee.cost(), now));
         JLOG(m_journal.trace()) <<
@@ -454,22 +400,21 @@ public:
         if (entry.isUnlimited())
             return false;
 
-        std::lock_guard<std::recursive_mutex> _(lock_);
-        bool notify (false);
         auto const elapsed = m_clock.now();
-        if (entry.balance (m_clock.now()) >= warningThreshold &&
-            elapsed != entry.lastWarningTime)
-        {
-            charge (entry, feeWarning);
-            notify = true;
-            entry.lastWarningTime = elapsed;
-        }
-        if (notify)
-        {
-            JLOG(m_journal.info()) << "Load warning: " << entry;
-            ++m_stats.warn;
-        }
-        return notify;
+        if (entry.balance (elapsed) < warningThreshold)
+            return false;
+
+        // Warn at most once per clock tick, even from several threads
+        auto const when = elapsed.time_since_epoch().count();
+        auto last = entry.lastWarningTime.load();
+        if (last == when ||
+            ! entry.lastWarningTime.compare_exchange_strong (last, when))
+            return false;
+
+        charge (entry, feeWarning);
+        JLOG(m_journal.info()) << "Load warning: " << entry;
+        ++m_stats.warn;
+        return true;
     }
 
     bool disconnect (Entry& entry)
@@ -477,7 +422,6 @@ public:
         if (entry.isUnlimited())
             return false;
 
-        std::lock_guard<std::recursive_mutex> _(lock_);
         bool drop (false);
         clock_type::time_point const now (m_clock.now());
         int const balance (entry.balance (now));
@@ -500,7 +444,6 @@ public:
 
     int balance (Entry& entry)
     {
-        std::lock_guard<std::recursive_mutex> _(lock_);
         return entry.balance (m_clock.now());
     }
 
@@ -519,7 +462,7 @@ public:
             item ["name"] = entry.to_string();
             item ["balance"] = entry.balance(now);
             if (entry.remote_balance != 0)
-                item ["remote_balance"] = entry.remote_balance;
+                item ["remote_balance"] = entry.remote_balance.load();
         }
     }
 
@@ -527,27 +470,64 @@ public:
     {
         clock_type::time_point const now (m_clock.now());
 
-        std::lock_guard<std::recursive_mutex> _(lock_);
-
+        auto const write = [&](char const* name,
+            EntryIntrusiveList Shard::* list)
         {
-            beast::PropertyStream::Set s ("inbound", map);
-            writeList (now, s, inbound_);
-        }
+            beast::PropertyStream::Set s (name, map);
+            for (auto& shard : shards_)
+            {
+                std::lock_guard<std::mutex> _(shard.mutex);
+                writeList (now, s, shard.*list);
+            }
+        };
 
-        {
-            beast::PropertyStream::Set s ("outbound", map);
-            writeList (now, s, outbound_);
-        }
+        write ("inbound", &Shard::inbound);
+        write ("outbound", &Shard::outbound);
+        write ("admin", &Shard::admin);
+        write ("inactive", &Shard::inactive);
+    }
 
-        {
-            beast::PropertyStream::Set s ("admin", map);
-            writeList (now, s, admin_);
-        }
+private:
+    Shard& shardFor (Key const& key)
+    {
+        return shards_[Key::hasher{}(key) % shards_.size()];
+    }
 
+    // Returns the entry for a key with a new reference to it
+    Entry& activate (Key const& key)
+    {
+        auto& shard (shardFor (key));
+        std::lock_guard<std::mutex> _(shard.mutex);
+        auto result =
+            shard.table.emplace (std::piecewise_construct,
+                std::make_tuple (key),                                  // Key
+                std::make_tuple (m_clock.now()));                       // Entry
+
+        // The key is read without the lock, so it is set only once
+        Entry& entry (result.first->second);
+        if (result.second)
+            entry.key = &result.first->first;
+        ++entry.refcount;
+        if (entry.refcount == 1)
         {
-            beast::PropertyStream::Set s ("inactive", map);
-            writeList (now, s, inactive_);
+            if (! result.second)
+            {
+                shard.inactive.erase (
+                    shard.inactive.iterator_to (entry));
+            }
+            shard.active (key.kind).push_back (entry);
         }
+        return entry;
+    }
+
+    // Called with the shard's mutex held
+    void erase (Shard& shard, Table::iterator iter)
+    {
+        Entry& entry (iter->second);
+        assert (entry.refcount == 0);
+        shard.inactive.erase (
+            shard.inactive.iterator_to (entry));
+        shard.table.erase (iter);
     }
 };
 
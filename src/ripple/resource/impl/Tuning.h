@@ -40,6 +40,9 @@ enum
 
     // The minimum balance required in order to include a load source in gossip
     ,minimumGossipBalance       = 100
+
+    // The number of independently locked parts of the consumer table
+    ,consumerShards             = 16
 };
 
 // The number of seconds until an inactive table item is removed
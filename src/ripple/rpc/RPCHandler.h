@@ -33,6 +33,19 @@ struct Context;
 /** Execute an RPC command and store the results in a Json::Value. */
 Status doCommand (RPC::Context&, Json::Value&);
 
+/** Answer an RPC command from the response cache, without executing it.
+
+    @return `true` if the Json::Value was set from the cache.
+*/
+bool fetchCachedCommand (RPC::Context&, Json::Value&);
+
+/** Execute an RPC command without first looking in the response cache.
+
+    The answer is still added to the cache. doCommand is the same as
+    fetchCachedCommand followed, if that fails, by doUncachedCommand.
+*/
+Status doUncachedCommand (RPC::Context&, Json::Value&);
+
 Role roleRequired (std::string const& method );
 
 } // RPC
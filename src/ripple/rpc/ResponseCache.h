@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_RPC_RESPONSECACHE_H_INCLUDED
+#define RIPPLE_RPC_RESPONSECACHE_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <ripple/beast/insight/Collector.h>
+#include <boost/optional.hpp>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ripple {
+namespace RPC {
+
+struct Context;
+
+/** Remembers responses to read only requests against validated ledgers.
+
+    A request that names a validated ledger, by hash, by sequence or
+    as "validated", always gets the same answer, as does a request for
+    a transaction that is in a validated ledger. The responses to such
+    requests are kept serialized, up to a limit on their total size,
+    with the least recently used ones dropped first.
+
+    Thread Safety:
+
+        May be called concurrently.
+*/
+class ResponseCache
+{
+public:
+    ResponseCache (std::size_t maxBytes,
+        beast::insight::Collector::ptr const& collector);
+
+    ResponseCache (ResponseCache const&) = delete;
+    ResponseCache& operator= (ResponseCache const&) = delete;
+
+    /** Return the key for a request, if its response may be cached.
+
+        The key is made of the method, the role, the hash of the ledger
+        and all of the parameters except the request id.
+    */
+    static
+    boost::optional<std::string>
+    key (Context const& context);
+
+    /** Look up the response to a request.
+
+        @return `true` if `result` was set from the cache.
+    */
+    bool
+    fetch (std::string const& key, Json::Value& result);
+
+    /** Remember the response to a request.
+
+        Errors, and responses about ledgers that are not validated,
+        are not kept.
+    */
+    void
+    insert (std::string const& key, Json::Value const& result);
+
+    /** Drop every response. */
+    void
+    clear();
+
+    Json::Value
+    getJson() const;
+
+private:
+    using list_type = std::list<std::pair<std::string, std::string>>;
+
+    // Called with the mutex held
+    void
+    trim();
+
+    std::size_t const maxBytes_;
+    beast::insight::Counter hitCounter_;
+    beast::insight::Counter missCounter_;
+
+    std::atomic<std::uint64_t> hits_ {0};
+    std::atomic<std::uint64_t> misses_ {0};
+
+    mutable std::mutex mutex_;
+    // Most recently used first
+    list_type list_;
+    std::unordered_map<std::string, list_type::iterator> map_;
+    std::size_t bytes_ = 0;
+};
+
+} // RPC
+} // ripple
+
+#endif
@@ -22,6 +22,7 @@
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/main/CollectorManager.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/basics/UptimeTimer.h>
 #include <ripple/core/DatabaseCon.h>
@@ -102,8 +103,28 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::historical_perminute] = static_cast<int>(
         context.app.getInboundLedgers().fetchRate());
     ret[jss::SLE_hit_rate] = context.app.cachedSLEs().rate();
+    {
+        auto const sles = context.app.cachedSLEs().getStats ();
+        ret[jss::SLE_cache_size] = static_cast<Json::UInt> (sles.size);
+        ret[jss::SLE_cache_evicted] = std::to_string (sles.evicted);
+        ret[jss::SLE_cache_contended] = std::to_string (sles.contended);
+        ret[jss::SLE_view_hits] = std::to_string (sles.viewHits);
+    }
     ret[jss::node_hit_rate] = context.app.getNodeStore ().getCacheHitRate ();
     ret[jss::ledger_hit_rate] = context.app.getLedgerMaster ().getCacheHitRate ();
+    {
+        auto const seqs = context.app.getLedgerMaster ().getSeqLookupStats ();
+        ret[jss::ledger_history_hits] = std::to_string (seqs.hits);
+        ret[jss::ledger_history_misses] = std::to_string (seqs.misses);
+    }
+    {
+        auto const reads = context.app.getLedgerMaster ().getReadStats ();
+        ret[jss::ledger_reads] = std::to_string (reads.reads);
+        ret[jss::ledger_read_wait_us] =
+            std::to_string (reads.totalWait.count ());
+        ret[jss::ledger_read_max_wait_us] =
+            std::to_string (reads.maxWait.count ());
+    }
     ret[jss::AL_hit_rate] = context.app.getAcceptedLedgerCache ().getHitRate ();
 
     ret[jss::fullbelow_size] = static_cast<int>(context.app.family().fullbelow().size());
@@ -124,6 +145,16 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::node_reads_hit] = context.app.getNodeStore().getFetchHitCount();
     ret[jss::node_written_bytes] = context.app.getNodeStore().getStoreSize();
     ret[jss::node_read_bytes] = context.app.getNodeStore().getFetchSize();
+    ret[jss::node_writes_duplicate] =
+        context.app.getNodeStore().getStoreDuplicateCount();
+    ret[jss::node_reads_filtered] =
+        context.app.getNodeStore().getFetchFilteredCount();
+
+    ret[jss::log_messages_dropped] = std::to_string (
+        context.app.logs().dropped());
+
+    ret[jss::histograms] = getHistogramJson (
+        *context.app.getCollectorManager().collector(), true);
 
     return ret;
 }
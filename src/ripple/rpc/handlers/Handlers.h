@@ -61,6 +61,8 @@ Json::Value doPathFind              (RPC::Context&);
 Json::Value doPeers                 (RPC::Context&);
 Json::Value doPing                  (RPC::Context&);
 Json::Value doPrint                 (RPC::Context&);
+Json::Value doRPCCache              (RPC::Context&);
+Json::Value doRPCCosts              (RPC::Context&);
 Json::Value doRandom                (RPC::Context&);
 Json::Value doRipplePathFind        (RPC::Context&);
 Json::Value doServerInfo            (RPC::Context&); // for humans
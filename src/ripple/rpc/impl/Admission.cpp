@@ -0,0 +1,284 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/rpc/impl/Admission.h>
+#include <ripple/basics/Log.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/rpc/RPCHandler.h>
+#include <ripple/rpc/Role.h>
+#include <ripple/rpc/impl/RPCHelpers.h>
+#include <ripple/rpc/impl/Tuning.h>
+#include <set>
+
+namespace ripple {
+namespace RPC {
+
+namespace {
+
+// How many requests for each expensive method may run at once
+struct Limit
+{
+    char const* method;
+    int running;
+};
+
+Limit const limits[] {
+    {   "account_lines",        8   },
+    {   "account_objects",      8   },
+    {   "account_offers",       8   },
+    {   "account_tx",           4   },
+    {   "book_offers",          8   },
+    {   "gateway_balances",     4   },
+    {   "ledger",               8   },
+    {   "ledger_data",          4   },
+    {   "noripple_check",       4   },
+    {   "path_find",            2   },
+    {   "ripple_path_find",     2   },
+    {   "tx_history",           4   },
+};
+
+// Resumes a suspended coroutine
+void
+wake (std::shared_ptr<JobQueue::Coro> const& coro)
+{
+    // If the JobQueue is stopping, finish the coroutine on this
+    // thread. Otherwise the application would hang on shutdown.
+    if (! coro->post())
+        coro->resume();
+}
+
+} // namespace
+
+boost::optional<std::string>
+coalesceKey (Context const& context)
+{
+    static std::set<std::string> const methods {
+        "account_channels",
+        "account_currencies",
+        "account_info",
+        "account_lines",
+        "account_objects",
+        "account_offers",
+        "book_offers",
+        "gateway_balances",
+        "ledger",
+        "ledger_data",
+        "ledger_entry",
+        "ledger_header",
+        "noripple_check",
+    };
+
+    auto const& params = context.params;
+    if (! params.isObject() || ! params[jss::command].isString())
+        return boost::none;
+    auto const method = params[jss::command].asString();
+    if (methods.count (method) == 0)
+        return boost::none;
+
+    auto const ledger = fixedLedger (params, context.ledgerMaster);
+    if (! ledger)
+        return boost::none;
+    return requestKey (context, *ledger);
+}
+
+//------------------------------------------------------------------------------
+
+Admission::Admission (JobQueue& jobQueue,
+    beast::insight::Collector::ptr const& collector,
+        beast::Journal journal)
+    : jobQueue_ (jobQueue)
+    , j_ (journal)
+    , coalescedCounter_ (collector->make_counter ("coalesced"))
+    , queuedCounter_ (collector->make_counter ("queued"))
+    , shedCounter_ (collector->make_counter ("shed"))
+{
+    for (auto const& limit : limits)
+        slots_[limit.method].limit = limit.running;
+}
+
+void
+Admission::run (Context& context,
+    std::function<void(Json::Value&)> const& execute,
+        Json::Value& result)
+{
+    auto const& coro = context.coro;
+    assert (coro);
+
+    Slots* slots = nullptr;
+    if (! isUnlimited (context.role) && context.params[jss::command].isString())
+    {
+        auto const iter = slots_.find (
+            context.params[jss::command].asString());
+        if (iter != slots_.end())
+            slots = &iter->second;
+    }
+
+    auto const key = coalesceKey (context);
+    if (key)
+    {
+        if (auto const flight = join (*key, coro))
+        {
+            // An identical request is already under way
+            ++coalesced_;
+            ++coalescedCounter_;
+            coro->yield();
+
+            result = flight->result;
+            context.loadType = *flight->loadType;
+            return;
+        }
+    }
+
+    if (slots && ! acquire (*slots, context))
+    {
+        ++shed_;
+        ++shedCounter_;
+        inject_error (rpcTOO_BUSY, result);
+        if (key)
+            land (*key, result, context.loadType);
+        return;
+    }
+
+    try
+    {
+        execute (result);
+    }
+    catch (...)
+    {
+        if (slots)
+            release (*slots);
+        if (key)
+        {
+            Json::Value error;
+            inject_error (rpcINTERNAL, error);
+            land (*key, error, context.loadType);
+        }
+        throw;
+    }
+
+    if (slots)
+        release (*slots);
+    if (key)
+        land (*key, result, context.loadType);
+}
+
+void
+Admission::doCommand (Context& context, Json::Value& result)
+{
+    // A cached answer costs next to nothing, so it is never queued
+    // behind expensive requests or refused
+    if (RPC::fetchCachedCommand (context, result))
+        return;
+
+    run (context,
+        [&context](Json::Value& r)
+        {
+            RPC::doUncachedCommand (context, r);
+        }, result);
+}
+
+bool
+Admission::acquire (Slots& slots, Context& context)
+{
+    // Refuse expensive work well before the job queue is full
+    auto const jobs = jobQueue_.getJobCountGE (jtCLIENT);
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (jobs > Tuning::maxJobQueueClientsExpensive ||
+            slots.waiting.size() >= static_cast<std::size_t> (
+                Tuning::maxQueuedPerSlot * slots.limit))
+        {
+            JLOG (j_.debug()) << "Too busy for " <<
+                context.params[jss::command].asString() << ": " <<
+                    slots.waiting.size() << " waiting, " << jobs << " jobs";
+            return false;
+        }
+
+        if (slots.running < slots.limit)
+        {
+            ++slots.running;
+            return true;
+        }
+
+        slots.waiting.push_back (context.coro);
+    }
+
+    // The request that frees a slot hands it to us
+    ++queued_;
+    ++queuedCounter_;
+    context.coro->yield();
+    return true;
+}
+
+void
+Admission::release (Slots& slots)
+{
+    std::shared_ptr<JobQueue::Coro> next;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (slots.waiting.empty())
+        {
+            --slots.running;
+            return;
+        }
+        next = std::move (slots.waiting.front());
+        slots.waiting.pop_front();
+    }
+    wake (next);
+}
+
+std::shared_ptr<Admission::Flight>
+Admission::join (std::string const& key,
+    std::shared_ptr<JobQueue::Coro> const& coro)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto& flight = flights_[key];
+    if (! flight)
+    {
+        flight = std::make_shared<Flight>();
+        return nullptr;
+    }
+    flight->waiters.push_back (coro);
+    return flight;
+}
+
+void
+Admission::land (std::string const& key, Json::Value const& result,
+    Resource::Charge const& loadType)
+{
+    std::shared_ptr<Flight> flight;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        auto const iter = flights_.find (key);
+        assert (iter != flights_.end());
+        flight = std::move (iter->second);
+        flights_.erase (iter);
+    }
+
+    // No one can join the flight now
+    flight->result = result;
+    flight->loadType = loadType;
+    for (auto const& waiter : flight->waiters)
+        wake (waiter);
+}
+
+} // RPC
+} // ripple
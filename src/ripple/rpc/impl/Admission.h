@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_RPC_ADMISSION_H_INCLUDED
+#define RIPPLE_RPC_ADMISSION_H_INCLUDED
+
+#include <ripple/core/JobQueue.h>
+#include <ripple/json/json_value.h>
+#include <ripple/resource/Charge.h>
+#include <ripple/rpc/Context.h>
+#include <ripple/beast/insight/Collector.h>
+#include <ripple/beast/utility/Journal.h>
+#include <boost/optional.hpp>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace RPC {
+
+/** Decides when client commands run.
+
+    Expensive methods may only run a few at a time. A request for one
+    of them waits, with its coroutine suspended, until an earlier one
+    finishes; if too many are already waiting, or the job queue is
+    filling up with client requests, it is refused with rpcTOO_BUSY.
+    Other methods run at once. Admin requests are never held back.
+
+    Read only requests that name a ledger which can no longer change
+    are coalesced: while one is running, identical requests wait for
+    it and are all answered with its result.
+
+    Thread Safety:
+
+        May be called concurrently.
+*/
+class Admission
+{
+public:
+    Admission (JobQueue& jobQueue,
+        beast::insight::Collector::ptr const& collector,
+            beast::Journal journal);
+
+    Admission (Admission const&) = delete;
+    Admission& operator= (Admission const&) = delete;
+
+    /** Run a request, unless it is refused.
+
+        Must be called from the coroutine in `context.coro`, which may
+        be suspended while the request waits.
+
+        @param execute Produces the result of the request.
+        @param result Receives the result, or the error if the request
+                      was refused.
+    */
+    void
+    run (Context& context,
+        std::function<void(Json::Value&)> const& execute,
+            Json::Value& result);
+
+    /** Run RPC::doCommand for a request, unless it is refused.
+
+        A request answered from the response cache is never refused.
+    */
+    void
+    doCommand (Context& context, Json::Value& result);
+
+    /** The number of requests answered with another's result. */
+    std::uint64_t
+    coalesced() const
+    {
+        return coalesced_;
+    }
+
+    /** The number of requests that waited for an expensive method. */
+    std::uint64_t
+    queued() const
+    {
+        return queued_;
+    }
+
+    /** The number of requests refused. */
+    std::uint64_t
+    shed() const
+    {
+        return shed_;
+    }
+
+private:
+    // Requests for one expensive method
+    struct Slots
+    {
+        int limit;
+        int running = 0;
+        std::deque<std::shared_ptr<JobQueue::Coro>> waiting;
+    };
+
+    // An executing request and the identical requests waiting for it
+    struct Flight
+    {
+        std::vector<std::shared_ptr<JobQueue::Coro>> waiters;
+        Json::Value result;
+        boost::optional<Resource::Charge> loadType;
+    };
+
+    // Returns false if the request is refused
+    bool
+    acquire (Slots& slots, Context& context);
+
+    void
+    release (Slots& slots);
+
+    // Returns the flight to wait for, or nullptr if this request
+    // now leads a new flight
+    std::shared_ptr<Flight>
+    join (std::string const& key,
+        std::shared_ptr<JobQueue::Coro> const& coro);
+
+    void
+    land (std::string const& key, Json::Value const& result,
+        Resource::Charge const& loadType);
+
+    JobQueue& jobQueue_;
+    beast::Journal j_;
+    beast::insight::Counter coalescedCounter_;
+    beast::insight::Counter queuedCounter_;
+    beast::insight::Counter shedCounter_;
+
+    std::atomic<std::uint64_t> coalesced_ {0};
+    std::atomic<std::uint64_t> queued_ {0};
+    std::atomic<std::uint64_t> shed_ {0};
+
+    std::mutex mutex_;
+    std::map<std::string, Slots> slots_;
+    std::map<std::string, std::shared_ptr<Flight>> flights_;
+};
+
+/** Return a key shared by requests that must produce the same result.
+
+    Only read only methods asking about a ledger that can no longer
+    change have a key. The key is made of the method, the role, the
+    ledger and all of the parameters except the request id.
+*/
+boost::optional<std::string>
+coalesceKey (Context const& context);
+
+} // RPC
+} // ripple
+
+#endif
@@ -138,6 +138,8 @@ Handler handlerArray[] {
 //      {   "profile",              byRef (&doProfile),             Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "random",               byRef (&doRandom),              Role::USER,  NO_CONDITION     },
     {   "ripple_path_find",     byRef (&doRipplePathFind),      Role::USER,  NO_CONDITION  },
+    {   "rpc_cache",            byRef (&doRPCCache),            Role::ADMIN,   NO_CONDITION     },
+    {   "rpc_costs",            byRef (&doRPCCosts),            Role::ADMIN,   NO_CONDITION     },
     {   "sign",                 byRef (&doSign),                Role::USER,  NO_CONDITION     },
     {   "sign_for",             byRef (&doSignFor),             Role::USER,  NO_CONDITION     },
     {   "submit",               byRef (&doSubmit),              Role::USER,  NEEDS_CURRENT_LEDGER  },
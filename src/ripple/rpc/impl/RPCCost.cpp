@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/rpc/impl/RPCCost.h>
+#include <ripple/protocol/JsonFields.h>
+#include <algorithm>
+#include <limits>
+
+namespace ripple {
+namespace RPC {
+
+MethodCosts::Entry::Entry (std::string const& method)
+    : cpu (method + "_cpu")
+    , fetches (method + "_fetches")
+    , allocated (method + "_allocated")
+{
+}
+
+MethodCosts&
+MethodCosts::instance()
+{
+    static MethodCosts costs;
+    return costs;
+}
+
+void
+MethodCosts::record (std::string const& method, ThreadUsage const& usage)
+{
+    Entry* entry;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        auto& e = entries_[method];
+        if (! e)
+            e = std::make_unique<Entry> (method);
+        entry = e.get();
+    }
+
+    // Entries are never removed, so this is safe without the lock
+    using namespace std::chrono;
+    auto const us = duration_cast<microseconds> (usage.cpu).count();
+    entry->cpu.record (us > 0 ? us : 0);
+    entry->fetches.record (usage.fetches);
+    entry->allocated.record (usage.allocated);
+}
+
+static
+Json::Value
+toJson (beast::insight::HistogramSnapshot const& h)
+{
+    Json::Value ret (Json::objectValue);
+    ret[jss::mean] = std::to_string (h.mean());
+    ret[jss::p50] = std::to_string (h.percentile (0.5));
+    ret[jss::p90] = std::to_string (h.percentile (0.9));
+    ret[jss::p99] = std::to_string (h.percentile (0.99));
+    ret[jss::max] = std::to_string (h.max);
+    return ret;
+}
+
+Json::Value
+MethodCosts::getJson() const
+{
+    Json::Value ret (Json::objectValue);
+    std::lock_guard<std::mutex> lock (mutex_);
+    for (auto const& e : entries_)
+    {
+        auto const cpu = e.second->cpu.snapshot();
+        Json::Value& entry = ret[e.first] = Json::objectValue;
+        entry[jss::count] = std::to_string (cpu.count);
+        entry[jss::cpu_us] = toJson (cpu);
+        entry[jss::fetches] = toJson (e.second->fetches.snapshot());
+        entry[jss::allocated_bytes] = toJson (
+            e.second->allocated.snapshot());
+    }
+    return ret;
+}
+
+Resource::Charge
+measuredCharge (ThreadUsage const& usage)
+{
+    using namespace std::chrono;
+    std::uint64_t const cost =
+        duration_cast<milliseconds> (usage.cpu).count() +
+        usage.fetches / 50 +
+        usage.allocated / (256 * 1024);
+    return Resource::Charge (static_cast<Resource::Charge::value_type> (
+        std::min<std::uint64_t> (cost,
+            std::numeric_limits<Resource::Charge::value_type>::max())),
+                "measured RPC");
+}
+
+} // RPC
+} // ripple
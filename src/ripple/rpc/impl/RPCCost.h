@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_RPC_RPCCOST_H_INCLUDED
+#define RIPPLE_RPC_RPCCOST_H_INCLUDED
+
+#include <ripple/basics/ThreadUsage.h>
+#include <ripple/beast/insight/HistogramImpl.h>
+#include <ripple/json/json_value.h>
+#include <ripple/resource/Charge.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace ripple {
+namespace RPC {
+
+/** The measured cost of each RPC method.
+
+    Every call records the CPU time, node store fetches and allocated
+    bytes it used, so the distribution of each can be reported per
+    method.
+
+    Thread Safety:
+
+        May be called concurrently.
+*/
+class MethodCosts
+{
+public:
+    static
+    MethodCosts&
+    instance();
+
+    /** Record the resources used by one call to a method. */
+    void
+    record (std::string const& method, ThreadUsage const& usage);
+
+    /** Return the distribution of costs for each method called so far. */
+    Json::Value
+    getJson() const;
+
+private:
+    struct Entry
+    {
+        beast::insight::HistogramImpl cpu;
+        beast::insight::HistogramImpl fetches;
+        beast::insight::HistogramImpl allocated;
+
+        explicit
+        Entry (std::string const& method);
+    };
+
+    MethodCosts() = default;
+
+    std::mutex mutable mutex_;
+    std::map<std::string, std::unique_ptr<Entry>> entries_;
+};
+
+/** Return the charge for a call that used the given resources.
+
+    The cost is one unit for each millisecond of CPU time, each 50 node
+    store fetches and each 256 kilobytes allocated. Most calls come to
+    less than the static fee of their command; the measured cost only
+    matters for calls that do far more work than that fee assumes.
+*/
+Resource::Charge
+measuredCharge (ThreadUsage const& usage);
+
+} // RPC
+} // ripple
+
+#endif
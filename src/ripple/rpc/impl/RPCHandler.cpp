@@ -20,13 +20,16 @@
 #include <BeastConfig.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/rpc/RPCHandler.h>
+#include <ripple/rpc/ResponseCache.h>
 #include <ripple/rpc/impl/Tuning.h>
 #include <ripple/rpc/impl/Handler.h>
+#include <ripple/rpc/impl/RPCCost.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/ThreadUsage.h>
 #include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/json/Object.h>
@@ -194,15 +197,41 @@ error_code_i fillHandler (Context& context,
     return rpcSUCCESS;
 }
 
+ThreadUsage usage (Context const& context)
+{
+    // A coroutine may yield and resume on another thread
+    if (context.coro)
+        return context.coro->usage();
+    return ThreadUsage::now();
+}
+
+/** Records what a command actually used and charges for it.
+
+    The charge is raised to the measured cost when that is more than
+    the static fee of the command.
+*/
+void chargeUsage (
+    Context& context, std::string const& name, ThreadUsage const& used)
+{
+    MethodCosts::instance().record (name, used);
+
+    auto const charge = measuredCharge (used);
+    if (charge.cost() > context.loadType.cost())
+        context.loadType = charge;
+}
+
 template <class Object, class Method>
 Status callMethod (
     Context& context, Method method, std::string const& name, Object& result)
 {
+    auto const start = usage (context);
     try
     {
         auto v = context.app.getJobQueue().makeLoadEvent(
             jtGENERIC, "cmd:" + name);
-        return method (context, result);
+        auto const ret = method (context, result);
+        chargeUsage (context, name, usage (context) - start);
+        return ret;
     }
     catch (std::exception& e)
     {
@@ -210,6 +239,7 @@ Status callMethod (
 
         if (context.loadType == Resource::feeReferenceRPC)
             context.loadType = Resource::feeExceptionRPC;
+        chargeUsage (context, name, usage (context) - start);
 
         inject_error (rpcINTERNAL, result);
         return rpcINTERNAL;
@@ -235,7 +265,19 @@ void getResult (
 
 } // namespace
 
-Status doCommand (
+bool fetchCachedCommand (
+    RPC::Context& context, Json::Value& result)
+{
+    Handler const * handler = nullptr;
+    if (fillHandler (context, handler) || ! handler->valueMethod_)
+        return false;
+
+    // Answers about validated ledgers never change
+    auto const key = ResponseCache::key (context);
+    return key && context.app.getResponseCache().fetch (*key, result);
+}
+
+Status doUncachedCommand (
     RPC::Context& context, Json::Value& result)
 {
     Handler const * handler = nullptr;
@@ -247,6 +289,9 @@ Status doCommand (
 
     if (auto method = handler->valueMethod_)
     {
+        auto const key = ResponseCache::key (context);
+
+        Status ret;
         if (! context.headers.user.empty() ||
             ! context.headers.forwardedFor.empty())
         {
@@ -254,23 +299,33 @@ Status doCommand (
                 ", X-User: " << context.headers.user << ", X-Forwarded-For: " <<
                     context.headers.forwardedFor;
 
-            auto ret = callMethod (context, method, handler->name_, result);
+            ret = callMethod (context, method, handler->name_, result);
 
             JLOG(context.j.debug()) << "finish command: " << handler->name_ <<
                 ", X-User: " << context.headers.user << ", X-Forwarded-For: " <<
                     context.headers.forwardedFor;
-
-            return ret;
         }
         else
         {
-            return callMethod (context, method, handler->name_, result);
+            ret = callMethod (context, method, handler->name_, result);
         }
+
+        if (key && ! ret)
+            context.app.getResponseCache().insert (*key, result);
+        return ret;
     }
 
     return rpcUNKNOWN_COMMAND;
 }
 
+Status doCommand (
+    RPC::Context& context, Json::Value& result)
+{
+    if (fetchCachedCommand (context, result))
+        return Status::OK;
+    return doUncachedCommand (context, result);
+}
+
 Role roleRequired (std::string const& method)
 {
     auto handler = RPC::getHandler(method);
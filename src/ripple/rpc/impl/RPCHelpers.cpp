@@ -20,6 +20,8 @@
 #include <BeastConfig.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/misc/Transaction.h>
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/json/to_string.h>
 #include <ripple/ledger/View.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/protocol/AccountID.h>
@@ -375,6 +377,64 @@ lookupLedger(std::shared_ptr<ReadView const>& ledger, Context& context)
     return result;
 }
 
+boost::optional<std::string>
+fixedLedger (Json::Value const& params, LedgerMaster& ledgerMaster)
+{
+    if (params.isMember (jss::ledger_hash))
+    {
+        uint256 hash;
+        if (! params[jss::ledger_hash].isString() ||
+            ! hash.SetHexExact (params[jss::ledger_hash].asString()))
+            return boost::none;
+        return to_string (hash);
+    }
+
+    // The legacy "ledger" field may also name the current ledger
+    if (params.isMember (jss::ledger) ||
+        ! params.isMember (jss::ledger_index))
+        return boost::none;
+
+    auto const& index = params[jss::ledger_index];
+    std::uint32_t seq = 0;
+    if (index.isString())
+    {
+        auto const s = index.asString();
+        if (s == "validated" || s == "closed")
+        {
+            auto const ledger = s == "validated" ?
+                ledgerMaster.getValidatedLedger() :
+                ledgerMaster.getClosedLedger();
+            if (! ledger)
+                return boost::none;
+            return to_string (ledger->info().hash);
+        }
+        if (! beast::lexicalCastChecked (seq, s))
+            return boost::none;
+    }
+    else if (index.isUInt() || (index.isInt() && index.asInt() >= 0))
+    {
+        seq = index.asUInt();
+    }
+
+    if (seq == 0 || seq > ledgerMaster.getValidLedgerIndex())
+        return boost::none;
+    return std::to_string (seq);
+}
+
+std::string
+requestKey (Context const& context, std::string const& ledger)
+{
+    // Members are kept sorted, so identical requests print the same
+    Json::Value request = context.params;
+    request.removeMember (jss::id);
+    request.removeMember (jss::jsonrpc);
+    request.removeMember (jss::ripplerpc);
+
+    return request[jss::command].asString() + '\n' +
+        std::to_string (static_cast<int> (context.role)) + '\n' +
+            ledger + '\n' + to_string (request);
+}
+
 hash_set<AccountID>
 parseAccountIds(Json::Value const& jvArray)
 {
@@ -33,6 +33,7 @@ class Value;
 
 namespace ripple {
 
+class LedgerMaster;
 class ReadView;
 class Transaction;
 
@@ -83,6 +84,26 @@ lookupLedger (std::shared_ptr<ReadView const>&, Context&);
 Status
 lookupLedger (std::shared_ptr<ReadView const>&, Context&, Json::Value& result);
 
+/** Name the ledger a request asks about, if that ledger cannot change.
+
+    A ledger hash names itself, and "validated" or "closed" resolve to
+    the hash of that ledger now. A sequence no later than the last
+    validated ledger stands for the ledger validated at it. Anything
+    else, including the current ledger and the legacy "ledger" field,
+    gives boost::none.
+*/
+boost::optional<std::string>
+fixedLedger (Json::Value const& params, LedgerMaster& ledgerMaster);
+
+/** Return a key that is the same for requests with the same answer.
+
+    The key is made of the method, the role, the ledger as returned by
+    fixedLedger, and every parameter except the request id and the
+    protocol version fields.
+*/
+std::string
+requestKey (Context const& context, std::string const& ledger);
+
 hash_set <AccountID>
 parseAccountIds(Json::Value const& jvArray);
 
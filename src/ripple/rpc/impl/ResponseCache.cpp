@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/rpc/ResponseCache.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/rpc/Context.h>
+#include <ripple/rpc/impl/RPCHelpers.h>
+#include <set>
+
+namespace ripple {
+namespace RPC {
+
+ResponseCache::ResponseCache (std::size_t maxBytes,
+    beast::insight::Collector::ptr const& collector)
+    : maxBytes_ (maxBytes)
+    , hitCounter_ (collector->make_counter ("hits"))
+    , missCounter_ (collector->make_counter ("misses"))
+{
+}
+
+boost::optional<std::string>
+ResponseCache::key (Context const& context)
+{
+    static std::set<std::string> const methods {
+        "account_info",
+        "account_lines",
+        "book_offers",
+        "ledger",
+        "ledger_entry",
+        "tx",
+    };
+
+    auto const& params = context.params;
+    if (! params.isObject() || ! params[jss::command].isString())
+        return boost::none;
+    auto const method = params[jss::command].asString();
+    if (methods.count (method) == 0)
+        return boost::none;
+
+    // A transaction is named by its hash, whichever ledger holds it.
+    // Otherwise the ledger must be fixed, and since only validated
+    // answers are kept, a sequence stands for one ledger.
+    if (method == "tx")
+        return requestKey (context, {});
+    auto const ledger = fixedLedger (params, context.ledgerMaster);
+    if (! ledger)
+        return boost::none;
+    return requestKey (context, *ledger);
+}
+
+bool
+ResponseCache::fetch (std::string const& key, Json::Value& result)
+{
+    std::string body;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        auto const iter = map_.find (key);
+        if (iter != map_.end())
+        {
+            list_.splice (list_.begin(), list_, iter->second);
+            body = iter->second->second;
+        }
+    }
+
+    Json::Value cached;
+    if (body.empty() || ! Json::Reader().parse (body, cached))
+    {
+        ++misses_;
+        ++missCounter_;
+        return false;
+    }
+
+    ++hits_;
+    ++hitCounter_;
+    result = std::move (cached);
+    return true;
+}
+
+void
+ResponseCache::insert (std::string const& key, Json::Value const& result)
+{
+    if (! result.isObject() || result.isMember (jss::error) ||
+        ! result.isMember (jss::validated) ||
+        ! result[jss::validated].asBool())
+        return;
+
+    auto body = to_string (result);
+
+    // No one response may push out most of the others
+    auto const size = key.size() + body.size();
+    if (size > maxBytes_ / 16)
+        return;
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    if (map_.count (key) != 0)
+        return;
+    list_.emplace_front (key, std::move (body));
+    map_.emplace (key, list_.begin());
+    bytes_ += size;
+    trim();
+}
+
+void
+ResponseCache::clear()
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    map_.clear();
+    list_.clear();
+    bytes_ = 0;
+}
+
+Json::Value
+ResponseCache::getJson() const
+{
+    auto const hits = hits_.load();
+    auto const misses = misses_.load();
+
+    Json::Value ret (Json::objectValue);
+    ret[jss::hits] = std::to_string (hits);
+    ret[jss::misses] = std::to_string (misses);
+    ret[jss::hit_rate] = hits + misses == 0 ? 0.0 :
+        static_cast<double> (hits) / (hits + misses);
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    ret[jss::entries] = static_cast<Json::UInt> (map_.size());
+    ret[jss::bytes] = static_cast<Json::UInt> (bytes_);
+    ret[jss::max_bytes] = static_cast<Json::UInt> (maxBytes_);
+    return ret;
+}
+
+void
+ResponseCache::trim()
+{
+    while (bytes_ > maxBytes_ && ! list_.empty())
+    {
+        auto const& entry = list_.back();
+        bytes_ -= entry.first.size() + entry.second.size();
+        map_.erase (entry.first);
+        list_.pop_back();
+    }
+}
+
+} // RPC
+} // ripple
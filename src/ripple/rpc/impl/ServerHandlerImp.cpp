@@ -19,6 +19,7 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/main/CollectorManager.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/beast/rfc2616.h>
 #include <ripple/beast/net/IPAddressConversion.h>
@@ -31,6 +32,7 @@
 #include <ripple/basics/contract.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/make_SSLContext.h>
+#include <ripple/beast/insight/Histogram.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/json/to_string.h>
 #include <ripple/net/RPCErr.h>
@@ -48,6 +50,7 @@
 #include <boost/optional.hpp>
 #include <boost/regex.hpp>
 #include <algorithm>
+#include <sstream>
 #include <stdexcept>
 
 namespace ripple {
@@ -64,6 +67,24 @@ isStatusRequest(
         request.method() == beast::http::verb::get;
 }
 
+static
+bool
+isMetricsRequest(
+    http_request_type const& request)
+{
+    return
+        request.target() == "/metrics" &&
+        request.method() == beast::http::verb::get;
+}
+
+static
+bool
+isRPCPort(Port const& port)
+{
+    return port.protocol.count("http") > 0 ||
+        port.protocol.count("https") > 0;
+}
+
 static
 Handoff
 unauthorizedResponse(
@@ -120,6 +141,7 @@ ServerHandlerImp::ServerHandlerImp (Application& app, Stoppable& parent,
     , m_server (make_Server(
         *this, io_service, app_.journal("Server")))
     , m_jobQueue (jobQueue)
+    , admission_ (jobQueue, cm.group ("rpc"), app_.journal ("Server"))
 {
     auto const& group (cm.group ("rpc"));
     rpc_requests_ = group->make_counter ("requests");
@@ -208,6 +230,9 @@ ServerHandlerImp::onHandoff (Session& session,
     if (is_ws && isStatusRequest(request))
         return statusResponse(request);
 
+    if (isRPCPort(session.port()) && isMetricsRequest(request))
+        return metricsResponse(session.port(), request, remote_address);
+
     // Pass to legacy onRequest
     return {};
 }
@@ -244,6 +269,9 @@ ServerHandlerImp::onHandoff (Session& session,
        isStatusRequest(request))
         return statusResponse(request);
 
+    if (isRPCPort(session.port()) && isMetricsRequest(request))
+        return metricsResponse(session.port(), request, remote_address);
+
     // Otherwise pass to legacy onRequest or websocket
     return {};
 }
@@ -463,7 +491,7 @@ ServerHandlerImp::processSession(
             is,
             {is->user(), is->forwarded_for()}
             };
-        RPC::doCommand(context, jr[jss::result]);
+        admission_.doCommand(context, jr[jss::result]);
     }
 
     is->getConsumer().charge(loadType);
@@ -744,7 +772,7 @@ ServerHandlerImp::processRequest (Port const& port,
             app_.getLedgerMaster(), usage, role, coro, InfoSub::pointer(),
             {user, forwardedFor}};
         Json::Value result;
-        RPC::doCommand (context, result);
+        admission_.doCommand (context, result);
         usage.charge (loadType);
         if (usage.warn())
             result[jss::warning] = jss::load;
@@ -858,6 +886,41 @@ ServerHandlerImp::statusResponse(
     return handoff;
 }
 
+/*  Latency histograms in the Prometheus text format, for admin clients.
+*/
+Handoff
+ServerHandlerImp::metricsResponse(Port const& port,
+    http_request_type const& request,
+        boost::asio::ip::tcp::endpoint const& remote_address) const
+{
+    using namespace beast::http;
+    Handoff handoff;
+    response<string_body> msg;
+    auto const role = requestRole (Role::ADMIN, port, Json::objectValue,
+        beast::IPAddressConversion::from_asio (remote_address), {});
+    if (authorized (port, build_map (request)) && role == Role::ADMIN)
+    {
+        std::ostringstream os;
+        beast::insight::writePrometheus (os, "rippled",
+            app_.getCollectorManager().collector()->histograms ());
+        msg.result(beast::http::status::ok);
+        msg.insert("Content-Type", "text/plain; version=0.0.4");
+        msg.body = os.str();
+    }
+    else
+    {
+        msg.result(beast::http::status::forbidden);
+        msg.insert("Content-Type", "text/html");
+        msg.body = "Forbidden";
+    }
+    msg.version = request.version;
+    msg.insert("Server", BuildInfo::getFullVersionString());
+    msg.insert("Connection", "close");
+    msg.prepare_payload();
+    handoff.response = std::make_shared<SimpleWriter>(msg);
+    return handoff;
+}
+
 //------------------------------------------------------------------------------
 
 void
@@ -26,6 +26,7 @@
 #include <ripple/server/Session.h>
 #include <ripple/server/WSSession.h>
 #include <ripple/rpc/RPCHandler.h>
+#include <ripple/rpc/impl/Admission.h>
 #include <ripple/app/main/CollectorManager.h>
 #include <ripple/json/Output.h>
 #include <map>
@@ -88,6 +89,7 @@ private:
     beast::insight::Counter rpc_requests_;
     beast::insight::Event rpc_size_;
     beast::insight::Event rpc_time_;
+    RPC::Admission admission_;
     std::mutex countlock_;
     std::map<std::reference_wrapper<Port const>, int> count_;
 
@@ -169,6 +171,10 @@ private:
     Handoff
     statusResponse(http_request_type const& request) const;
 
+    Handoff
+    metricsResponse(Port const& port, http_request_type const& request,
+        boost::asio::ip::tcp::endpoint const& remote_address) const;
+
 
 };
 
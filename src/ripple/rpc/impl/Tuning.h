@@ -55,6 +55,13 @@ static int const defaultAutoFillFeeDivisor = 1;
 static int const maxPathfindsInProgress = 2;
 static int const maxPathfindJobCount = 50;
 static int const maxJobQueueClients = 500;
+
+/** Client jobs beyond which expensive methods are refused. */
+static int const maxJobQueueClientsExpensive = maxJobQueueClients / 4;
+
+/** Requests that may wait for each slot of an expensive method. */
+static int const maxQueuedPerSlot = 4;
+
 using namespace std::chrono_literals;
 auto constexpr maxValidatedLedgerAge = 2min;
 static int const maxRequestSize = 1000000;
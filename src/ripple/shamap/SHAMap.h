@@ -37,6 +37,7 @@
 #include <boost/thread/shared_lock_guard.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <cassert>
+#include <functional>
 #include <stack>
 #include <vector>
 
@@ -105,6 +106,16 @@ public:
                                 std::shared_ptr<SHAMapItem const>>;
     using Delta     = std::map<uint256, DeltaItem>;
 
+    /** Receives one difference between two maps.
+
+        `before` is the item in this map and `after` the item in the
+        other map; either is null if the key is absent from that map.
+        Return false to stop the comparison.
+    */
+    using DeltaCallback = std::function<bool (uint256 const& key,
+        std::shared_ptr<SHAMapItem const> const& before,
+            std::shared_ptr<SHAMapItem const> const& after)>;
+
     ~SHAMap ();
     SHAMap(SHAMap const&) = delete;
     SHAMap& operator=(SHAMap const&) = delete;
@@ -178,6 +189,19 @@ public:
     const_iterator upper_bound(uint256 const& id) const;
 
     void visitNodes (std::function<bool (SHAMapAbstractNode&)> const&) const;
+
+    /** Visit the nodes of this map that are not part of another map.
+
+        A subtree is skipped when `have` has a subtree with the same
+        hash in the same position. Like visitNodes, nodes fetched from
+        the database are not kept in the tree, and the walk stops when
+        the function returns true.
+
+        @param have The map to skip nodes of, or nullptr to visit
+            every node.
+    */
+    void visitNewNodes (SHAMap const* have,
+        std::function<bool (SHAMapAbstractNode&)> const&) const;
     void
         visitLeaves(
             std::function<void(std::shared_ptr<SHAMapItem const> const&)> const&) const;
@@ -222,6 +246,24 @@ public:
     bool compare (SHAMap const& otherMap,
                   Delta& differences, int maxCount) const;
 
+    /** Report every item that differs between this map and another.
+
+        Subtrees with equal hashes are skipped. With more than one
+        worker, the differing subtrees near the root are split among
+        that many threads, the calling thread being one of them, and
+        differences arrive in no particular order. Calls to `onDelta`
+        never overlap. Each worker holds back at most a small batch of
+        differences, so memory use does not grow with the size of the
+        delta.
+
+        Both maps must be immutable.
+
+        @return false if `onDelta` stopped the comparison.
+        Throws SHAMapMissingNode if a node can't be fetched.
+    */
+    bool visitDelta (SHAMap const& otherMap,
+        DeltaCallback const& onDelta, std::size_t workers = 1) const;
+
     int flushDirty (NodeObjectType t, std::uint32_t seq);
     void walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const;
     bool deepCompare (SHAMap & other) const;  // Intended for debug/test only
@@ -323,7 +365,10 @@ private:
     SHAMapTreeNode const* peekNextItem(uint256 const& id, SharedPtrNodeStack& stack) const;
     bool walkBranch (SHAMapAbstractNode* node,
                      std::shared_ptr<SHAMapItem const> const& otherMapItem,
-                     bool isFirstMap, Delta & differences, int & maxCount) const;
+                     bool isFirstMap, DeltaCallback const& onDelta) const;
+    // Either node may be null if the branch is empty in that map
+    bool compareBranch (SHAMapAbstractNode* ourNode, SHAMap const& otherMap,
+        SHAMapAbstractNode* otherNode, DeltaCallback const& onDelta) const;
     int walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq);
     bool isInconsistentNode(std::shared_ptr<SHAMapAbstractNode> const& node) const;
 
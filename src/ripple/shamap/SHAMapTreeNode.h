@@ -25,10 +25,12 @@
 #include <ripple/basics/TaggedCache.h>
 #include <ripple/beast/utility/Journal.h>
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace ripple {
 
@@ -136,6 +138,11 @@ public:
              SHAMapHash const& hash, bool hashValid, beast::Journal j,
              SHAMapNodeID const& id = SHAMapNodeID{});
 
+    /** Recompute the hashes of several independent nodes at once.
+        Inner nodes must already hold the hashes of their children.
+    */
+    static void updateHashes (std::vector<SHAMapAbstractNode*> const& nodes);
+
     // debugging
 #ifdef BEAST_DEBUG
     static void dump (SHAMapNodeID const&, beast::Journal journal);
@@ -147,12 +154,35 @@ class SHAMapInnerNodeV2;
 class SHAMapInnerNode
     : public SHAMapAbstractNode
 {
-    std::array<SHAMapHash, 16>          mHashes;
-    std::shared_ptr<SHAMapAbstractNode> mChildren[16];
-    int                             mIsBranch = 0;
+    // The hash and child of one non-empty branch
+    struct Slot
+    {
+        SHAMapHash                          hash;
+        std::shared_ptr<SHAMapAbstractNode> child;
+    };
+
+    // Most inner nodes have only a few branches, so only the non-empty
+    // ones are stored, in branch order. The slot for branch m is at the
+    // number of bits below m that are set in mIsBranch.
+    std::unique_ptr<Slot[]>         mSlots;
+    std::uint16_t                   mIsBranch = 0;
     std::uint32_t                   mFullBelowGen = 0;
 
-    static std::mutex               childLock;
+    static SHAMapHash const         emptyHash;
+
+    static int popcount (std::uint16_t bits);
+    int slotIndex (int branch) const;
+    Slot* findSlot (int branch) const;
+
+    // Add or remove the slot for a branch
+    Slot& insertSlot (int branch);
+    void eraseSlot (int branch);
+
+    // Replace all the branch hashes of a node with no children
+    void setHashes (std::array<SHAMapHash, 16> const& hashes);
+
+    // Synchronizes the lazy hookup of children on shared nodes
+    std::mutex& childLock () const;
 public:
     SHAMapInnerNode(std::uint32_t seq);
     std::shared_ptr<SHAMapAbstractNode> clone(std::uint32_t seq) const override;
@@ -175,6 +205,7 @@ public:
 
     bool updateHash () override;
     void updateHashDeep();
+    void updateChildHashes();
     void addRaw (Serializer&, SHANodeFormat format) const override;
     std::string getString (SHAMapNodeID const&) const override;
     uint256 const& key() const override;
@@ -342,6 +373,33 @@ SHAMapInnerNode::SHAMapInnerNode(std::uint32_t seq)
 {
 }
 
+inline
+int
+SHAMapInnerNode::popcount (std::uint16_t bits)
+{
+    unsigned v = bits;
+    v = v - ((v >> 1) & 0x5555);
+    v = (v & 0x3333) + ((v >> 2) & 0x3333);
+    v = (v + (v >> 4)) & 0x0F0F;
+    return (v + (v >> 8)) & 0x1F;
+}
+
+inline
+int
+SHAMapInnerNode::slotIndex (int branch) const
+{
+    return popcount (mIsBranch & ((1 << branch) - 1));
+}
+
+inline
+SHAMapInnerNode::Slot*
+SHAMapInnerNode::findSlot (int branch) const
+{
+    if (isEmptyBranch (branch))
+        return nullptr;
+    return &mSlots[slotIndex (branch)];
+}
+
 inline
 bool
 SHAMapInnerNode::isEmptyBranch (int m) const
@@ -354,7 +412,9 @@ SHAMapHash const&
 SHAMapInnerNode::getChildHash (int m) const
 {
     assert ((m >= 0) && (m < 16) && (getType() == tnINNER));
-    return mHashes[m];
+    if (auto const slot = findSlot (m))
+        return slot->hash;
+    return emptyHash;
 }
 
 inline
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_SHAMAP_TREENODESNAPSHOT_H_INCLUDED
+#define RIPPLE_SHAMAP_TREENODESNAPSHOT_H_INCLUDED
+
+#include <ripple/shamap/Family.h>
+#include <ripple/shamap/SHAMapTreeNode.h>
+#include <boost/filesystem/path.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+
+/** Write the tree nodes in a family's cache to a file.
+
+    The cache holds the nodes of recent ledgers that the server was
+    actually using. Inner nodes are written first, so when there are
+    more than `maxNodes` it is leaves that are left out. The file is
+    replaced atomically.
+
+    @return The number of nodes written.
+
+    Throws:
+
+        std::runtime_error if the file could not be written.
+*/
+std::size_t
+saveTreeNodeSnapshot (Family& family,
+    boost::filesystem::path const& path, std::size_t maxNodes);
+
+/** Read a file written by saveTreeNodeSnapshot into a family's cache.
+
+    The file is read front to back in large blocks, so this costs a
+    sequential scan instead of one random read per node. Every node is
+    checked against its hash; reading stops at the first record that
+    does not match.
+
+    The cache only keeps nodes for a limited time unless something
+    else refers to them, so the nodes are also returned. Holding on to
+    them keeps them in the cache until the ledgers using them are
+    loaded.
+
+    @return The nodes read, empty if the file does not exist.
+*/
+std::vector<std::shared_ptr<SHAMapAbstractNode>>
+loadTreeNodeSnapshot (Family& family,
+    boost::filesystem::path const& path);
+
+} // ripple
+
+#endif
@@ -1186,96 +1186,113 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
         return 1;
     }
 
-    // Stack of {parent,index,child} pointers representing
-    // inner nodes we are in the process of flushing
-    using StackEntry = std::pair <std::shared_ptr<SHAMapInnerNode>, int>;
-    std::stack <StackEntry, std::vector<StackEntry>> stack;
-
-    node = preFlushNode(std::move(node));
+    // Unshare the modified part of the tree and record each modified
+    // node along with the parent and branch it hangs from. A node is
+    // always recorded before its parent.
+    struct DirtyNode
+    {
+        std::shared_ptr<SHAMapAbstractNode> node;
+        SHAMapInnerNode* parent;
+        int branch;
+        int depth;
+    };
+    std::vector<DirtyNode> dirty;
+
+    struct StackEntry
+    {
+        std::shared_ptr<SHAMapInnerNode> node;
+        SHAMapInnerNode* parent;
+        int branch;
+        int depth;
+        int pos;
+    };
+    std::vector<StackEntry> stack;
+    stack.push_back ({preFlushNode (std::move (node)), nullptr, 0, 0, 0});
+
+    int maxDepth = 0;
+    while (! stack.empty ())
+    {
+        auto& top = stack.back ();
+        if (top.pos == 16)
+        {
+            dirty.push_back ({std::move (top.node),
+                top.parent, top.branch, top.depth});
+            stack.pop_back ();
+            continue;
+        }
 
-    int pos = 0;
+        int const branch = top.pos++;
+        if (top.node->isEmptyBranch (branch))
+            continue;
+
+        // No need to do I/O. If the node isn't linked,
+        // it can't need to be flushed
+        auto child = top.node->getChild (branch);
+        if (! child || (child->getSeq () == 0))
+            continue;
+
+        // This is a node that needs to be flushed. Link the unshared
+        // copy now so that the parent hashes the right child.
+        assert (top.node->getSeq () == seq_);
+        child = preFlushNode (std::move (child));
+        top.node->shareChild (branch, child);
+
+        auto const parent = top.node.get ();
+        auto const depth = top.depth + 1;
+        maxDepth = std::max (maxDepth, depth);
+        if (child->isInner ())
+            stack.push_back ({std::static_pointer_cast<SHAMapInnerNode> (
+                std::move (child)), parent, branch, depth, 0});
+        else
+            dirty.push_back ({std::move (child), parent, branch, depth});
+    }
 
-    // We can't flush an inner node until we flush its children
-    while (1)
+    // Hash the leaves, then the inner nodes from the bottom up. Nodes
+    // at the same depth don't depend on each other, so each group is
+    // hashed as one batch.
     {
-        while (pos < 16)
+        std::vector<SHAMapAbstractNode*> leaves;
+        std::vector<std::vector<SHAMapAbstractNode*>> inner (maxDepth + 1);
+        for (auto const& d : dirty)
         {
-            if (node->isEmptyBranch (pos))
-            {
-                ++pos;
-            }
+            if (d.node->isInner ())
+                inner[d.depth].push_back (d.node.get ());
             else
-            {
-                // No need to do I/O. If the node isn't linked,
-                // it can't need to be flushed
-                int branch = pos;
-                auto child = node->getChild(pos++);
-
-                if (child && (child->getSeq() != 0))
-                {
-                    // This is a node that needs to be flushed
-
-                    child = preFlushNode(std::move(child));
-
-                    if (child->isInner ())
-                    {
-                        // save our place and work on this node
-
-                        stack.emplace (std::move (node), branch);
-
-                        node = std::static_pointer_cast<SHAMapInnerNode>(std::move(child));
-                        pos = 0;
-                    }
-                    else
-                    {
-                        // flush this leaf
-                        ++flushed;
-
-                        assert (node->getSeq() == seq_);
-                        child->updateHash();
-
-                        if (doWrite && backed_)
-                            child = writeNode(t, seq, std::move(child));
-                        else
-                            child->setSeq (0);
-
-                        node->shareChild (branch, child);
-                    }
-                }
-            }
+                leaves.push_back (d.node.get ());
         }
 
-        // update the hash of this inner node
-        node->updateHashDeep();
+        SHAMapAbstractNode::updateHashes (leaves);
+        for (auto depth = maxDepth; depth >= 0; --depth)
+        {
+            for (auto const n : inner[depth])
+                static_cast<SHAMapInnerNode*> (n)->updateChildHashes ();
+            SHAMapAbstractNode::updateHashes (inner[depth]);
+        }
+    }
 
-        // This inner node can now be shared
+    // Make the nodes shareable, writing them if requested, and hook each
+    // one into its parent. Writing can substitute a canonical copy.
+    for (auto& d : dirty)
+    {
         if (doWrite && backed_)
-            node = std::static_pointer_cast<SHAMapInnerNode>(writeNode(t, seq,
-                                                                       std::move(node)));
+            d.node = writeNode (t, seq, std::move (d.node));
         else
-            node->setSeq (0);
+            d.node->setSeq (0);
 
         ++flushed;
 
-        if (stack.empty ())
-           break;
-
-        auto parent = std::move (stack.top().first);
-        pos = stack.top().second;
-        stack.pop();
-
-        // Hook this inner node to its parent
-        assert (parent->getSeq() == seq_);
-        parent->shareChild (pos, node);
-
-        // Continue with parent's next child, if any
-        node = std::move (parent);
-        ++pos;
+        if (d.parent)
+        {
+            assert (d.parent->getSeq () == seq_);
+            d.parent->shareChild (d.branch, d.node);
+        }
+        else
+        {
+            // The last node is the new root_
+            root_ = std::move (d.node);
+        }
     }
 
-    // Last inner node is the new root_
-    root_ = std::move (node);
-
     return flushed;
 }
 
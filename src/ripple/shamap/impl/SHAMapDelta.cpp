@@ -20,6 +20,12 @@
 #include <BeastConfig.h>
 #include <ripple/basics/contract.h>
 #include <ripple/shamap/SHAMap.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <tuple>
 
 namespace ripple {
 
@@ -33,13 +39,14 @@ namespace ripple {
 
 bool SHAMap::walkBranch (SHAMapAbstractNode* node,
                          std::shared_ptr<SHAMapItem const> const& otherMapItem,
-                         bool isFirstMap,Delta& differences, int& maxCount) const
+                         bool isFirstMap, DeltaCallback const& onDelta) const
 {
     // Walk a branch of a SHAMap that's matched by an empty branch or single item in the other map
     std::stack <SHAMapAbstractNode*, std::vector<SHAMapAbstractNode*>> nodeStack;
     nodeStack.push (node);
 
     bool emptyBranch = !otherMapItem;
+    std::shared_ptr<SHAMapItem const> const none;
 
     while (!nodeStack.empty ())
     {
@@ -57,32 +64,28 @@ bool SHAMap::walkBranch (SHAMapAbstractNode* node,
         else
         {
             // This is a leaf node, process its item
-            auto item = static_cast<SHAMapTreeNode*>(node)->peekItem();
+            auto const& item = static_cast<SHAMapTreeNode*>(node)->peekItem();
 
             if (emptyBranch || (item->key() != otherMapItem->key()))
             {
                 // unmatched
                 if (isFirstMap)
-                    differences.insert (std::make_pair (item->key(),
-                        DeltaRef (item, std::shared_ptr<SHAMapItem const> ())));
-                else
-                    differences.insert (std::make_pair (item->key(),
-                        DeltaRef (std::shared_ptr<SHAMapItem const> (), item)));
-
-                if (--maxCount <= 0)
+                {
+                    if (! onDelta (item->key(), item, none))
+                        return false;
+                }
+                else if (! onDelta (item->key(), none, item))
                     return false;
             }
             else if (item->peekData () != otherMapItem->peekData ())
             {
                 // non-matching items with same tag
                 if (isFirstMap)
-                    differences.insert (std::make_pair (item->key(),
-                                                DeltaRef (item, otherMapItem)));
-                else
-                    differences.insert (std::make_pair (item->key(),
-                                                DeltaRef (otherMapItem, item)));
-
-                if (--maxCount <= 0)
+                {
+                    if (! onDelta (item->key(), item, otherMapItem))
+                        return false;
+                }
+                else if (! onDelta (item->key(), otherMapItem, item))
                     return false;
 
                 emptyBranch = true;
@@ -99,42 +102,32 @@ bool SHAMap::walkBranch (SHAMapAbstractNode* node,
     {
         // otherMapItem was unmatched, must add
         if (isFirstMap) // this is first map, so other item is from second
-            differences.insert(std::make_pair(otherMapItem->key(),
-                                              DeltaRef(std::shared_ptr<SHAMapItem const>(),
-                                                       otherMapItem)));
-        else
-            differences.insert(std::make_pair(otherMapItem->key(),
-                DeltaRef(otherMapItem, std::shared_ptr<SHAMapItem const>())));
-
-        if (--maxCount <= 0)
-            return false;
+            return onDelta (otherMapItem->key(), none, otherMapItem);
+        return onDelta (otherMapItem->key(), otherMapItem, none);
     }
 
     return true;
 }
 
 bool
-SHAMap::compare (SHAMap const& otherMap,
-                 Delta& differences, int maxCount) const
+SHAMap::compareBranch (SHAMapAbstractNode* ourNode, SHAMap const& otherMap,
+    SHAMapAbstractNode* otherNode, DeltaCallback const& onDelta) const
 {
-    // compare two hash trees, add up to maxCount differences to the difference table
-    // return value: true=complete table of differences given, false=too many differences
-    // throws on corrupt tables or missing nodes
-    // CAUTION: otherMap is not locked and must be immutable
+    std::shared_ptr<SHAMapItem const> const none;
 
-    assert (isValid () && otherMap.isValid ());
-
-    if (getHash () == otherMap.getHash ())
-        return true;
+    if (!ourNode)
+        return otherMap.walkBranch (otherNode, none, false, onDelta);
+    if (!otherNode)
+        return walkBranch (ourNode, none, true, onDelta);
 
     using StackEntry = std::pair <SHAMapAbstractNode*, SHAMapAbstractNode*>;
     std::stack <StackEntry, std::vector<StackEntry>> nodeStack; // track nodes we've pushed
 
-    nodeStack.push ({root_.get(), otherMap.root_.get()});
+    nodeStack.push ({ourNode, otherNode});
     while (!nodeStack.empty ())
     {
-        SHAMapAbstractNode* ourNode = nodeStack.top().first;
-        SHAMapAbstractNode* otherNode = nodeStack.top().second;
+        ourNode = nodeStack.top().first;
+        otherNode = nodeStack.top().second;
         nodeStack.pop ();
 
         if (!ourNode || !otherNode)
@@ -146,47 +139,36 @@ SHAMap::compare (SHAMap const& otherMap,
         if (ourNode->isLeaf () && otherNode->isLeaf ())
         {
             // two leaves
-            auto ours = static_cast<SHAMapTreeNode*>(ourNode);
-            auto other = static_cast<SHAMapTreeNode*>(otherNode);
-            if (ours->peekItem()->key() == other->peekItem()->key())
+            auto const& ours = static_cast<SHAMapTreeNode*>(ourNode)->peekItem();
+            auto const& other = static_cast<SHAMapTreeNode*>(otherNode)->peekItem();
+            if (ours->key() == other->key())
             {
-                if (ours->peekItem()->peekData () != other->peekItem()->peekData ())
+                if (ours->peekData () != other->peekData ())
                 {
-                    differences.insert (std::make_pair (ours->peekItem()->key(),
-                                                 DeltaRef (ours->peekItem (),
-                                                 other->peekItem ())));
-                    if (--maxCount <= 0)
+                    if (! onDelta (ours->key(), ours, other))
                         return false;
                 }
             }
             else
             {
-                differences.insert (std::make_pair(ours->peekItem()->key(),
-                                                   DeltaRef(ours->peekItem(),
-                                                   std::shared_ptr<SHAMapItem const>())));
-                if (--maxCount <= 0)
+                if (! onDelta (ours->key(), ours, none))
                     return false;
-
-                differences.insert(std::make_pair(other->peekItem()->key(),
-                    DeltaRef(std::shared_ptr<SHAMapItem const>(), other->peekItem ())));
-                if (--maxCount <= 0)
+                if (! onDelta (other->key(), none, other))
                     return false;
             }
         }
         else if (ourNode->isInner () && otherNode->isLeaf ())
         {
-            auto ours = static_cast<SHAMapInnerNode*>(ourNode);
             auto other = static_cast<SHAMapTreeNode*>(otherNode);
-            if (!walkBranch (ours, other->peekItem (),
-                    true, differences, maxCount))
+            if (!walkBranch (ourNode, other->peekItem (),
+                    true, onDelta))
                 return false;
         }
         else if (ourNode->isLeaf () && otherNode->isInner ())
         {
             auto ours = static_cast<SHAMapTreeNode*>(ourNode);
-            auto other = static_cast<SHAMapInnerNode*>(otherNode);
-            if (!otherMap.walkBranch (other, ours->peekItem (),
-                                       false, differences, maxCount))
+            if (!otherMap.walkBranch (otherNode, ours->peekItem (),
+                                       false, onDelta))
                 return false;
         }
         else if (ourNode->isInner () && otherNode->isInner ())
@@ -199,20 +181,16 @@ SHAMap::compare (SHAMap const& otherMap,
                     if (other->isEmptyBranch (i))
                     {
                         // We have a branch, the other tree does not
-                        SHAMapAbstractNode* iNode = descendThrow (ours, i);
-                        if (!walkBranch (iNode,
-                                         std::shared_ptr<SHAMapItem const> (), true,
-                                         differences, maxCount))
+                        if (!walkBranch (descendThrow (ours, i),
+                                         none, true, onDelta))
                             return false;
                     }
                     else if (ours->isEmptyBranch (i))
                     {
                         // The other tree has a branch, we do not
-                        SHAMapAbstractNode* iNode =
-                            otherMap.descendThrow(other, i);
-                        if (!otherMap.walkBranch (iNode,
-                                                   std::shared_ptr<SHAMapItem const>(),
-                                                   false, differences, maxCount))
+                        if (!otherMap.walkBranch (
+                                otherMap.descendThrow (other, i),
+                                none, false, onDelta))
                             return false;
                     }
                     else // The two trees have different non-empty branches
@@ -227,6 +205,148 @@ SHAMap::compare (SHAMap const& otherMap,
     return true;
 }
 
+bool
+SHAMap::compare (SHAMap const& otherMap,
+                 Delta& differences, int maxCount) const
+{
+    // compare two hash trees, add up to maxCount differences to the difference table
+    // return value: true=complete table of differences given, false=too many differences
+    // throws on corrupt tables or missing nodes
+    // CAUTION: otherMap is not locked and must be immutable
+
+    assert (isValid () && otherMap.isValid ());
+
+    if (getHash () == otherMap.getHash ())
+        return true;
+
+    return compareBranch (root_.get(), otherMap, otherMap.root_.get(),
+        [&](uint256 const& key,
+            std::shared_ptr<SHAMapItem const> const& before,
+            std::shared_ptr<SHAMapItem const> const& after)
+        {
+            differences.insert (std::make_pair (key,
+                DeltaRef (before, after)));
+            return --maxCount > 0;
+        });
+}
+
+bool
+SHAMap::visitDelta (SHAMap const& otherMap,
+    DeltaCallback const& onDelta, std::size_t workers) const
+{
+    assert (isValid () && otherMap.isValid ());
+
+    if (getHash () == otherMap.getHash ())
+        return true;
+
+    if (workers <= 1)
+        return compareBranch (root_.get(), otherMap,
+            otherMap.root_.get(), onDelta);
+
+    // Split the differing part of the trees into pairs of subtrees,
+    // a few levels deep, until there are enough to keep the workers
+    // busy. A null node stands for an empty branch.
+    using Task = std::pair <SHAMapAbstractNode*, SHAMapAbstractNode*>;
+    std::vector<Task> tasks {{root_.get(), otherMap.root_.get()}};
+    for (int depth = 0; depth < 3 && tasks.size () < 8 * workers; ++depth)
+    {
+        std::vector<Task> next;
+        bool split = false;
+        for (auto const& task : tasks)
+        {
+            if (!task.first || !task.second ||
+                !task.first->isInner () || !task.second->isInner ())
+            {
+                next.push_back (task);
+                continue;
+            }
+            auto ours = static_cast<SHAMapInnerNode*>(task.first);
+            auto other = static_cast<SHAMapInnerNode*>(task.second);
+            for (int i = 0; i < 16; ++i)
+            {
+                if (ours->getChildHash (i) == other->getChildHash (i))
+                    continue;
+                next.emplace_back (
+                    ours->isEmptyBranch (i) ? nullptr :
+                        descendThrow (ours, i),
+                    other->isEmptyBranch (i) ? nullptr :
+                        otherMap.descendThrow (other, i));
+            }
+            split = true;
+        }
+        tasks = std::move (next);
+        if (!split)
+            break;
+    }
+
+    // Each worker collects differences in a small batch and hands
+    // the batch to onDelta under the lock.
+    std::size_t const batchSize = 256;
+    std::mutex mutex;
+    std::atomic<bool> stop {false};
+    std::atomic<std::size_t> nextTask {0};
+    std::exception_ptr error;
+
+    auto const work = [&]
+    {
+        std::vector<std::tuple<uint256,
+            std::shared_ptr<SHAMapItem const>,
+                std::shared_ptr<SHAMapItem const>>> batch;
+        batch.reserve (batchSize);
+
+        auto const flush = [&]
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            for (auto const& d : batch)
+            {
+                if (stop)
+                    break;
+                if (! onDelta (std::get<0>(d), std::get<1>(d), std::get<2>(d)))
+                    stop = true;
+            }
+            batch.clear ();
+        };
+
+        DeltaCallback const collect =
+            [&](uint256 const& key,
+                std::shared_ptr<SHAMapItem const> const& before,
+                std::shared_ptr<SHAMapItem const> const& after)
+            {
+                batch.emplace_back (key, before, after);
+                if (batch.size () >= batchSize)
+                    flush ();
+                return ! stop;
+            };
+
+        try
+        {
+            for (auto i = nextTask++; i < tasks.size () && ! stop; i = nextTask++)
+                compareBranch (tasks[i].first, otherMap,
+                    tasks[i].second, collect);
+            flush ();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            if (! error)
+                error = std::current_exception ();
+            stop = true;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve (workers - 1);
+    for (std::size_t i = 1; i < std::min (workers, tasks.size ()); ++i)
+        threads.emplace_back (work);
+    work ();
+    for (auto& t : threads)
+        t.join ();
+
+    if (error)
+        std::rethrow_exception (error);
+    return ! stop;
+}
+
 void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const
 {
     if (!root_->isInner ())  // root_ is only node, and we have it
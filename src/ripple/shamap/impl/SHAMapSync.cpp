@@ -753,6 +753,64 @@ void SHAMap::getFetchPack (SHAMap const* have, bool includeLeaves, int max,
         });
 }
 
+void
+SHAMap::visitNewNodes (SHAMap const* have,
+    std::function<bool (SHAMapAbstractNode&)> const& function) const
+{
+    assert (root_->isValid ());
+
+    if (have && (have->is_v2 () != is_v2 ()))
+        have = nullptr;
+
+    if (have && (root_->getNodeHash () == have->root_->getNodeHash ()))
+        return;
+
+    // Pairs a node of this map with the node in the
+    // same position in `have`, if that one is inner
+    using StackEntry = std::pair <std::shared_ptr<SHAMapAbstractNode>,
+        std::shared_ptr<SHAMapInnerNode>>;
+    std::stack <StackEntry, std::vector <StackEntry>> stack;
+
+    auto asInner = [](std::shared_ptr<SHAMapAbstractNode> const& node)
+    {
+        if (node && node->isInner ())
+            return std::static_pointer_cast<SHAMapInnerNode>(node);
+        return std::shared_ptr<SHAMapInnerNode>{};
+    };
+
+    stack.emplace (root_, have ? asInner (have->root_) : nullptr);
+
+    while (!stack.empty ())
+    {
+        auto const node = std::move (stack.top ().first);
+        auto const other = std::move (stack.top ().second);
+        stack.pop ();
+
+        if (function (*node))
+            return;
+
+        if (!node->isInner ())
+            continue;
+
+        auto const inner = std::static_pointer_cast<SHAMapInnerNode>(node);
+        for (int i = 0; i < 16; ++i)
+        {
+            if (inner->isEmptyBranch (i))
+                continue;
+
+            std::shared_ptr<SHAMapInnerNode> otherChild;
+            if (other && !other->isEmptyBranch (i))
+            {
+                if (other->getChildHash (i) == inner->getChildHash (i))
+                    continue;
+                otherChild = asInner (have->descendNoStore (other, i));
+            }
+
+            stack.emplace (descendNoStore (inner, i), std::move (otherChild));
+        }
+    }
+}
+
 void
 SHAMap::visitDifferences(SHAMap const* have,
                          std::function<bool (SHAMapAbstractNode&)> func) const
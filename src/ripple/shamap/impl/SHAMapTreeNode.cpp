@@ -26,13 +26,110 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/beast/core/LexicalCast.h>
+#include <array>
+#include <cstdint>
 #include <mutex>
 
 #include <openssl/sha.h>
 
 namespace ripple {
 
-std::mutex SHAMapInnerNode::childLock;
+namespace {
+
+// Children of shared inner nodes are hooked up lazily by whichever
+// thread descends the tree first. Rather than one process-wide mutex,
+// or a mutex in every inner node, a node locks one of a fixed set of
+// stripes picked by its address.
+class ChildLocks
+{
+private:
+    struct alignas(64) Stripe
+    {
+        std::mutex mutex;
+    };
+
+    static constexpr std::size_t stripes = 64;
+    std::array<Stripe, stripes> locks_;
+
+public:
+    std::mutex&
+    get (void const* node)
+    {
+        // Nodes are heap allocated, so the low bits carry little
+        // information.
+        auto const addr = reinterpret_cast<std::uintptr_t> (node);
+        return locks_[((addr >> 4) ^ (addr >> 10)) % stripes].mutex;
+    }
+};
+
+ChildLocks childLocks;
+
+}
+
+std::mutex&
+SHAMapInnerNode::childLock () const
+{
+    return childLocks.get (this);
+}
+
+SHAMapHash const SHAMapInnerNode::emptyHash {};
+
+SHAMapInnerNode::Slot&
+SHAMapInnerNode::insertSlot (int branch)
+{
+    assert (isEmptyBranch (branch));
+    auto const count = popcount (mIsBranch);
+    auto const index = slotIndex (branch);
+    std::unique_ptr<Slot[]> slots (new Slot[count + 1]);
+    for (int i = 0; i < index; ++i)
+        slots[i] = std::move (mSlots[i]);
+    for (int i = index; i < count; ++i)
+        slots[i + 1] = std::move (mSlots[i]);
+    mSlots = std::move (slots);
+    mIsBranch |= (1 << branch);
+    return mSlots[index];
+}
+
+void
+SHAMapInnerNode::eraseSlot (int branch)
+{
+    assert (!isEmptyBranch (branch));
+    auto const count = popcount (mIsBranch);
+    auto const index = slotIndex (branch);
+    std::unique_ptr<Slot[]> slots;
+    if (count > 1)
+    {
+        slots.reset (new Slot[count - 1]);
+        for (int i = 0; i < index; ++i)
+            slots[i] = std::move (mSlots[i]);
+        for (int i = index + 1; i < count; ++i)
+            slots[i - 1] = std::move (mSlots[i]);
+    }
+    mSlots = std::move (slots);
+    mIsBranch &= ~ (1 << branch);
+}
+
+void
+SHAMapInnerNode::setHashes (std::array<SHAMapHash, 16> const& hashes)
+{
+    assert (mIsBranch == 0);
+    std::uint16_t isBranch = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        if (hashes[i].isNonZero ())
+            isBranch |= (1 << i);
+    }
+    mIsBranch = isBranch;
+    if (isBranch == 0)
+        return;
+    mSlots.reset (new Slot[popcount (isBranch)]);
+    int index = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        if (hashes[i].isNonZero ())
+            mSlots[index++].hash = hashes[i];
+    }
+}
 
 SHAMapAbstractNode::~SHAMapAbstractNode() = default;
 
@@ -43,12 +140,14 @@ SHAMapInnerNode::clone(std::uint32_t seq) const
     p->mHash = mHash;
     p->mIsBranch = mIsBranch;
     p->mFullBelowGen = mFullBelowGen;
-    p->mHashes = mHashes;
-    std::lock_guard <std::mutex> lock(childLock);
-    for (int i = 0; i < 16; ++i)
+    auto const count = popcount (mIsBranch);
+    if (count != 0)
+        p->mSlots.reset (new Slot[count]);
+    std::lock_guard <std::mutex> lock(childLock ());
+    for (int i = 0; i < count; ++i)
     {
-        p->mChildren[i] = mChildren[i];
-        assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(p->mChildren[i]) == nullptr);
+        p->mSlots[i] = mSlots[i];
+        assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(p->mSlots[i].child) == nullptr);
     }
     return std::move(p);
 }
@@ -60,16 +159,18 @@ SHAMapInnerNodeV2::clone(std::uint32_t seq) const
     p->mHash = mHash;
     p->mIsBranch = mIsBranch;
     p->mFullBelowGen = mFullBelowGen;
-    p->mHashes = mHashes;
     p->common_ = common_;
     p->depth_ = depth_;
-    std::lock_guard <std::mutex> lock(childLock);
-    for (int i = 0; i < 16; ++i)
+    auto const count = popcount (mIsBranch);
+    if (count != 0)
+        p->mSlots.reset (new Slot[count]);
+    std::lock_guard <std::mutex> lock(childLock ());
+    for (int i = 0; i < count; ++i)
     {
-        p->mChildren[i] = mChildren[i];
-        if (p->mChildren[i] != nullptr)
-            assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(p->mChildren[i]) != nullptr ||
-                   std::dynamic_pointer_cast<SHAMapTreeNode>(p->mChildren[i]) != nullptr);
+        p->mSlots[i] = mSlots[i];
+        if (p->mSlots[i].child != nullptr)
+            assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(p->mSlots[i].child) != nullptr ||
+                   std::dynamic_pointer_cast<SHAMapTreeNode>(p->mSlots[i].child) != nullptr);
     }
     return std::move(p);
 }
@@ -148,13 +249,10 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                 Throw<std::runtime_error> ("invalid FI node");
 
             auto ret = std::make_shared<SHAMapInnerNode>(seq);
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < 16; ++i)
-            {
-                s.get256 (ret->mHashes[i].as_uint256(), i * 32);
-
-                if (ret->mHashes[i].isNonZero ())
-                    ret->mIsBranch |= (1 << i);
-            }
+                s.get256 (hashes[i].as_uint256(), i * 32);
+            ret->setHashes (hashes);
             if (hashValid)
                 ret->mHash = hash;
             else
@@ -165,6 +263,7 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
         {
             auto ret = std::make_shared<SHAMapInnerNode>(seq);
             // compressed inner
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < (len / 33); ++i)
             {
                 int pos;
@@ -172,10 +271,9 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                     Throw<std::runtime_error> ("short CI node");
                 if ((pos < 0) || (pos >= 16))
                     Throw<std::runtime_error> ("invalid CI node");
-                s.get256 (ret->mHashes[pos].as_uint256(), i * 33);
-                if (ret->mHashes[pos].isNonZero ())
-                    ret->mIsBranch |= (1 << pos);
+                s.get256 (hashes[pos].as_uint256(), i * 33);
             }
+            ret->setHashes (hashes);
             if (hashValid)
                 ret->mHash = hash;
             else
@@ -207,13 +305,10 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                 Throw<std::runtime_error> ("invalid FI node");
 
             auto ret = std::make_shared<SHAMapInnerNodeV2>(seq);
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < 16; ++i)
-            {
-                s.get256 (ret->mHashes[i].as_uint256(), i * 32);
-
-                if (ret->mHashes[i].isNonZero ())
-                    ret->mIsBranch |= (1 << i);
-            }
+                s.get256 (hashes[i].as_uint256(), i * 32);
+            ret->setHashes (hashes);
             ret->set_common(id.getDepth(), id.getNodeID());
             if (hashValid)
                 ret->mHash = hash;
@@ -225,6 +320,7 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
         {
             auto ret = std::make_shared<SHAMapInnerNodeV2>(seq);
             // compressed v2 inner
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < (len / 33); ++i)
             {
                 int pos;
@@ -232,10 +328,9 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                     Throw<std::runtime_error> ("short CI node");
                 if ((pos < 0) || (pos >= 16))
                     Throw<std::runtime_error> ("invalid CI node");
-                s.get256 (ret->mHashes[pos].as_uint256(), i * 33);
-                if (ret->mHashes[pos].isNonZero ())
-                    ret->mIsBranch |= (1 << pos);
+                s.get256 (hashes[pos].as_uint256(), i * 33);
             }
+            ret->setHashes (hashes);
             ret->set_common(id.getDepth(), id.getNodeID());
             if (hashValid)
                 ret->mHash = hash;
@@ -305,13 +400,10 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
             else
                 ret = std::make_shared<SHAMapInnerNode>(seq);
 
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < 16; ++i)
-            {
-                s.get256 (ret->mHashes[i].as_uint256(), i * 32);
-
-                if (ret->mHashes[i].isNonZero ())
-                    ret->mIsBranch |= (1 << i);
-            }
+                s.get256 (hashes[i].as_uint256(), i * 32);
+            ret->setHashes (hashes);
 
             if (isV2)
             {
@@ -368,8 +460,8 @@ SHAMapInnerNode::updateHash()
         sha512_half_hasher h;
         using beast::hash_append;
         hash_append(h, HashPrefix::innerNode);
-        for(auto const& hh : mHashes)
-            hash_append(h, hh);
+        for (int i = 0; i < 16; ++i)
+            hash_append(h, getChildHash (i));
         nh = static_cast<typename
             sha512_half_hasher::result_type>(h);
     }
@@ -380,16 +472,70 @@ SHAMapInnerNode::updateHash()
 }
 
 void
-SHAMapInnerNode::updateHashDeep()
+SHAMapInnerNode::updateChildHashes()
 {
-    for (auto pos = 0; pos < 16; ++pos)
+    auto const count = popcount (mIsBranch);
+    for (int i = 0; i < count; ++i)
     {
-        if (mChildren[pos] != nullptr)
-            mHashes[pos] = mChildren[pos]->getNodeHash();
+        if (mSlots[i].child != nullptr)
+            mSlots[i].hash = mSlots[i].child->getNodeHash();
     }
+}
+
+void
+SHAMapInnerNode::updateHashDeep()
+{
+    updateChildHashes();
     updateHash();
 }
 
+void
+SHAMapAbstractNode::updateHashes (
+    std::vector<SHAMapAbstractNode*> const& nodes)
+{
+    // Every node hashes to the SHA512-Half of its prefixed serialization,
+    // so serialize a chunk of nodes and hash them together.
+    std::size_t const chunk = 256;
+    Serializer s (chunk * 600);
+    std::vector<std::pair<SHAMapAbstractNode*, std::size_t>> offsets;
+    std::vector<Slice> messages;
+    std::vector<uint256> hashes;
+
+    for (std::size_t first = 0; first < nodes.size (); first += chunk)
+    {
+        auto const last = std::min (first + chunk, nodes.size ());
+        s.erase ();
+        offsets.clear ();
+        for (auto i = first; i < last; ++i)
+        {
+            auto const node = nodes[i];
+            if (node->isInner () &&
+                static_cast<SHAMapInnerNode*>(node)->isEmpty ())
+            {
+                node->mHash.zero ();
+                continue;
+            }
+            offsets.emplace_back (node, s.size ());
+            node->addRaw (s, snfPREFIX);
+        }
+
+        auto const raw = s.slice ();
+        messages.clear ();
+        for (std::size_t i = 0; i < offsets.size (); ++i)
+        {
+            auto const end = (i + 1 < offsets.size ())
+                ? offsets[i + 1].second : raw.size ();
+            messages.emplace_back (raw.data () + offsets[i].second,
+                end - offsets[i].second);
+        }
+
+        hashes.resize (messages.size ());
+        sha512HalfBatch (messages.data (), hashes.data (), messages.size ());
+        for (std::size_t i = 0; i < offsets.size (); ++i)
+            offsets[i].first->mHash = SHAMapHash{hashes[i]};
+    }
+}
+
 bool
 SHAMapTreeNode::updateHash()
 {
@@ -441,18 +587,18 @@ SHAMapInnerNode::addRaw(Serializer& s, SHANodeFormat format) const
         {
             s.add32 (HashPrefix::innerNode);
 
-            for (auto const& hh : mHashes)
-                s.add256 (hh.as_uint256());
+            for (int i = 0; i < 16; ++i)
+                s.add256 (getChildHash (i).as_uint256());
         }
         else  // format == snfWIRE
         {
             if (getBranchCount () < 12)
             {
                 // compressed node
-                for (int i = 0; i < mHashes.size(); ++i)
+                for (int i = 0; i < 16; ++i)
                     if (!isEmptyBranch (i))
                     {
-                        s.add256 (mHashes[i].as_uint256());
+                        s.add256 (getChildHash (i).as_uint256());
                         s.add8 (i);
                     }
 
@@ -460,8 +606,8 @@ SHAMapInnerNode::addRaw(Serializer& s, SHANodeFormat format) const
             }
             else
             {
-                for (auto const& hh : mHashes)
-                    s.add256 (hh.as_uint256());
+                for (int i = 0; i < 16; ++i)
+                    s.add256 (getChildHash (i).as_uint256());
 
                 s.add8 (2);
             }
@@ -479,7 +625,7 @@ SHAMapInnerNodeV2::addRaw(Serializer& s, SHANodeFormat format) const
         s.add32 (HashPrefix::innerNodeV2);
 
         for (int i = 0 ; i < 16; ++i)
-            s.add256 (mHashes[i].as_uint256());
+            s.add256 (getChildHash (i).as_uint256());
 
         s.add8(depth_);
 
@@ -592,13 +738,7 @@ bool SHAMapInnerNode::isEmpty () const
 int SHAMapInnerNode::getBranchCount () const
 {
     assert (isInner ());
-    int count = 0;
-
-    for (int i = 0; i < 16; ++i)
-        if (!isEmptyBranch (i))
-            ++count;
-
-    return count;
+    return popcount (mIsBranch);
 }
 
 #ifdef BEAST_DEBUG
@@ -627,14 +767,14 @@ std::string
 SHAMapInnerNode::getString(const SHAMapNodeID & id) const
 {
     std::string ret = SHAMapAbstractNode::getString(id);
-    for (int i = 0; i < mHashes.size(); ++i)
+    for (int i = 0; i < 16; ++i)
     {
         if (!isEmptyBranch (i))
         {
             ret += "\nb";
             ret += beast::lexicalCastThrow <std::string> (i);
             ret += " = ";
-            ret += to_string (mHashes[i]);
+            ret += to_string (getChildHash (i));
         }
     }
     return ret;
@@ -670,13 +810,19 @@ SHAMapInnerNode::setChild(int m, std::shared_ptr<SHAMapAbstractNode> const& chil
     assert (mType == tnINNER);
     assert (mSeq != 0);
     assert (child.get() != this);
-    mHashes[m].zero();
     mHash.zero();
     if (child)
-        mIsBranch |= (1 << m);
-    else
-        mIsBranch &= ~ (1 << m);
-    mChildren[m] = child;
+    {
+        auto slot = findSlot (m);
+        if (! slot)
+            slot = &insertSlot (m);
+        slot->hash.zero();
+        slot->child = child;
+    }
+    else if (! isEmptyBranch (m))
+    {
+        eraseSlot (m);
+    }
 }
 
 // finished modifying, now make shareable
@@ -687,8 +833,9 @@ void SHAMapInnerNode::shareChild (int m, std::shared_ptr<SHAMapAbstractNode> con
     assert (mSeq != 0);
     assert (child);
     assert (child.get() != this);
+    assert (!isEmptyBranch (m));
 
-    mChildren[m] = child;
+    mSlots[slotIndex (m)].child = child;
 }
 
 SHAMapAbstractNode*
@@ -697,8 +844,10 @@ SHAMapInnerNode::getChildPointer (int branch)
     assert (branch >= 0 && branch < 16);
     assert (isInner());
 
-    std::lock_guard <std::mutex> lock (childLock);
-    return mChildren[branch].get ();
+    std::lock_guard <std::mutex> lock (childLock ());
+    if (auto const slot = findSlot (branch))
+        return slot->child.get ();
+    return nullptr;
 }
 
 std::shared_ptr<SHAMapAbstractNode>
@@ -707,8 +856,10 @@ SHAMapInnerNode::getChild (int branch)
     assert (branch >= 0 && branch < 16);
     assert (isInner());
 
-    std::lock_guard <std::mutex> lock (childLock);
-    return mChildren[branch];
+    std::lock_guard <std::mutex> lock (childLock ());
+    if (auto const slot = findSlot (branch))
+        return slot->child;
+    return {};
 }
 
 std::shared_ptr<SHAMapAbstractNode>
@@ -717,20 +868,22 @@ SHAMapInnerNode::canonicalizeChild(int branch, std::shared_ptr<SHAMapAbstractNod
     assert (branch >= 0 && branch < 16);
     assert (isInner());
     assert (node);
-    assert (node->getNodeHash() == mHashes[branch]);
+    assert (node->getNodeHash() == getChildHash (branch));
+    assert (!isEmptyBranch (branch));
 
-    std::lock_guard <std::mutex> lock (childLock);
-    if (mChildren[branch])
+    auto& child = mSlots[slotIndex (branch)].child;
+    std::lock_guard <std::mutex> lock (childLock ());
+    if (child)
     {
         // There is already a node hooked up, return it
-        node = mChildren[branch];
+        node = child;
     }
     else
     {
         // Hook this node up
         // node must not be a v2 inner node
         assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(node) == nullptr);
-        mChildren[branch] = node;
+        child = node;
     }
     return node;
 }
@@ -741,13 +894,15 @@ SHAMapInnerNodeV2::canonicalizeChild(int branch, std::shared_ptr<SHAMapAbstractN
     assert (branch >= 0 && branch < 16);
     assert (isInner());
     assert (node);
-    assert (node->getNodeHash() == mHashes[branch]);
+    assert (node->getNodeHash() == getChildHash (branch));
+    assert (!isEmptyBranch (branch));
 
-    std::lock_guard <std::mutex> lock (childLock);
-    if (mChildren[branch])
+    auto& child = mSlots[slotIndex (branch)].child;
+    std::lock_guard <std::mutex> lock (childLock ());
+    if (child)
     {
         // There is already a node hooked up, return it
-        node = mChildren[branch];
+        node = child;
     }
     else
     {
@@ -755,7 +910,7 @@ SHAMapInnerNodeV2::canonicalizeChild(int branch, std::shared_ptr<SHAMapAbstractN
         // node must not be a v1 inner node
         assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(node) != nullptr ||
                std::dynamic_pointer_cast<SHAMapTreeNode>(node)    != nullptr);
-        mChildren[branch] = node;
+        child = node;
     }
     return node;
 }
@@ -827,10 +982,8 @@ SHAMapInnerNodeV2::setChildren(std::shared_ptr<SHAMapTreeNode> const& child1,
         b2 = *k2 >> 4;
         depth_ = 2*depth_;
     }
-    mChildren[b1] = child1;
-    mIsBranch |= 1 << b1;
-    mChildren[b2] = child2;
-    mIsBranch |= 1 << b2;
+    insertSlot (b1).child = child1;
+    insertSlot (b2).child = child2;
 }
 
 void
@@ -868,11 +1021,11 @@ SHAMapInnerNode::invariants(bool is_v2, bool is_root) const
     unsigned count = 0;
     for (int i = 0; i < 16; ++i)
     {
-        if (mHashes[i].isNonZero())
+        if (getChildHash (i).isNonZero())
         {
             assert((mIsBranch & (1 << i)) != 0);
-            if (mChildren[i] != nullptr)
-                mChildren[i]->invariants(is_v2);
+            if (auto const& child = mSlots[slotIndex (i)].child)
+                child->invariants(is_v2);
             ++count;
         }
         else
@@ -896,21 +1049,21 @@ SHAMapInnerNodeV2::invariants(bool is_v2, bool is_root) const
     unsigned count = 0;
     for (int i = 0; i < 16; ++i)
     {
-        if (mHashes[i].isNonZero())
+        if (getChildHash (i).isNonZero())
         {
             assert((mIsBranch & (1 << i)) != 0);
-            if (mChildren[i] != nullptr)
+            if (auto const& child = mSlots[slotIndex (i)].child)
             {
-                assert(mHashes[i] == mChildren[i]->getNodeHash());
+                assert(getChildHash (i) == child->getNodeHash());
 #ifndef NDEBUG
-                auto const& childID = mChildren[i]->key();
+                auto const& childID = child->key();
 
                 // Make sure this child it attached to the correct branch
                 SHAMapNodeID nodeID {depth(), common()};
                 assert (i == nodeID.selectBranch(childID));
 #endif
                 assert(has_common_prefix(childID));
-                mChildren[i]->invariants(is_v2);
+                child->invariants(is_v2);
             }
             ++count;
         }
@@ -0,0 +1,212 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/shamap/TreeNodeSnapshot.h>
+#include <ripple/basics/contract.h>
+#include <ripple/basics/Log.h>
+#include <ripple/protocol/Protocol.h>
+#include <ripple/protocol/Serializer.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace ripple {
+
+namespace {
+
+// Identifies a snapshot, and its byte order
+std::uint64_t const snapshotMagic = 0x313050414e534e54ull; // "TNSNAP01"
+
+// Size of the blocks used to read and write the file
+std::size_t const blockSize = 4 * 1024 * 1024;
+
+// Each node is stored as its hash, its size and its prefixed form
+std::size_t const recordHeader = uint256::bytes + sizeof(std::uint32_t);
+
+// A leaf holds at most a transaction and its metadata, so a larger
+// record means the file is damaged.
+std::uint32_t const maxRecordSize = 2 * txMaxSizeBytes;
+
+} // namespace
+
+std::size_t
+saveTreeNodeSnapshot (Family& family,
+    boost::filesystem::path const& path, std::size_t maxNodes)
+{
+    auto& cache = family.treecache();
+
+    // Saving must not keep nodes in the cache that would have expired
+    auto nodes = cache.getValues();
+
+    std::stable_partition (nodes.begin(), nodes.end(),
+        [](std::shared_ptr<SHAMapAbstractNode> const& node)
+        {
+            return node->isInner();
+        });
+    if (nodes.size() > maxNodes)
+        nodes.resize (maxNodes);
+
+    auto const temp = path.string() + ".tmp";
+    std::ofstream out (temp, std::ios::binary | std::ios::trunc);
+    if (! out)
+        Throw<std::runtime_error> ("Unable to create " + temp);
+
+    Blob block;
+    block.reserve (blockSize + 4096);
+    block.resize (sizeof(snapshotMagic));
+    std::memcpy (block.data(), &snapshotMagic, sizeof(snapshotMagic));
+
+    Serializer s;
+    for (auto const& node : nodes)
+    {
+        s.erase();
+        node->addRaw (s, snfPREFIX);
+        if (s.size() > maxRecordSize)
+            continue;
+
+        auto const offset = block.size();
+        std::uint32_t const size = s.size();
+        block.resize (offset + recordHeader + size);
+        std::memcpy (&block[offset],
+            node->getNodeHash().as_uint256().data(), uint256::bytes);
+        std::memcpy (&block[offset + uint256::bytes], &size, sizeof(size));
+        std::memcpy (&block[offset + recordHeader], s.data(), size);
+
+        if (block.size() >= blockSize)
+        {
+            out.write (reinterpret_cast<char const*>(block.data()),
+                block.size());
+            block.clear();
+        }
+    }
+    out.write (reinterpret_cast<char const*>(block.data()), block.size());
+    out.close();
+    if (! out)
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove (temp, ec);
+        Throw<std::runtime_error> ("Unable to write " + temp);
+    }
+
+    boost::filesystem::rename (temp, path);
+    return nodes.size();
+}
+
+std::vector<std::shared_ptr<SHAMapAbstractNode>>
+loadTreeNodeSnapshot (Family& family,
+    boost::filesystem::path const& path)
+{
+    std::vector<std::shared_ptr<SHAMapAbstractNode>> nodes;
+
+    std::ifstream in (path.string(), std::ios::binary);
+    if (! in)
+        return nodes;
+
+    auto const j = family.journal();
+    auto& cache = family.treecache();
+
+    Blob block (blockSize);
+    std::size_t begin = 0;
+    std::size_t end = 0;
+
+    // Make sure at least `n` unread bytes are in the block
+    auto const fill = [&](std::size_t n)
+    {
+        if (end - begin >= n)
+            return true;
+        if (begin != 0)
+        {
+            std::memmove (block.data(), &block[begin], end - begin);
+            end -= begin;
+            begin = 0;
+        }
+        if (block.size() < n)
+            block.resize (n);
+        while (end < n && in)
+        {
+            in.read (reinterpret_cast<char*>(&block[end]),
+                block.size() - end);
+            end += in.gcount();
+        }
+        return end >= n;
+    };
+
+    std::uint64_t magic = 0;
+    if (fill (sizeof(magic)))
+        std::memcpy (&magic, block.data(), sizeof(magic));
+    if (magic != snapshotMagic)
+    {
+        JLOG(j.warn()) << "Tree node snapshot " << path.string() <<
+            " is not valid";
+        return nodes;
+    }
+    begin += sizeof(magic);
+
+    while (fill (recordHeader))
+    {
+        uint256 hash;
+        std::uint32_t size;
+        std::memcpy (hash.data(), &block[begin], uint256::bytes);
+        std::memcpy (&size, &block[begin + uint256::bytes], sizeof(size));
+        begin += recordHeader;
+
+        if (size > maxRecordSize)
+        {
+            JLOG(j.warn()) << "Tree node snapshot " << path.string() <<
+                " is damaged after " << nodes.size() << " nodes";
+            return nodes;
+        }
+
+        if (! fill (size))
+            break;
+
+        std::shared_ptr<SHAMapAbstractNode> node;
+        try
+        {
+            node = SHAMapAbstractNode::make (
+                Slice (&block[begin], size), 0, snfPREFIX,
+                    SHAMapHash{hash}, false, j);
+        }
+        catch (std::exception const&)
+        {
+        }
+        if (! node || node->getNodeHash().as_uint256() != hash)
+        {
+            JLOG(j.warn()) << "Tree node snapshot " << path.string() <<
+                " is damaged after " << nodes.size() << " nodes";
+            return nodes;
+        }
+        begin += size;
+
+        cache.canonicalize (hash, node);
+        nodes.push_back (std::move (node));
+    }
+
+    if (begin != end)
+    {
+        JLOG(j.warn()) << "Tree node snapshot " << path.string() <<
+            " is truncated after " << nodes.size() << " nodes";
+    }
+    return nodes;
+}
+
+} // ripple
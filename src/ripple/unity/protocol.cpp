@@ -30,6 +30,7 @@
 #include <ripple/protocol/impl/Indexes.cpp>
 #include <ripple/protocol/impl/Issue.cpp>
 #include <ripple/protocol/impl/Keylet.cpp>
+#include <ripple/protocol/impl/LazySLE.cpp>
 #include <ripple/protocol/impl/LedgerFormats.cpp>
 #include <ripple/protocol/impl/PublicKey.cpp>
 #include <ripple/protocol/impl/Quality.cpp>
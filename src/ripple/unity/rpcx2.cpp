@@ -31,6 +31,8 @@
 #include <ripple/rpc/handlers/Peers.cpp>
 #include <ripple/rpc/handlers/Ping.cpp>
 #include <ripple/rpc/handlers/Print.cpp>
+#include <ripple/rpc/handlers/RPCCache.cpp>
+#include <ripple/rpc/handlers/RPCCosts.cpp>
 #include <ripple/rpc/handlers/Random.cpp>
 #include <ripple/rpc/handlers/RipplePathFind.cpp>
 #include <ripple/rpc/handlers/ServerInfo.cpp>
@@ -53,11 +55,14 @@
 #include <ripple/rpc/handlers/WalletPropose.cpp>
 #include <ripple/rpc/handlers/WalletSeed.cpp>
 
+#include <ripple/rpc/impl/Admission.cpp>
 #include <ripple/rpc/impl/Handler.cpp>
 #include <ripple/rpc/impl/LegacyPathFind.cpp>
 #include <ripple/rpc/impl/Role.cpp>
+#include <ripple/rpc/impl/RPCCost.cpp>
 #include <ripple/rpc/impl/RPCHandler.cpp>
 #include <ripple/rpc/impl/RPCHelpers.cpp>
+#include <ripple/rpc/impl/ResponseCache.cpp>
 #include <ripple/rpc/impl/ServerHandlerImp.cpp>
 #include <ripple/rpc/impl/Status.cpp>
 #include <ripple/rpc/impl/TransactionSign.cpp>
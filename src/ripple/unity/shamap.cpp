@@ -25,3 +25,4 @@
 #include <ripple/shamap/impl/SHAMapNodeID.cpp>
 #include <ripple/shamap/impl/SHAMapSync.cpp>
 #include <ripple/shamap/impl/SHAMapTreeNode.cpp>
+#include <ripple/shamap/impl/TreeNodeSnapshot.cpp>
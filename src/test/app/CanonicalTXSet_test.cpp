@@ -0,0 +1,380 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/protocol/TxFormats.h>
+#include <test/unit_test/bench_args.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <tuple>
+
+namespace ripple {
+namespace test {
+
+namespace detail {
+
+inline
+std::shared_ptr<STTx const>
+makeTx (AccountID const& account, std::uint32_t seq,
+    std::uint32_t tag = 0)
+{
+    return std::make_shared<STTx const>(ttACCOUNT_SET,
+        [&](STObject& obj)
+        {
+            obj.setAccountID (sfAccount, account);
+            obj.setFieldU32 (sfSequence, seq);
+            // Makes otherwise identical transactions distinct
+            obj.setFieldU32 (sfSourceTag, tag);
+        });
+}
+
+inline
+AccountID
+makeAccount (std::uint64_t n)
+{
+    AccountID id;
+    auto const h = sha512Half (n);
+    std::memcpy (id.data (), h.data (), id.size ());
+    return id;
+}
+
+}
+
+class CanonicalTXSet_test : public beast::unit_test::suite
+{
+    void
+    testOrdering ()
+    {
+        testcase ("ordering");
+
+        CanonicalTXSet set (sha512Half (std::uint32_t(1)));
+        BEAST_EXPECT (set.empty ());
+
+        std::vector<std::shared_ptr<STTx const>> txs;
+        for (std::uint64_t a = 0; a < 10; ++a)
+            for (std::uint32_t s = 10; s > 0; --s)
+                txs.push_back (detail::makeTx (
+                    detail::makeAccount (a), s));
+
+        for (auto const& tx : txs)
+            set.insert (tx);
+        // Duplicates are ignored
+        set.insert (txs.front ());
+        set.insert (txs.back ());
+        BEAST_EXPECT (set.size () == txs.size ());
+
+        // Each account's transactions are consecutive and in
+        // sequence order
+        std::map<AccountID, std::uint32_t> lastSeq;
+        boost::optional<AccountID> prev;
+        for (auto const& item : set)
+        {
+            auto const account = item.second->getAccountID (sfAccount);
+            auto const seq = item.second->getSequence ();
+            if (prev && *prev != account)
+                BEAST_EXPECT (lastSeq.count (account) == 0);
+            auto const it = lastSeq.find (account);
+            BEAST_EXPECT (it == lastSeq.end () || it->second < seq);
+            lastSeq[account] = seq;
+            prev = account;
+        }
+        BEAST_EXPECT (lastSeq.size () == 10);
+    }
+
+    void
+    testErase ()
+    {
+        testcase ("erase");
+
+        CanonicalTXSet set (sha512Half (std::uint32_t(2)));
+        for (std::uint64_t a = 0; a < 5; ++a)
+            for (std::uint32_t s = 1; s <= 20; ++s)
+                set.insert (detail::makeTx (detail::makeAccount (a), s));
+
+        auto const before = [&]
+        {
+            std::vector<uint256> ids;
+            for (auto const& item : set)
+                ids.push_back (item.second->getTransactionID ());
+            return ids;
+        }();
+
+        // Erase every other entry in one pass
+        std::vector<uint256> expected;
+        bool drop = true;
+        for (auto it = set.begin (); it != set.end ();)
+        {
+            if (drop)
+            {
+                it = set.erase (it);
+            }
+            else
+            {
+                expected.push_back (it->second->getTransactionID ());
+                ++it;
+            }
+            drop = ! drop;
+        }
+        BEAST_EXPECT (set.size () == before.size () / 2);
+
+        // The survivors keep their relative order across passes
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            std::vector<uint256> ids;
+            for (auto const& item : set)
+                ids.push_back (item.second->getTransactionID ());
+            BEAST_EXPECT (ids == expected);
+        }
+
+        // A transaction can be inserted again after it was erased
+        set.insert (detail::makeTx (detail::makeAccount (0), 1));
+        BEAST_EXPECT (set.size () == before.size () / 2 + 1);
+
+        for (auto it = set.begin (); it != set.end ();)
+            it = set.erase (it);
+        BEAST_EXPECT (set.empty ());
+        BEAST_EXPECT (set.begin () == set.end ());
+    }
+
+    void
+    testPrune ()
+    {
+        testcase ("prune");
+
+        CanonicalTXSet set (sha512Half (std::uint32_t(3)));
+        auto const alice = detail::makeAccount (1);
+        auto const bob = detail::makeAccount (2);
+
+        for (std::uint32_t s = 1; s <= 3; ++s)
+        {
+            set.insert (detail::makeTx (alice, s, 1));
+            set.insert (detail::makeTx (alice, s, 2));
+            set.insert (detail::makeTx (bob, s));
+        }
+        BEAST_EXPECT (set.size () == 9);
+
+        auto const pruned = set.prune (alice, 2);
+        BEAST_EXPECT (pruned.size () == 2);
+        for (auto const& tx : pruned)
+        {
+            BEAST_EXPECT (tx->getAccountID (sfAccount) == alice);
+            BEAST_EXPECT (tx->getSequence () == 2);
+        }
+        BEAST_EXPECT (set.size () == 7);
+        BEAST_EXPECT (set.prune (alice, 2).empty ());
+        BEAST_EXPECT (set.prune (bob, 4).empty ());
+
+        set.reset (sha512Half (std::uint32_t(4)));
+        BEAST_EXPECT (set.empty ());
+
+        // Inserts between prunes, with some entries erased, are merged
+        // into the same order as a set built from scratch
+        auto const ids = [](CanonicalTXSet& s)
+        {
+            std::vector<uint256> result;
+            for (auto const& item : s)
+                result.push_back (item.second->getTransactionID ());
+            return result;
+        };
+        std::vector<std::shared_ptr<STTx const>> live;
+        for (std::uint32_t round = 0; round < 10; ++round)
+        {
+            for (std::uint64_t a = 0; a < 8; ++a)
+            {
+                auto tx = detail::makeTx (detail::makeAccount (a),
+                    (round * 7 + a * 3) % 11 + 1, round);
+                set.insert (tx);
+                live.push_back (std::move (tx));
+            }
+            // Insert one of them again
+            set.insert (live[live.size () / 2]);
+
+            auto it = set.begin ();
+            std::advance (it, set.size () / 3);
+            auto const erasedID = it->second->getTransactionID ();
+            set.erase (it);
+            live.erase (std::find_if (live.begin (), live.end (),
+                [&](std::shared_ptr<STTx const> const& tx)
+                {
+                    return tx->getTransactionID () == erasedID;
+                }));
+
+            auto const account = detail::makeAccount (round % 8);
+            auto const seq = (round * 5) % 11 + 1;
+            for (auto const& tx : set.prune (account, seq))
+                live.erase (std::find (live.begin (), live.end (), tx));
+
+            CanonicalTXSet expected (sha512Half (std::uint32_t(4)));
+            for (auto const& tx : live)
+                expected.insert (tx);
+            BEAST_EXPECT (ids (set) == ids (expected));
+        }
+    }
+
+public:
+    void
+    run () override
+    {
+        testOrdering ();
+        testErase ();
+        testPrune ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE (CanonicalTXSet, app, ripple);
+
+//------------------------------------------------------------------------------
+
+// Compares the flat CanonicalTXSet against an equivalent std::map,
+// the way consensus uses it: fill, then walk and erase over several
+// passes. The flat set sorts on the first walk, so that cost shows
+// up under "iterate". The argument lists the set sizes.
+class CanonicalTXSetBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+    using MapKey = std::tuple<uint256, std::uint32_t, uint256>;
+
+    static
+    std::chrono::microseconds
+    since (clock_type::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds> (
+            clock_type::now () - start);
+    }
+
+    void
+    report (char const* name, std::chrono::microseconds insert,
+        std::chrono::microseconds iterate, std::chrono::microseconds erase)
+    {
+        log << "    " << name <<
+            ": insert " << insert.count () << "us" <<
+            ", iterate " << iterate.count () << "us" <<
+            ", erase " << erase.count () << "us" << std::endl;
+    }
+
+    void
+    bench (std::size_t count)
+    {
+        testcase ("size " + std::to_string (count));
+
+        uint256 const salt = sha512Half (count);
+        beast::xor_shift_engine gen (count);
+        std::uniform_int_distribution<std::uint64_t> pick (0, count / 4);
+
+        std::vector<std::shared_ptr<STTx const>> txs;
+        txs.reserve (count);
+        for (std::size_t i = 0; i < count; ++i)
+            txs.push_back (detail::makeTx (
+                detail::makeAccount (pick (gen)), i));
+
+        // Retry passes erase a third of what's left every time
+        auto const keep = [](std::size_t i, int pass)
+        {
+            return (i + pass) % 3 != 0;
+        };
+        int const passes = 3;
+
+        {
+            CanonicalTXSet set (salt);
+            auto start = clock_type::now ();
+            for (auto const& tx : txs)
+                set.insert (tx);
+            auto const insert = since (start);
+
+            start = clock_type::now ();
+            std::size_t n = 0;
+            for (auto const& item : set)
+                n += item.second->getSequence () & 1;
+            auto const iterate = since (start);
+
+            start = clock_type::now ();
+            for (int pass = 0; pass < passes; ++pass)
+            {
+                std::size_t i = 0;
+                for (auto it = set.begin (); it != set.end (); ++i)
+                {
+                    if (keep (i, pass))
+                        ++it;
+                    else
+                        it = set.erase (it);
+                }
+            }
+            auto const erase = since (start);
+            BEAST_EXPECT (n <= count);
+            report ("CanonicalTXSet", insert, iterate, erase);
+        }
+
+        {
+            std::map<MapKey, std::shared_ptr<STTx const>> map;
+            auto start = clock_type::now ();
+            for (auto const& tx : txs)
+            {
+                uint256 account;
+                auto const id = tx->getAccountID (sfAccount);
+                std::memcpy (account.data (), id.data (), id.size ());
+                map.emplace (MapKey (account ^ salt, tx->getSequence (),
+                    tx->getTransactionID ()), tx);
+            }
+            auto const insert = since (start);
+
+            start = clock_type::now ();
+            std::size_t n = 0;
+            for (auto const& item : map)
+                n += item.second->getSequence () & 1;
+            auto const iterate = since (start);
+
+            start = clock_type::now ();
+            for (int pass = 0; pass < passes; ++pass)
+            {
+                std::size_t i = 0;
+                for (auto it = map.begin (); it != map.end (); ++i)
+                {
+                    if (keep (i, pass))
+                        ++it;
+                    else
+                        it = map.erase (it);
+                }
+            }
+            auto const erase = since (start);
+            BEAST_EXPECT (n <= count);
+            report ("std::map", insert, iterate, erase);
+        }
+    }
+
+public:
+    void
+    run () override
+    {
+        auto const sizes = benchSizes (arg (), { 1000, 10000, 100000 });
+
+        for (auto const size : sizes)
+            bench (size);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL (CanonicalTXSetBench, app, ripple);
+
+}
+}
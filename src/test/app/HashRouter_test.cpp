@@ -21,6 +21,10 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <test/unit_test/bench_args.h>
+#include <random>
+#include <thread>
 
 namespace ripple {
 namespace test {
@@ -264,6 +268,41 @@ class HashRouter_test : public beast::unit_test::suite
         BEAST_EXPECT(!router.shouldRecover(key1));
     }
 
+    void
+    testShards()
+    {
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 2s, 2, 16);
+
+        // Every entry behaves as it does in an unsharded table
+        for (std::uint64_t i = 1; i <= 100; ++i)
+        {
+            uint256 const key(i);
+            BEAST_EXPECT(router.addSuppressionPeer(key, 1));
+            BEAST_EXPECT(!router.addSuppressionPeer(key, 2));
+            BEAST_EXPECT(router.setFlags(key, SF_BAD));
+            BEAST_EXPECT(!router.setFlags(key, SF_BAD));
+            BEAST_EXPECT(router.getFlags(key) == SF_BAD);
+            auto const peers = router.shouldRelay(key);
+            BEAST_EXPECT(peers && peers->size() == 2);
+            BEAST_EXPECT(!router.shouldRelay(key));
+        }
+
+        ++stopwatch;
+        ++stopwatch;
+        ++stopwatch;
+
+        // Each shard expires its own stale entries when an entry
+        // is added to it. Enough new keys land in every shard.
+        for (std::uint64_t i = 1001; i <= 2000; ++i)
+            router.addSuppression(uint256(i));
+        for (std::uint64_t i = 1; i <= 100; ++i)
+            BEAST_EXPECT(router.getFlags(uint256(i)) == 0);
+        for (std::uint64_t i = 1001; i <= 2000; ++i)
+            BEAST_EXPECT(!router.addSuppressionPeer(uint256(i), 1));
+    }
+
 public:
 
     void
@@ -275,10 +314,79 @@ public:
         testSetFlags();
         testRelay();
         testRecover();
+        testShards();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(HashRouter, app, ripple);
 
+// Measures throughput when many peer threads hit the table at once,
+// with and without sharding, for each thread count in the argument.
+class HashRouterBench_test : public beast::unit_test::suite
+{
+    void
+    bench(std::size_t shards, std::size_t threads)
+    {
+        using namespace std::chrono;
+
+        std::size_t const opsPerThread = 200000;
+        HashRouter router(stopwatch(), HashRouter::getDefaultHoldTime(),
+            HashRouter::getDefaultRecoverLimit(), shards);
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        auto const start = steady_clock::now();
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&router, t, threads, opsPerThread]
+            {
+                beast::xor_shift_engine gen(t + 1);
+                std::uniform_int_distribution<std::uint64_t> dist;
+                for (std::size_t i = 0; i < opsPerThread; ++i)
+                {
+                    // Most messages are duplicates seen from
+                    // several peers.
+                    uint256 const key(dist(gen) % (opsPerThread / 4));
+                    auto const peer =
+                        static_cast<HashRouter::PeerShortID>(t + 1);
+                    int flags;
+                    if (router.addSuppressionPeer(key, peer, flags))
+                        router.setFlags(key, SF_TRUSTED);
+                    if (i % 4 == 0)
+                        router.shouldRelay(key);
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        auto const elapsed = duration_cast<microseconds>(
+            steady_clock::now() - start);
+
+        auto const ops = opsPerThread * threads;
+        log << "    " << shards << " shard" << (shards == 1 ? "" : "s") <<
+            ", " << threads << " thread" << (threads == 1 ? "" : "s") <<
+            ": " << (elapsed.count() ? ops * 1000000 / elapsed.count() : 0) <<
+            " ops/sec" << std::endl;
+        pass();
+    }
+
+public:
+    void
+    run()
+    {
+        auto const threadCounts = benchSizes(arg(), { 1, 2, 4, 8, 16 });
+
+        for (auto const shards :
+                { std::size_t(1), HashRouter::getDefaultShardCount() })
+        {
+            testcase(std::to_string(shards) + " shards");
+            for (auto const threads : threadCounts)
+                bench(shards, threads);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(HashRouterBench, app, ripple);
+
 }
 }
@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerHistory.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/beast/insight/NullCollector.h>
+#include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class LedgerHistory_test : public beast::unit_test::suite
+{
+    static
+    std::unique_ptr<Config>
+    nodeSize (int size)
+    {
+        auto cfg = jtx::envconfig();
+        cfg->NODE_SIZE = size;
+        return cfg;
+    }
+
+    // Build a chain of immutable ledgers following the genesis ledger
+    static
+    std::vector<std::shared_ptr<Ledger const>>
+    makeChain (jtx::Env& env, std::size_t count)
+    {
+        auto& config = env.app().config();
+        std::vector<std::shared_ptr<Ledger const>> chain;
+        auto prev = std::make_shared<Ledger>(
+            create_genesis, config,
+            std::vector<uint256>{}, env.app().family());
+        prev->setImmutable (config);
+        while (chain.size() < count)
+        {
+            auto next = std::make_shared<Ledger>(
+                *prev, env.app().timeKeeper().closeTime());
+            next->updateSkipList();
+            next->setImmutable (config);
+            chain.push_back (next);
+            prev = next;
+        }
+        return chain;
+    }
+
+    void
+    testNodeSize()
+    {
+        testcase ("pinned count follows node size");
+        using namespace jtx;
+
+        for (int size = 0; size < 5; ++size)
+        {
+            Env env {*this, nodeSize (size)};
+            LedgerHistory history (
+                beast::insight::NullCollector::New(), env.app());
+            BEAST_EXPECT(history.getRecentPinned() ==
+                env.app().config().getSize (siLedgerPinned));
+            BEAST_EXPECT(history.getFlagPinned() ==
+                env.app().config().getSize (siFlagLedgerPinned));
+        }
+
+        // A tiny node pins fewer ledgers and no flag ledgers
+        Env tiny {*this, nodeSize (0)};
+        Env huge {*this, nodeSize (4)};
+        LedgerHistory small (
+            beast::insight::NullCollector::New(), tiny.app());
+        LedgerHistory large (
+            beast::insight::NullCollector::New(), huge.app());
+        BEAST_EXPECT(small.getRecentPinned() < large.getRecentPinned());
+        BEAST_EXPECT(small.getFlagPinned() == 0);
+    }
+
+    void
+    testPinning()
+    {
+        testcase ("ring eviction and flag ledgers");
+        using namespace jtx;
+
+        Env env {*this, nodeSize (1)};
+        LedgerHistory history (
+            beast::insight::NullCollector::New(), env.app());
+        auto const recent = history.getRecentPinned();
+        BEAST_EXPECT(history.getFlagPinned() == 1);
+
+        // Sequences 2 through 601, which take in flag ledgers 256 and 512
+        auto const chain = makeChain (env, 600);
+        for (auto const& ledger : chain)
+            history.insert (ledger, true);
+        auto const last = chain.back()->info().seq;
+        BEAST_EXPECT(last == 601);
+
+        // The most recent ledgers are pinned
+        for (auto seq = last - recent + 1; seq <= last; ++seq)
+        {
+            auto const pinned = history.getPinnedLedger (seq);
+            BEAST_EXPECT(pinned && pinned->info().seq == seq);
+            BEAST_EXPECT(history.getLedgerHash (seq) ==
+                chain[seq - 2]->info().hash);
+        }
+
+        // Older ones were pushed out of the ring
+        BEAST_EXPECT(! history.getPinnedLedger (last - recent));
+        BEAST_EXPECT(! history.getPinnedLedger (300));
+
+        // Only the latest flag ledger is retained
+        BEAST_EXPECT(history.getPinnedLedger (512));
+        BEAST_EXPECT(! history.getPinnedLedger (256));
+
+        // Ledgers that are not validated are not pinned
+        {
+            auto const more = makeChain (env, 602);
+            history.insert (more.back(), false);
+            BEAST_EXPECT(! history.getPinnedLedger (603));
+            BEAST_EXPECT(history.getPinnedLedger (last));
+        }
+
+        // A repaired index is no longer served from the pinned set
+        BEAST_EXPECT(! history.fixIndex (last, chain[0]->info().hash));
+        BEAST_EXPECT(! history.getPinnedLedger (last));
+        BEAST_EXPECT(history.getPinnedLedger (last - 1));
+
+        // Clearing older history unpins it, flag ledgers included
+        history.clearLedgerCachePrior (last - 1);
+        BEAST_EXPECT(! history.getPinnedLedger (last - 2));
+        BEAST_EXPECT(! history.getPinnedLedger (512));
+        BEAST_EXPECT(history.getPinnedLedger (last - 1));
+    }
+
+    void
+    testCounters()
+    {
+        testcase ("lookups by sequence are counted");
+        using namespace jtx;
+
+        Env env {*this};
+        for (int i = 0; i < 5; ++i)
+            env.close();
+
+        auto& lm = env.app().getLedgerMaster();
+        auto const valid = lm.getValidLedgerIndex();
+        BEAST_EXPECT(valid > 3);
+
+        auto const start = lm.getSeqLookupStats();
+
+        // The validated ledger, and earlier ledgers reached through
+        // the validated ledger, are served from memory
+        BEAST_EXPECT(lm.getLedgerBySeq (valid));
+        BEAST_EXPECT(lm.getLedgerBySeq (valid - 1));
+        BEAST_EXPECT(lm.getLedgerBySeq (valid - 2));
+        auto const hits = lm.getSeqLookupStats();
+        BEAST_EXPECT(hits.hits == start.hits + 3);
+        BEAST_EXPECT(hits.misses == start.misses);
+
+        // A ledger we don't have is a miss
+        BEAST_EXPECT(! lm.getLedgerBySeq (valid + 100));
+        auto const misses = lm.getSeqLookupStats();
+        BEAST_EXPECT(misses.hits == hits.hits);
+        BEAST_EXPECT(misses.misses == hits.misses + 1);
+    }
+
+public:
+    void
+    run() override
+    {
+        testNodeSize();
+        testPinning();
+        testCounters();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerHistory,app,ripple);
+
+} // test
+} // ripple
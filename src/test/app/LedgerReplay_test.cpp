@@ -0,0 +1,206 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerReplayer.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Indexes.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class LedgerReplay_test : public beast::unit_test::suite
+{
+    // Close a few ledgers with payments and offers in them
+    static
+    void
+    populate (jtx::Env& env)
+    {
+        using namespace jtx;
+        Account const gw {"gateway"};
+        auto const USD = gw["USD"];
+
+        env.fund (XRP(100000), gw, "alice", "bob", "carol");
+        env.close();
+        env.trust (USD(1000), "alice", "bob", "carol");
+        env.close();
+        for (int i = 0; i < 5; ++i)
+        {
+            env (pay (gw, "alice", USD(10)));
+            env (pay ("alice", "bob", XRP(100 + i)));
+            env (offer ("carol", XRP(50), USD(5)));
+            env (offer ("alice", USD(1), XRP(10)));
+            env.close();
+        }
+    }
+
+    static
+    LedgerReplayer::Fetch
+    fetchFrom (jtx::Env& env)
+    {
+        return [&env](std::uint32_t seq)
+        {
+            return env.app().getLedgerMaster().getLedgerBySeq (seq);
+        };
+    }
+
+    void
+    testReplayLedger()
+    {
+        testcase ("replay one ledger");
+        using namespace jtx;
+
+        Env env {*this};
+        populate (env);
+
+        auto& lm = env.app().getLedgerMaster();
+        auto const last = env.closed()->info().seq;
+        for (auto seq = last - 4; seq <= last; ++seq)
+        {
+            auto const parent = lm.getLedgerBySeq (seq - 1);
+            auto const ledger = lm.getLedgerBySeq (seq);
+            if (! BEAST_EXPECT(parent && ledger))
+                continue;
+            std::size_t count = 0;
+            auto const built = replayLedger (env.app(),
+                *parent, *ledger, count, env.journal);
+            BEAST_EXPECT(count == 4);
+            BEAST_EXPECT(built->info().hash == ledger->info().hash);
+        }
+    }
+
+    void
+    testRange (std::size_t workers)
+    {
+        testcase ("replay range, " + std::to_string (workers) + " workers");
+        using namespace jtx;
+
+        Env env {*this};
+        populate (env);
+
+        LedgerReplayer::Setup setup;
+        setup.first = 3;
+        setup.last = env.closed()->info().seq;
+        setup.workers = workers;
+
+        std::size_t reports = 0;
+        LedgerReplayer replayer (env.app(), setup,
+            fetchFrom (env), env.journal);
+        auto const result = replayer.run (
+            [&](LedgerReplayer::Progress const&) { ++reports; });
+
+        std::size_t transactions = 0;
+        for (auto seq = setup.first; seq <= setup.last; ++seq)
+        {
+            auto const ledger =
+                env.app().getLedgerMaster().getLedgerBySeq (seq);
+            transactions += std::distance (
+                ledger->txs.begin(), ledger->txs.end());
+        }
+
+        BEAST_EXPECT(result.ledgers == setup.last - setup.first + 1);
+        BEAST_EXPECT(result.transactions == transactions);
+        BEAST_EXPECT(result.mismatches == 0);
+        BEAST_EXPECT(replayer.mismatches().empty());
+        BEAST_EXPECT(reports >= 1);
+    }
+
+    void
+    testMismatch()
+    {
+        testcase ("mismatch");
+        using namespace jtx;
+
+        Env env {*this};
+        Account const alice {"alice"};
+        populate (env);
+
+        // An empty ledger, so a copy of its parent with one entry
+        // changed differs from it in exactly that entry
+        env.close();
+        env.close();
+
+        auto& lm = env.app().getLedgerMaster();
+        auto const last = env.closed()->info().seq;
+        auto const bad = last - 1;
+        auto const parent = lm.getLedgerBySeq (bad - 1);
+        auto const real = lm.getLedgerBySeq (bad);
+        if (! BEAST_EXPECT(parent && real && real->txs.empty()))
+            return;
+
+        auto const& info = real->info();
+        auto const fake = std::make_shared<Ledger> (*parent, info.closeTime);
+        auto const sle = std::make_shared<SLE> (
+            *fake->read (keylet::account (alice.id())));
+        sle->setFieldAmount (sfBalance, XRP(1));
+        fake->rawReplace (sle);
+        fake->updateSkipList();
+        fake->setAccepted (info.closeTime, info.closeTimeResolution,
+            getCloseAgree (info), env.app().config());
+
+        LedgerReplayer::Setup setup;
+        setup.first = 3;
+        setup.last = last;
+        setup.workers = 3;
+
+        LedgerReplayer replayer (env.app(), setup,
+            [&env, &fake, bad](std::uint32_t seq)
+                -> std::shared_ptr<Ledger const>
+            {
+                if (seq == bad)
+                    return fake;
+                return env.app().getLedgerMaster().getLedgerBySeq (seq);
+            },
+            env.journal);
+        auto const result = replayer.run();
+
+        BEAST_EXPECT(result.mismatches == 2);
+        auto const& found = replayer.mismatches();
+        if (! BEAST_EXPECT(found.size() == 2))
+            return;
+
+        BEAST_EXPECT(found[0].seq == bad);
+        BEAST_EXPECT(found[0].reason == "state does not match");
+        BEAST_EXPECT(found[0].expected == fake->info().hash);
+        BEAST_EXPECT(found[0].actual == info.hash);
+        BEAST_EXPECT(found[0].keys.size() == 1 &&
+            found[0].keys[0] == keylet::account (alice.id()).key);
+
+        BEAST_EXPECT(found[1].seq == last);
+        BEAST_EXPECT(found[1].reason == "parent hash does not match");
+    }
+
+public:
+    void
+    run() override
+    {
+        testReplayLedger();
+        testRange (1);
+        testRange (3);
+        testMismatch();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerReplay,app,ripple);
+
+} // test
+} // ripple
@@ -426,6 +426,19 @@ public:
         ledgerCheck(env, ledgerSeq - 2, 2);
         BEAST_EXPECT(lastRotated == store.getLastRotated());
 
+        // Each validated ledger's state was copied ahead of the rotation
+        {
+            auto const copy = store.getCopyProgress();
+            BEAST_EXPECT(copy && ! copy->copying);
+            BEAST_EXPECT(copy && copy->ledger == ledgerSeq - 1);
+            BEAST_EXPECT(copy &&
+                copy->nextRotation == lastRotated + deleteInterval);
+
+            auto const info = env.rpc("server_info");
+            BEAST_EXPECT(info[jss::result][jss::info].isMember(
+                jss::online_delete));
+        }
+
         {
             // Closing one more ledger triggers a rotate
             env.close();
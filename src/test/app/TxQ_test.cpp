@@ -33,6 +33,9 @@
 #include <test/jtx/ticket.h>
 #include <boost/optional.hpp>
 #include <test/jtx/WSClient.h>
+#include <test/unit_test/bench_args.h>
+#include <atomic>
+#include <thread>
 
 namespace ripple {
 
@@ -2806,5 +2809,175 @@ public:
 
 BEAST_DEFINE_TESTSUITE(TxQ,app,ripple);
 
+// Measures how the queue behaves when it is very large. The
+// argument lists the queue sizes.
+class TxQBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static
+    std::unique_ptr<Config>
+    makeConfig(std::size_t queueSize)
+    {
+        auto p = test::jtx::envconfig();
+        auto& section = p->section("transaction_queue");
+        section.set("minimum_queue_size", std::to_string(queueSize));
+        section.set("maximum_txn_per_account",
+            std::to_string(txnPerAccount));
+        return p;
+    }
+
+    static
+    double
+    perSecond(std::size_t count, clock_type::duration elapsed)
+    {
+        using namespace std::chrono;
+        auto const us = duration_cast<microseconds>(elapsed).count();
+        return us ? count * 1000000.0 / us : 0.0;
+    }
+
+    static constexpr std::size_t txnPerAccount = 10;
+    // Keep the open ledger under the standalone escalation
+    // threshold while funding the accounts.
+    static constexpr std::size_t fundBatch = 500;
+    // Limit how many signed transactions are held at once.
+    static constexpr std::size_t signBatch = 10000;
+
+    void
+    bench(std::size_t queueSize)
+    {
+        using namespace jtx;
+
+        testcase ("queue size " + std::to_string(queueSize));
+
+        Env env(*this, makeConfig(queueSize));
+        auto& txq = env.app().getTxQ();
+
+        std::vector<Account> accounts;
+        auto const accountCount =
+            (queueSize + txnPerAccount - 1) / txnPerAccount;
+        accounts.reserve(accountCount);
+        for (std::size_t i = 0; i < accountCount; ++i)
+        {
+            accounts.emplace_back("bench" + std::to_string(i));
+            env.fund(XRP(1000), noripple(accounts.back()));
+            if (accounts.size() % fundBatch == 0)
+                env.close();
+        }
+        env.close();
+
+        // Fill the open ledger so everything else gets queued.
+        {
+            auto const metrics = txq.getMetrics(*env.current());
+            if (!BEAST_EXPECT(metrics))
+                return;
+            for (auto i = metrics->txInLedger;
+                    i <= metrics->txPerLedger; ++i)
+                env(noop(env.master));
+        }
+
+        std::vector<std::uint32_t> seqs;
+        seqs.reserve(accounts.size());
+        for (auto const& account : accounts)
+            seqs.push_back(env.seq(account));
+
+        // Enqueue
+        std::size_t queued = 0;
+        clock_type::duration applyTime{};
+        std::vector<std::shared_ptr<STTx const>> txns;
+        txns.reserve(signBatch);
+        for (std::size_t i = 0; i < queueSize;)
+        {
+            txns.clear();
+            for (; i < queueSize && txns.size() < signBatch; ++i)
+            {
+                auto const a = i % accounts.size();
+                // Vary the fee so the fee index isn't trivially
+                // ordered, but stay within the multi-txn limits.
+                txns.push_back(env.jt(noop(accounts[a]),
+                    seq(seqs[a]++),
+                        fee(drops(100 + (i * 7919) % 100))).stx);
+            }
+
+            auto const start = clock_type::now();
+            for (auto const& tx : txns)
+            {
+                env.app().openLedger().modify(
+                    [&](OpenView& view, beast::Journal j)
+                    {
+                        auto const result = txq.apply(env.app(),
+                            view, tx, tapNONE, j);
+                        if (result.first == terQUEUED)
+                            ++queued;
+                        return result.second;
+                    });
+            }
+            applyTime += clock_type::now() - start;
+        }
+        BEAST_EXPECT(queued == queueSize);
+
+        // Readers, like the RPC "fee" command, run on their own
+        // threads while the queue is accepted below
+        std::atomic<bool> accepting{true};
+        std::atomic<std::size_t> reads{0};
+        std::atomic<std::size_t> failedReads{0};
+        std::vector<std::thread> readers;
+        {
+            auto const view = env.current();
+            for (int i = 0; i < 4; ++i)
+            {
+                readers.emplace_back(
+                    [&txq, &accepting, &reads, &failedReads, view]()
+                    {
+                        while (accepting)
+                        {
+                            if (txq.getMetrics(*view))
+                                ++reads;
+                            else
+                                ++failedReads;
+                        }
+                    });
+            }
+        }
+
+        // Accept into a fresh open ledger
+        std::size_t accepted = 0;
+        clock_type::duration acceptTime{};
+        {
+            auto const closed = env.closed();
+            OpenView view(open_ledger, closed.get(), closed->rules());
+            auto const start = clock_type::now();
+            txq.accept(env.app(), view);
+            acceptTime = clock_type::now() - start;
+            accepted = view.txCount();
+        }
+
+        accepting = false;
+        for (auto& reader : readers)
+            reader.join();
+        BEAST_EXPECT(failedReads == 0);
+
+        log << "    enqueue: " << queued << " txns, " <<
+            perSecond(queued, applyTime) << " txns/sec" << std::endl;
+        log << "    accept: " << accepted << " txns, " <<
+            perSecond(accepted, acceptTime) << " txns/sec" << std::endl;
+        log << "    getMetrics during accept: " << readers.size() <<
+            " threads, " << perSecond(reads, acceptTime) <<
+                " calls/sec" << std::endl;
+    }
+
+public:
+    void
+    run()
+    {
+        auto const sizes = benchSizes(arg(), { 10000, 100000, 1000000 });
+
+        for (auto const size : sizes)
+            bench(size);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(TxQBench,app,ripple);
+
 }
 }
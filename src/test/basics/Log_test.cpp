@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/basics/Log.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class Log_test : public beast::unit_test::suite
+{
+    // Returns the messages in a log file, without the prefixes
+    static
+    std::vector<std::string>
+    readLog (std::string const& path)
+    {
+        std::vector<std::string> lines;
+        std::ifstream in (path);
+        std::string line;
+        while (std::getline (in, line))
+        {
+            auto const pos = line.find (" Test:");
+            if (pos != std::string::npos)
+                lines.push_back (line.substr (pos + 10));
+        }
+        return lines;
+    }
+
+    void
+    testOrder()
+    {
+        testcase ("order");
+
+        beast::temp_dir td;
+        auto const path = td.file ("debug.log");
+        Logs logs (beast::severities::kTrace);
+        logs.silent (true);
+        BEAST_EXPECT(logs.open (path));
+
+        // Each thread's messages arrive whole and in order
+        std::size_t const perThread = 2000;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back ([&logs, t, perThread]
+            {
+                auto j = logs.journal ("Test");
+                for (std::size_t i = 0; i < perThread; ++i)
+                    JLOG(j.info()) << t << " " << i;
+            });
+        for (auto& t : threads)
+            t.join();
+        logs.flush();
+
+        auto const lines = readLog (path);
+        BEAST_EXPECT(lines.size() == 4 * perThread);
+        std::vector<std::size_t> next (4, 0);
+        bool ordered = true;
+        for (auto const& line : lines)
+        {
+            auto const space = line.find (' ');
+            auto const t = std::stoul (line.substr (0, space));
+            auto const i = std::stoul (line.substr (space + 1));
+            if (t >= next.size() || i != next[t]++)
+                ordered = false;
+        }
+        BEAST_EXPECT(ordered);
+        BEAST_EXPECT(logs.dropped() == 0);
+    }
+
+    void
+    testRotate()
+    {
+        testcase ("rotate");
+
+        beast::temp_dir td;
+        auto const path = td.file ("debug.log");
+        auto const old = td.file ("debug.log.1");
+        Logs logs (beast::severities::kTrace);
+        logs.silent (true);
+        BEAST_EXPECT(logs.open (path));
+        auto j = logs.journal ("Test");
+
+        // Messages queued before the rotation go to the old file
+        JLOG(j.warn()) << "before";
+        boost::filesystem::rename (path, old);
+        logs.rotate();
+        JLOG(j.warn()) << "after";
+        logs.flush();
+
+        BEAST_EXPECT(readLog (old) == std::vector<std::string>{"before"});
+        BEAST_EXPECT(readLog (path) == std::vector<std::string>{"after"});
+    }
+
+    void
+    testFatal()
+    {
+        testcase ("fatal and shutdown");
+
+        beast::temp_dir td;
+        auto const path = td.file ("debug.log");
+        {
+            Logs logs (beast::severities::kTrace);
+            logs.silent (true);
+            BEAST_EXPECT(logs.open (path));
+            auto j = logs.journal ("Test");
+
+            // Fatal messages are on disk when write returns
+            JLOG(j.debug()) << "queued";
+            JLOG(j.fatal()) << "fatal";
+            BEAST_EXPECT(readLog (path) ==
+                std::vector<std::string>({"queued", "fatal"}));
+
+            JLOG(j.error()) << "last";
+        }
+
+        // Destroying the logs writes what is still queued
+        BEAST_EXPECT(readLog (path) ==
+            std::vector<std::string>({"queued", "fatal", "last"}));
+    }
+
+public:
+    void
+    run() override
+    {
+        testOrder();
+        testRotate();
+        testFatal();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Log,ripple_basics,ripple);
+
+} // ripple
@@ -22,6 +22,8 @@
 #include <ripple/basics/hardened_hash.h>
 #include <ripple/beast/unit_test.h>
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace ripple {
 namespace test {
@@ -99,6 +101,40 @@ struct base_uint_test : beast::unit_test::suite
 
         BEAST_EXPECT(compare(u, v) < 0);
         BEAST_EXPECT(compare(v, u) > 0);
+        BEAST_EXPECT(compare(u, u) == 0);
+
+        // The first byte is the most significant, and bytes compare
+        // as unsigned, so 0x80... orders above 0x7F...
+        {
+            Blob hi (test96::bytes, 0);
+            Blob lo (test96::bytes, 0xff);
+            hi[0] = 0x80;
+            lo[0] = 0x7f;
+            BEAST_EXPECT(compare(test96{hi}, test96{lo}) > 0);
+            BEAST_EXPECT(test96{lo} < test96{hi});
+
+            // Values that differ only in the last byte
+            Blob last (raw);
+            ++last.back();
+            BEAST_EXPECT(compare(u, test96{last}) < 0);
+            BEAST_EXPECT(test96{last} > u);
+        }
+
+        // Sorting agrees with the order of the hex strings
+        {
+            std::vector<test96> values;
+            std::uint8_t const firsts[] = { 0xff, 0x00, 0x80, 0x7f, 0x01 };
+            for (auto const first : firsts)
+            {
+                Blob b (raw);
+                b[0] = first;
+                values.emplace_back (b);
+            }
+            std::sort (values.begin(), values.end());
+            for (std::size_t i = 1; i < values.size(); ++i)
+                BEAST_EXPECT(to_string(values[i - 1]) <
+                    to_string(values[i]));
+        }
 
         v = u;
         BEAST_EXPECT(v == u);
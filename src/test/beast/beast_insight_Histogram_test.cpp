@@ -0,0 +1,222 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <ripple/beast/insight/Collector.h>
+#include <ripple/beast/insight/Groups.h>
+#include <ripple/beast/insight/Histogram.h>
+#include <ripple/beast/insight/NullCollector.h>
+#include <ripple/beast/unit_test.h>
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace beast {
+namespace insight {
+
+class Histogram_test : public unit_test::suite
+{
+public:
+    void
+    testBuckets()
+    {
+        testcase ("buckets");
+
+        // Every value falls in the bucket whose range holds it, and
+        // no bucket is wider than 1/16 of its smallest value
+        std::uint64_t const values[] = {0, 1, 31, 32, 33, 47, 48, 1000,
+            65535, 65536, 123456789, (1ull << 40) - 1};
+        bool ok = true;
+        for (auto const v : values)
+        {
+            auto const b = detail::histogramBucket (v);
+            auto const floor = detail::histogramBucketFloor (b);
+            auto const next = detail::histogramBucketFloor (b + 1);
+            if (v < floor || v >= next || (next - floor) * 16 > std::max<
+                    std::uint64_t> (floor, 16))
+                ok = false;
+        }
+        BEAST_EXPECT(ok);
+
+        // Buckets are contiguous
+        for (std::size_t b = 0; b + 1 < detail::histogramBuckets; ++b)
+        {
+            auto const next = detail::histogramBucketFloor (b + 1);
+            if (detail::histogramBucket (next - 1) != b ||
+                    detail::histogramBucket (next) != b + 1)
+                ok = false;
+        }
+        BEAST_EXPECT(ok);
+
+        // Huge values go in the last bucket
+        BEAST_EXPECT(detail::histogramBucket (1ull << 40) ==
+            detail::histogramBuckets - 1);
+        BEAST_EXPECT(detail::histogramBucket (~0ull) ==
+            detail::histogramBuckets - 1);
+    }
+
+    void
+    testPercentiles()
+    {
+        testcase ("percentiles");
+
+        HistogramImpl h ("test");
+        std::vector<std::uint64_t> values;
+        std::mt19937_64 rng (42);
+        std::lognormal_distribution<double> dist (8.0, 1.5);
+        for (int i = 0; i < 100000; ++i)
+        {
+            values.push_back (static_cast<std::uint64_t> (dist (rng)));
+            h.record (values.back());
+        }
+        std::sort (values.begin(), values.end());
+
+        auto const s = h.snapshot();
+        BEAST_EXPECT(s.count == values.size());
+        BEAST_EXPECT(s.max == values.back());
+        BEAST_EXPECT(s.name == "test");
+
+        // Within the relative width of one bucket
+        for (auto const p : {0.5, 0.9, 0.99, 0.999})
+        {
+            auto const exact = values[static_cast<std::size_t> (
+                p * values.size() + 0.5) - 1];
+            auto const estimate = s.percentile (p);
+            BEAST_EXPECT(estimate <= exact + exact / 16 + 1);
+            BEAST_EXPECT(estimate + exact / 16 + 1 >= exact);
+        }
+        BEAST_EXPECT(s.percentile (1.0) <= s.max);
+        BEAST_EXPECT(HistogramSnapshot{}.percentile (0.5) == 0);
+    }
+
+    void
+    testThreads()
+    {
+        testcase ("threads");
+
+        HistogramSet set;
+        auto const h = set.make ("Histogram_test.threads");
+        std::size_t const perThread = 50000;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t)
+            threads.emplace_back ([&h, t, perThread]
+            {
+                for (std::size_t i = 0; i < perThread; ++i)
+                    h.notify (std::chrono::microseconds (t * 1000 + i % 100));
+            });
+        for (auto& t : threads)
+            t.join();
+
+        auto const s = h.impl()->snapshot();
+        BEAST_EXPECT(s.count == 8 * perThread);
+        BEAST_EXPECT(s.max == 7 * 1000 + 99);
+        std::uint64_t sum = 0;
+        for (std::uint64_t t = 0; t < 8; ++t)
+            sum += perThread * (t * 1000) + (perThread / 100) * 4950;
+        BEAST_EXPECT(s.sum == sum);
+    }
+
+    void
+    testCollector()
+    {
+        testcase ("collector");
+
+        auto const collector = NullCollector::New();
+        auto const find = [&collector](std::string const& name)
+        {
+            for (auto const& s : collector->histograms())
+                if (s.name == name)
+                    return s;
+            return HistogramSnapshot{};
+        };
+
+        {
+            // A name gives the same histogram while it is in use
+            auto const a = collector->make_histogram ("Histogram_test.registry");
+            auto const b = collector->make_histogram ("Histogram_test.registry");
+            BEAST_EXPECT(a.impl() == b.impl());
+            a.record (10);
+            b.record (20);
+            b.record (30);
+            auto const s = find ("Histogram_test.registry");
+            BEAST_EXPECT(s.count == 3);
+            BEAST_EXPECT(s.sum == 60);
+            BEAST_EXPECT(s.max == 30);
+
+            // The values since an earlier snapshot
+            a.record (1000);
+            auto const d = find ("Histogram_test.registry").since (s);
+            BEAST_EXPECT(d.count == 1);
+            BEAST_EXPECT(d.sum == 1000);
+            BEAST_EXPECT(d.max >= 1000 && d.max < 1000 + 1000 / 16);
+
+            // Another collector keeps its own histograms
+            auto const other = NullCollector::New();
+            auto const c = other->make_histogram ("Histogram_test.registry");
+            BEAST_EXPECT(c.impl() != a.impl());
+            c.record (5);
+            auto const o = other->histograms();
+            BEAST_EXPECT(o.size() == 1 && o[0].count == 1);
+            BEAST_EXPECT(find ("Histogram_test.registry").count == 4);
+
+            // A group prefixes the name and reports the collector's histograms
+            auto const groups = make_Groups (collector);
+            auto const g = groups->get ("group")->make_histogram ("h");
+            g.record (7);
+            BEAST_EXPECT(find ("group.h").count == 1);
+
+            std::ostringstream os;
+            writePrometheus (os, "rippled", {s});
+            auto const text = os.str();
+            BEAST_EXPECT(text.find (
+                "# TYPE rippled_Histogram_test_registry_us summary\n") == 0);
+            BEAST_EXPECT(text.find (
+                "rippled_Histogram_test_registry_us{quantile=\"0.5\"} 20\n") !=
+                    std::string::npos);
+            BEAST_EXPECT(text.find (
+                "rippled_Histogram_test_registry_us_count 3\n") !=
+                    std::string::npos);
+        }
+
+        // Released histograms are no longer reported
+        BEAST_EXPECT(find ("Histogram_test.registry").count == 0);
+
+        // A null histogram ignores values
+        Histogram h;
+        h.record (1);
+        h.notify (std::chrono::seconds (1));
+        BEAST_EXPECT(! h.impl());
+    }
+
+    void
+    run() override
+    {
+        testBuckets();
+        testPercentiles();
+        testThreads();
+        testCollector();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Histogram,insight,beast);
+
+}
+}
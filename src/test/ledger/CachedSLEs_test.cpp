@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/ledger/CachedSLEs.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/beast/unit_test.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class CachedSLEs_test : public beast::unit_test::suite
+{
+    static
+    uint256
+    digest (std::uint32_t i)
+    {
+        return sha512Half (i);
+    }
+
+    static
+    std::shared_ptr<SLE const>
+    entry (std::uint32_t i)
+    {
+        return std::make_shared<SLE const> (
+            ltACCOUNT_ROOT, digest (i));
+    }
+
+    void
+    testFetch()
+    {
+        testcase ("fetch");
+
+        TestStopwatch clock;
+        CachedSLEs cache (std::chrono::seconds (10), clock);
+
+        int calls = 0;
+        auto const load = [&] { ++calls; return entry (1); };
+        auto const first = cache.fetch (digest (1), load);
+        auto const second = cache.fetch (digest (1), load);
+        BEAST_EXPECT(first && first == second);
+        BEAST_EXPECT(calls == 1);
+
+        // Missing entries are not cached
+        BEAST_EXPECT(! cache.fetch (digest (2), [] {
+            return std::shared_ptr<SLE const>{}; }));
+
+        auto stats = cache.getStats();
+        BEAST_EXPECT(stats.hits == 1);
+        BEAST_EXPECT(stats.misses == 1);
+        BEAST_EXPECT(stats.size == 1);
+        BEAST_EXPECT(cache.rate() == 0.5);
+
+        cache.addViewStats (7, 2);
+        stats = cache.getStats();
+        BEAST_EXPECT(stats.viewHits == 7);
+        BEAST_EXPECT(stats.contended == 2);
+    }
+
+    void
+    testBounded()
+    {
+        testcase ("bounded");
+
+        TestStopwatch clock;
+        CachedSLEs cache (std::chrono::seconds (10), clock, 64, 4);
+
+        for (std::uint32_t i = 0; i < 1000; ++i)
+        {
+            clock.advance (std::chrono::milliseconds (1));
+            cache.fetch (digest (i), [i] { return entry (i); });
+        }
+        auto const stats = cache.getStats();
+        BEAST_EXPECT(stats.size <= 64);
+        BEAST_EXPECT(stats.size + stats.evicted == 1000);
+
+        // The most recent entry survives
+        int calls = 0;
+        cache.fetch (digest (999), [&] { ++calls; return entry (999); });
+        BEAST_EXPECT(calls == 0);
+    }
+
+    void
+    testExpire()
+    {
+        testcase ("expire");
+
+        TestStopwatch clock;
+        CachedSLEs cache (std::chrono::seconds (10), clock);
+
+        auto const held = cache.fetch (digest (1), [] { return entry (1); });
+        cache.fetch (digest (2), [] { return entry (2); });
+        cache.fetch (digest (3), [] { return entry (3); });
+        BEAST_EXPECT(cache.getStats().size == 3);
+
+        cache.expire();
+        BEAST_EXPECT(cache.getStats().size == 3);
+
+        // Entries still in use elsewhere are kept
+        clock.advance (std::chrono::seconds (11));
+        cache.expire();
+        BEAST_EXPECT(cache.getStats().size == 1);
+        BEAST_EXPECT(cache.fetch (digest (1), [] {
+            return std::shared_ptr<SLE const>{}; }) == held);
+    }
+
+    void
+    testThreads()
+    {
+        testcase ("threads");
+
+        TestStopwatch clock;
+        CachedSLEs cache (std::chrono::seconds (10), clock);
+
+        std::uint32_t const keys = 256;
+        std::atomic<int> wrong {0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back ([&, t]
+            {
+                for (std::uint32_t n = 0; n < 20000; ++n)
+                {
+                    auto const i = (n * 7 + t) % keys;
+                    auto const sle = cache.fetch (
+                        digest (i), [i] { return entry (i); });
+                    if (! sle || sle->key() != digest (i))
+                        ++wrong;
+                }
+            });
+        for (auto& t : threads)
+            t.join();
+
+        auto const stats = cache.getStats();
+        BEAST_EXPECT(wrong == 0);
+        BEAST_EXPECT(stats.size == keys);
+        BEAST_EXPECT(stats.hits + stats.misses == 4 * 20000);
+    }
+
+public:
+    void
+    run() override
+    {
+        testFetch();
+        testBounded();
+        testExpire();
+        testThreads();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(CachedSLEs,ledger,ripple);
+
+} // ripple
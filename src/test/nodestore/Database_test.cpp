@@ -21,13 +21,61 @@
 #include <test/nodestore/TestBase.h>
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/KeyFilter.h>
 #include <ripple/beast/utility/temp_dir.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
 
 namespace ripple {
 namespace NodeStore {
 
 class Database_test : public TestBase
 {
+    // Keeps the warnings, to tell a loaded key filter from a rebuilt one
+    class TestSink : public beast::Journal::Sink
+    {
+    public:
+        std::stringstream strm_;
+
+        TestSink () : Sink (beast::severities::kWarning, false) {  }
+
+        void
+        write (beast::severities::Severity level,
+            std::string const& text) override
+        {
+            if (level < threshold())
+                return;
+
+            strm_ << text << std::endl;
+        }
+
+        // Returns whether a filter was rebuilt since the last call
+        bool
+        rebuilt()
+        {
+            auto const text = strm_.str();
+            strm_.str ({});
+            return text.find ("reading every key") != std::string::npos;
+        }
+    };
+
+    // The journal is written in the background, so wait for it
+    static
+    bool
+    waitForSize (boost::filesystem::path const& path, std::uintmax_t size)
+    {
+        boost::system::error_code ec;
+        for (int i = 0; i < 200; ++i)
+        {
+            if (boost::filesystem::file_size (path, ec) == size && ! ec)
+                return true;
+            std::this_thread::sleep_for (std::chrono::milliseconds (25));
+        }
+        return false;
+    }
+
 public:
     void testImport (std::string const& destBackendType,
         std::string const& srcBackendType, std::int64_t seedValue)
@@ -160,6 +208,276 @@ public:
 
     //--------------------------------------------------------------------------
 
+    void testKeyFilter (std::int64_t const seedValue)
+    {
+        testcase ("key filter");
+
+        beast::xor_shift_engine rng (seedValue);
+        auto const present = createPredictableBatch (2000, rng());
+        auto const missing = createPredictableBatch (2000, rng());
+
+        KeyFilter filter (present.size());
+        for (auto const& object : present)
+            filter.insert (object->getHash());
+
+        // Never a false negative, and rarely a false positive
+        bool all = true;
+        for (auto const& object : present)
+            all = all && filter.mayContain (object->getHash());
+        BEAST_EXPECT(all);
+        int falsePositives = 0;
+        for (auto const& object : missing)
+            if (filter.mayContain (object->getHash()))
+                ++falsePositives;
+        BEAST_EXPECT(falsePositives < 60);
+
+        beast::temp_dir dir;
+        boost::filesystem::path const path (dir.file ("filter"));
+        BEAST_EXPECT(filter.save (path));
+
+        // A different size is not accepted
+        BEAST_EXPECT(! KeyFilter::load (path, 20000));
+
+        auto const loaded = KeyFilter::load (path, present.size());
+        BEAST_EXPECT(loaded);
+        if (loaded)
+        {
+            for (auto const& object : present)
+                all = all && loaded->mayContain (object->getHash());
+            BEAST_EXPECT(all);
+            int same = 0;
+            for (auto const& object : missing)
+                if (loaded->mayContain (object->getHash()))
+                    ++same;
+            BEAST_EXPECT(same == falsePositives);
+        }
+
+        // A damaged snapshot is rejected
+        {
+            auto const size = boost::filesystem::file_size (path);
+            std::fstream file (path.string(),
+                std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp (size / 2);
+            file.put ('x');
+        }
+        BEAST_EXPECT(! KeyFilter::load (path, present.size()));
+
+        // Keys inserted after the snapshot are read back from the
+        // journal, as if the process had stopped without closing.
+        // The filter is large enough that the journal is not folded
+        // into a new snapshot.
+        std::size_t const large = 100000;
+        KeyFilter journaled (large);
+        BEAST_EXPECT(journaled.journal (path, 1));
+        for (auto const& object : present)
+            journaled.insert (object->getHash());
+        BEAST_EXPECT(waitForSize (path.string() + ".log",
+            present.size() * uint256::bytes));
+        {
+            // Stopped part way through writing a key
+            std::ofstream log (path.string() + ".log",
+                std::ios::binary | std::ios::app);
+            log.write ("abc", 3);
+        }
+        auto const replayed = KeyFilter::load (path, large);
+        BEAST_EXPECT(replayed);
+        if (replayed)
+        {
+            for (auto const& object : present)
+                all = all && replayed->mayContain (object->getHash());
+            BEAST_EXPECT(all);
+        }
+
+        // Closing folds the journal into the snapshot
+        journaled.close();
+        BEAST_EXPECT(! boost::filesystem::exists (path.string() + ".log"));
+        auto const closed = KeyFilter::load (path, large);
+        BEAST_EXPECT(closed);
+        if (closed)
+        {
+            BEAST_EXPECT(closed->generation() == 1);
+            for (auto const& object : present)
+                all = all && closed->mayContain (object->getHash());
+            BEAST_EXPECT(all);
+        }
+
+        // A journal larger than the snapshot starts a new snapshot.
+        // Destroying the filter waits for it, and leaves the files
+        // as a crash would.
+        {
+            KeyFilter small (200);
+            BEAST_EXPECT(small.journal (path, 2));
+            for (auto const& object : present)
+                small.insert (object->getHash());
+        }
+        BEAST_EXPECT(boost::filesystem::file_size (path.string() + ".log") <
+            present.size() * uint256::bytes);
+        BEAST_EXPECT(! boost::filesystem::exists (path.string() + ".log.old"));
+        auto const rotated = KeyFilter::load (path, 200);
+        BEAST_EXPECT(rotated);
+        if (rotated)
+        {
+            for (auto const& object : present)
+                all = all && rotated->mayContain (object->getHash());
+            BEAST_EXPECT(all);
+        }
+    }
+
+    void testFilteredStore (std::string const& type,
+        std::int64_t const seedValue)
+    {
+        DummyScheduler scheduler;
+        RootStoppable parent ("TestRootStoppable");
+
+        testcase ("NodeStore backend '" + type + "' with key filter");
+
+        beast::temp_dir node_db;
+        Section nodeParams;
+        nodeParams.set ("type", type);
+        nodeParams.set ("path", node_db.path());
+        // Large enough that the journal is not folded into a new
+        // snapshot while the test runs
+        nodeParams.set ("filter_keys", "100000");
+        auto const snapshot =
+            boost::filesystem::path (node_db.path()) / "keyfilter";
+
+        beast::xor_shift_engine rng (seedValue);
+        auto batch = createPredictableBatch (1000, rng());
+        auto const missing = createPredictableBatch (1000, rng());
+
+        TestSink sink;
+        beast::Journal j (sink);
+
+        auto const fetchMissing = [&](Database& db)
+        {
+            bool none = true;
+            for (auto const& object : missing)
+                none = none && ! db.fetch (object->getHash());
+            BEAST_EXPECT(none);
+        };
+
+        {
+            auto db = Manager::instance().make_Database (
+                "test", scheduler, 2, parent, nodeParams, j);
+            storeBatch (*db, batch);
+            BEAST_EXPECT(sink.rebuilt());
+
+            // Nearly all missing keys are answered by the filter
+            fetchMissing (*db);
+            BEAST_EXPECT(db->getFetchFilteredCount() > 950);
+            BEAST_EXPECT(db->getFetchTotalCount() < 50);
+
+            // Objects still in the cache are not written again
+            auto const stores = db->getStoreCount();
+            storeBatch (*db, batch);
+            BEAST_EXPECT(db->getStoreDuplicateCount() == batch.size());
+            BEAST_EXPECT(db->getStoreCount() == stores);
+        }
+        BEAST_EXPECT(boost::filesystem::exists (snapshot));
+
+        // Store more, and keep the filter files as a crash would
+        // leave them
+        auto const crashed =
+            boost::filesystem::path (node_db.path()) / "crashed";
+        auto const more = createPredictableBatch (1000, rng());
+        {
+            auto db = Manager::instance().make_Database (
+                "test", scheduler, 2, parent, nodeParams, j);
+            storeBatch (*db, more);
+            BEAST_EXPECT(waitForSize (
+                boost::filesystem::path (node_db.path()) / "keyfilter.log",
+                more.size() * uint256::bytes));
+            boost::filesystem::create_directory (crashed);
+            for (auto const& name : {"keyfilter", "keyfilter.log"})
+                boost::filesystem::copy_file (
+                    boost::filesystem::path (node_db.path()) / name,
+                    crashed / name);
+        }
+        for (auto const& name : {"keyfilter", "keyfilter.log"})
+            boost::filesystem::copy_file (crashed / name,
+                boost::filesystem::path (node_db.path()) / name,
+                boost::filesystem::copy_option::overwrite_if_exists);
+        batch.insert (batch.end(), more.begin(), more.end());
+
+        // Reopen from the files, then rebuild without them
+        sink.rebuilt();
+        for (int i = 0; i < 2; ++i)
+        {
+            if (i == 1)
+                boost::filesystem::remove (snapshot);
+            auto db = Manager::instance().make_Database (
+                "test", scheduler, 2, parent, nodeParams, j);
+            BEAST_EXPECT(boost::filesystem::exists (snapshot));
+            BEAST_EXPECT(sink.rebuilt() == (i == 1));
+
+            Batch copy;
+            fetchCopyOfBatch (*db, &copy, batch);
+            std::sort (batch.begin (), batch.end (), LessThan{});
+            std::sort (copy.begin (), copy.end (), LessThan{});
+            BEAST_EXPECT(areBatchesEqual (batch, copy));
+
+            fetchMissing (*db);
+            BEAST_EXPECT(db->getFetchFilteredCount() > 950);
+        }
+
+        auto const fetchAll = [&](Database& db, Batch const& objects)
+        {
+            Batch copy;
+            fetchCopyOfBatch (db, &copy, objects);
+            Batch sorted (objects);
+            std::sort (sorted.begin (), sorted.end (), LessThan{});
+            std::sort (copy.begin (), copy.end (), LessThan{});
+            BEAST_EXPECT(areBatchesEqual (sorted, copy));
+        };
+
+        // Turning the filter off removes its files, so that keys
+        // stored meanwhile are found once it is turned back on
+        {
+            Section unfiltered (nodeParams);
+            unfiltered.set ("filter_keys", "0");
+            auto db = Manager::instance().make_Database (
+                "test", scheduler, 2, parent, unfiltered, j);
+            BEAST_EXPECT(! boost::filesystem::exists (snapshot));
+            auto const later = createPredictableBatch (100, rng());
+            storeBatch (*db, later);
+            batch.insert (batch.end(), later.begin(), later.end());
+        }
+        {
+            auto db = Manager::instance().make_Database (
+                "test", scheduler, 2, parent, nodeParams, j);
+            BEAST_EXPECT(sink.rebuilt());
+            fetchAll (*db, batch);
+        }
+
+        // A backend restored from a copy does not hold the marker
+        // named by newer filter files
+        auto const backup =
+            boost::filesystem::path (node_db.path()) / "backup";
+        boost::filesystem::create_directory (backup);
+        for (auto const& name : {"nudb.dat", "nudb.key"})
+            boost::filesystem::copy_file (
+                boost::filesystem::path (node_db.path()) / name,
+                backup / name);
+        {
+            auto db = Manager::instance().make_Database (
+                "test", scheduler, 2, parent, nodeParams, j);
+            BEAST_EXPECT(! sink.rebuilt());
+            storeBatch (*db, createPredictableBatch (100, rng()));
+        }
+        for (auto const& name : {"nudb.dat", "nudb.key"})
+            boost::filesystem::copy_file (backup / name,
+                boost::filesystem::path (node_db.path()) / name,
+                boost::filesystem::copy_option::overwrite_if_exists);
+        {
+            auto db = Manager::instance().make_Database (
+                "test", scheduler, 2, parent, nodeParams, j);
+            BEAST_EXPECT(sink.rebuilt());
+            fetchAll (*db, batch);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     void runBackendTests (std::int64_t const seedValue)
     {
         testNodeStore ("nudb", true, seedValue);
@@ -195,6 +513,10 @@ public:
         runBackendTests (seedValue);
 
         runImportTests (seedValue);
+
+        testKeyFilter (seedValue);
+
+        testFilteredStore ("nudb", seedValue);
     }
 };
 
@@ -0,0 +1,302 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/Keylet.h>
+#include <ripple/protocol/LazySLE.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/UintTypes.h>
+#include <ripple/beast/unit_test.h>
+#include <cstring>
+
+namespace ripple {
+
+class LazySLE_test : public beast::unit_test::suite
+{
+    static
+    AccountID
+    account (std::uint64_t n)
+    {
+        AccountID id;
+        auto const h = sha512Half (n);
+        std::memcpy (id.data (), h.data (), id.size ());
+        return id;
+    }
+
+    static
+    std::shared_ptr<Serializer const>
+    serialize (STObject const& obj)
+    {
+        auto s = std::make_shared<Serializer> ();
+        obj.add (*s);
+        return s;
+    }
+
+    static
+    LazySLE
+    makeLazy (SLE const& sle)
+    {
+        auto const s = serialize (sle);
+        return LazySLE (sle.key (), s->slice (), s);
+    }
+
+    void
+    testAccountRoot ()
+    {
+        testcase ("account root");
+
+        auto const id = account (1);
+        SLE sle (keylet::account (id));
+        sle.setAccountID (sfAccount, id);
+        sle.setFieldAmount (sfBalance, STAmount (100000000));
+        sle.setFieldU32 (sfSequence, 42);
+        sle.setFieldU32 (sfOwnerCount, 3);
+        sle.setFieldU32 (sfFlags, lsfRequireDestTag | lsfDisableMaster);
+        sle.setAccountID (sfRegularKey, account (2));
+        sle.setFieldU32 (sfTransferRate, 1005000000);
+        sle.setFieldH128 (sfEmailHash, uint128 (7));
+        sle.setFieldVL (sfDomain, Slice ("example.com", 11));
+        sle.setFieldH256 (sfPreviousTxnID, sha512Half (1));
+        sle.setFieldU32 (sfPreviousTxnLgrSeq, 12345678);
+
+        auto const lazy = makeLazy (sle);
+        BEAST_EXPECT(lazy.key () == sle.key ());
+        BEAST_EXPECT(lazy.getType () == ltACCOUNT_ROOT);
+        BEAST_EXPECT(lazy.getFlags () == sle.getFlags ());
+        BEAST_EXPECT(lazy.isFlag (lsfDisableMaster));
+        BEAST_EXPECT(! lazy.isFlag (lsfGlobalFreeze));
+
+        BEAST_EXPECT(lazy[sfAccount] == id);
+        BEAST_EXPECT(lazy[sfBalance] == sle[sfBalance]);
+        BEAST_EXPECT(lazy[sfSequence] == 42);
+        BEAST_EXPECT(lazy[sfOwnerCount] == 3);
+        BEAST_EXPECT(lazy[sfRegularKey] == account (2));
+        BEAST_EXPECT(lazy[sfTransferRate] == 1005000000);
+        BEAST_EXPECT(lazy[sfEmailHash] == uint128 (7));
+        BEAST_EXPECT(lazy[sfDomain] == sle[sfDomain]);
+        BEAST_EXPECT(lazy[sfPreviousTxnID] == sha512Half (1));
+        BEAST_EXPECT(lazy[sfPreviousTxnLgrSeq] == 12345678);
+
+        // Optional fields that are not present
+        BEAST_EXPECT(! lazy.isFieldPresent (sfWalletLocator));
+        BEAST_EXPECT(! lazy[~sfWalletLocator]);
+        BEAST_EXPECT(*lazy[~sfSequence] == 42);
+        try
+        {
+            lazy[sfWalletLocator];
+            fail ("missing field");
+        }
+        catch (missing_field_error const&)
+        {
+            pass ();
+        }
+
+        // Fields that are not part of the format
+        BEAST_EXPECT(! lazy.isFieldPresent (sfTakerPays));
+        BEAST_EXPECT(! lazy[~sfTakerPays]);
+
+        BEAST_EXPECT(Keylet (ltANY, sle.key ()).check (lazy));
+        BEAST_EXPECT(Keylet (ltCHILD, sle.key ()).check (lazy));
+        BEAST_EXPECT(keylet::account (id).check (lazy));
+
+        // Round trip through the full decoder
+        auto const full = lazy.sle ();
+        BEAST_EXPECT(full->key () == sle.key ());
+        BEAST_EXPECT(serialize (*full)->peekData () ==
+            serialize (sle)->peekData ());
+    }
+
+    void
+    testComplexFields ()
+    {
+        testcase ("complex fields");
+
+        Issue const usd (to_currency ("USD"), account (2));
+
+        {
+            // Non-native amounts
+            SLE sle (keylet::line (account (1), account (2), usd.currency));
+            sle.setFieldAmount (sfBalance, STAmount (
+                Issue (usd.currency, noAccount ()), 12345, -2));
+            sle.setFieldAmount (sfLowLimit, STAmount (
+                Issue (usd.currency, account (1)), 1000));
+            sle.setFieldAmount (sfHighLimit, STAmount (
+                Issue (usd.currency, account (2)), 0));
+            sle.setFieldU64 (sfLowNode, 1);
+            sle.setFieldU64 (sfHighNode, 0x123456789ULL);
+            sle.setFieldU32 (sfFlags, lsfLowReserve | lsfHighNoRipple);
+
+            auto const lazy = makeLazy (sle);
+            BEAST_EXPECT(lazy.getType () == ltRIPPLE_STATE);
+            BEAST_EXPECT(lazy[sfBalance] == sle[sfBalance]);
+            BEAST_EXPECT(lazy[sfBalance].getCurrency () == usd.currency);
+            BEAST_EXPECT(lazy[sfLowLimit].getIssuer () == account (1));
+            BEAST_EXPECT(lazy[sfHighLimit].getIssuer () == account (2));
+            BEAST_EXPECT(lazy[sfLowNode] == 1);
+            BEAST_EXPECT(lazy[sfHighNode] == 0x123456789ULL);
+            BEAST_EXPECT(lazy.isFlag (lsfHighNoRipple));
+        }
+
+        {
+            // Vectors of hashes
+            SLE sle (keylet::ownerDir (account (1)));
+            STVector256 indexes;
+            for (std::uint64_t i = 0; i < 32; ++i)
+                indexes.push_back (sha512Half (i));
+            sle.setFieldV256 (sfIndexes, indexes);
+            sle.setAccountID (sfOwner, account (1));
+            sle.setFieldH256 (sfRootIndex, sle.key ());
+            sle.setFieldU64 (sfIndexNext, 3);
+
+            auto const lazy = makeLazy (sle);
+            BEAST_EXPECT(lazy.getType () == ltDIR_NODE);
+            BEAST_EXPECT(lazy[sfIndexes] == indexes.value ());
+            BEAST_EXPECT(lazy[sfOwner] == account (1));
+            BEAST_EXPECT(lazy[sfRootIndex] == sle.key ());
+            BEAST_EXPECT(lazy[sfIndexNext] == 3);
+            BEAST_EXPECT(! lazy[~sfIndexPrevious]);
+        }
+
+        {
+            // Arrays of inner objects, followed by other fields
+            SLE sle (keylet::signers (account (1)));
+            STArray entries (sfSignerEntries);
+            for (std::uint16_t i = 0; i < 4; ++i)
+            {
+                entries.emplace_back (sfSignerEntry);
+                auto& entry = entries.back ();
+                entry.setAccountID (sfAccount, account (10 + i));
+                entry.setFieldU16 (sfSignerWeight, i + 1);
+            }
+            sle.setFieldArray (sfSignerEntries, entries);
+            sle.setFieldU32 (sfSignerQuorum, 7);
+            sle.setFieldU32 (sfSignerListID, 0);
+            sle.setFieldU64 (sfOwnerNode, 9);
+            sle.setFieldH256 (sfPreviousTxnID, sha512Half (5));
+            sle.setFieldU32 (sfPreviousTxnLgrSeq, 5);
+
+            auto const lazy = makeLazy (sle);
+            BEAST_EXPECT(lazy.getType () == ltSIGNER_LIST);
+            BEAST_EXPECT(lazy.isFieldPresent (sfSignerEntries));
+            BEAST_EXPECT(lazy[sfSignerQuorum] == 7);
+            BEAST_EXPECT(lazy[sfOwnerNode] == 9);
+            BEAST_EXPECT(lazy[sfPreviousTxnID] == sha512Half (5));
+
+            auto const full = lazy.sle ();
+            BEAST_EXPECT(full->getFieldArray (sfSignerEntries) == entries);
+        }
+
+        {
+            // Path sets; only the transaction formats use them
+            STPath path;
+            path.emplace_back (account (3), boost::none, boost::none);
+            path.emplace_back (boost::none, usd.currency, usd.account);
+            STPathSet paths;
+            paths.push_back (path);
+            paths.push_back (path);
+
+            STTx tx (ttPAYMENT, [&](STObject& obj)
+            {
+                obj.setAccountID (sfAccount, account (1));
+                obj.setAccountID (sfDestination, account (4));
+                obj.setFieldU32 (sfSequence, 1234);
+                obj.setFieldAmount (sfFee, STAmount (12));
+                obj.setFieldAmount (sfAmount, STAmount (usd, 10));
+                obj.setFieldAmount (sfSendMax, STAmount (usd, 11));
+                obj.setFieldVL (sfSigningPubKey, Blob (33, 2));
+                static_cast<STPathSet&>(
+                    *obj.makeFieldPresent (sfPaths)) = paths;
+            });
+
+            auto const s = serialize (tx);
+            LazySLE const lazy (tx.getTransactionID (), s->slice (), s);
+            BEAST_EXPECT(lazy.getType () == ltINVALID);
+            BEAST_EXPECT(lazy[sfAccount] == account (1));
+            BEAST_EXPECT(lazy[sfDestination] == account (4));
+            BEAST_EXPECT(lazy[sfSendMax] == STAmount (usd, 11));
+            BEAST_EXPECT(lazy.isFieldPresent (sfPaths));
+        }
+    }
+
+    void
+    testWrapped ()
+    {
+        testcase ("wrapped");
+
+        auto const id = account (1);
+        auto sle = std::make_shared<SLE> (keylet::account (id));
+        sle->setAccountID (sfAccount, id);
+        sle->setFieldAmount (sfBalance, STAmount (500));
+        sle->setFieldU32 (sfSequence, 9);
+        sle->setFieldU32 (sfFlags, lsfGlobalFreeze);
+
+        LazySLE const lazy (sle);
+        BEAST_EXPECT(lazy.sle () == sle);
+        BEAST_EXPECT(lazy.key () == sle->key ());
+        BEAST_EXPECT(lazy.getType () == ltACCOUNT_ROOT);
+        BEAST_EXPECT(lazy.isFlag (lsfGlobalFreeze));
+        BEAST_EXPECT(lazy[sfBalance] == STAmount (500));
+        BEAST_EXPECT(lazy[sfSequence] == 9);
+        BEAST_EXPECT(! lazy[~sfRegularKey]);
+        BEAST_EXPECT(! lazy.isFieldPresent (sfRegularKey));
+    }
+
+    void
+    testMalformed ()
+    {
+        testcase ("malformed");
+
+        auto const id = account (1);
+        SLE sle (keylet::account (id));
+        sle.setAccountID (sfAccount, id);
+        sle.setFieldAmount (sfBalance, STAmount (500));
+        sle.setFieldU32 (sfSequence, 9);
+        auto const s = serialize (sle);
+
+        // Nothing is parsed until a field is read
+        LazySLE const lazy (sle.key (), Slice (
+            s->data (), s->size () - 1), s);
+        try
+        {
+            lazy[sfSequence];
+            fail ("truncated entry");
+        }
+        catch (std::exception const&)
+        {
+            pass ();
+        }
+    }
+
+public:
+    void
+    run () override
+    {
+        testAccountRoot ();
+        testComplexFields ();
+        testWrapped ();
+        testMalformed ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LazySLE,protocol,ripple);
+
+} // ripple
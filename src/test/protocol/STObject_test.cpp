@@ -21,12 +21,16 @@
 #include <ripple/basics/Log.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/digest.h>
 #include <ripple/protocol/st.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/json/to_string.h>
 #include <ripple/beast/unit_test.h>
 #include <test/jtx.h>
+#include <test/unit_test/bench_args.h>
 
+#include <chrono>
+#include <cstring>
 #include <memory>
 #include <type_traits>
 
@@ -634,6 +638,124 @@ public:
         }
     }
 
+    void testTemplateParse ()
+    {
+        testcase ("template parse");
+
+        SField const& sfTestVL = SField::getField (STI_VL, 255);
+        SField const& sfTestH256 = SField::getField (STI_HASH256, 255);
+        SField const& sfTestU32 = SField::getField (STI_UINT32, 255);
+        SField const& sfTestU64 = SField::getField (STI_UINT64, 255);
+        SField const& sfTestObject = SField::getField (STI_OBJECT, 255);
+
+        SOTemplate elements;
+        elements.push_back (SOElement (sfFlags, SOE_REQUIRED));
+        elements.push_back (SOElement (sfTestVL, SOE_REQUIRED));
+        elements.push_back (SOElement (sfTestH256, SOE_OPTIONAL));
+        elements.push_back (SOElement (sfTestU32, SOE_DEFAULT));
+
+        // Parsing into the template must give the same object, and
+        // the same verdict, as parsing freely and applying the
+        // template afterwards.
+        auto check = [&](Serializer const& s, bool valid)
+        {
+            STObject free (sfTestObject);
+            SerialIter sit1 (s.slice ());
+            free.set (sit1);
+            BEAST_EXPECT(free.setType (elements) == valid);
+
+            STObject typed (sfTestObject);
+            SerialIter sit2 (s.slice ());
+            BEAST_EXPECT(typed.set (elements, sit2) == valid);
+            BEAST_EXPECT(sit2.empty ());
+
+            BEAST_EXPECT(typed.getCount () == free.getCount ());
+            for (int i = 0; i < typed.getCount (); ++i)
+            {
+                BEAST_EXPECT(typed.getFieldSType (i) ==
+                    free.getFieldSType (i));
+                BEAST_EXPECT(typed.peekAtIndex (i) ==
+                    free.peekAtIndex (i));
+            }
+            BEAST_EXPECT(typed.getSerializer () == free.getSerializer ());
+        };
+
+        auto flags = [&](Serializer& s, std::uint32_t v)
+        {
+            s.addFieldID (STI_UINT32, sfFlags.fieldValue);
+            s.add32 (v);
+        };
+        auto u32 = [&](Serializer& s, std::uint32_t v)
+        {
+            s.addFieldID (STI_UINT32, sfTestU32.fieldValue);
+            s.add32 (v);
+        };
+        auto h256 = [&](Serializer& s)
+        {
+            s.addFieldID (STI_HASH256, sfTestH256.fieldValue);
+            s.add256 (uint256 (7));
+        };
+        auto vl = [&](Serializer& s)
+        {
+            s.addFieldID (STI_VL, sfTestVL.fieldValue);
+            s.addVL (Blob (3, 'x'));
+        };
+
+        {
+            Serializer s;
+            flags (s, 1); u32 (s, 5); vl (s);
+            check (s, true);
+        }
+        {
+            Serializer s;
+            flags (s, 1); u32 (s, 5); h256 (s); vl (s);
+            check (s, true);
+        }
+        {
+            // Fields out of canonical order
+            Serializer s;
+            vl (s); h256 (s); flags (s, 0);
+            check (s, true);
+        }
+        {
+            // Missing a required field
+            Serializer s;
+            flags (s, 1); u32 (s, 5);
+            check (s, false);
+        }
+        {
+            // Explicitly present default field
+            Serializer s;
+            flags (s, 1); u32 (s, 0); vl (s);
+            check (s, false);
+        }
+        {
+            // A field the template doesn't have
+            Serializer s;
+            flags (s, 1); vl (s);
+            s.addFieldID (STI_UINT64, sfTestU64.fieldValue);
+            s.add64 (3);
+            check (s, false);
+        }
+        {
+            // A field that appears twice
+            Serializer s;
+            flags (s, 1); flags (s, 2); vl (s);
+            check (s, false);
+        }
+        {
+            // Parsing stops at the end of object marker
+            Serializer s;
+            flags (s, 1); vl (s);
+            s.addFieldID (STI_OBJECT, 1);
+            STObject typed (sfTestObject);
+            SerialIter sit (s.slice ());
+            BEAST_EXPECT(typed.set (elements, sit));
+            BEAST_EXPECT(sit.empty ());
+            BEAST_EXPECT(typed.getFlags () == 1);
+        }
+    }
+
     void
     run()
     {
@@ -642,6 +764,7 @@ public:
 
         testFields();
         testSerialization();
+        testTemplateParse();
         testParseJSONArray();
         testParseJSONArrayWithInvalidChildrenObjects();
         testParseJSONEdgeCases();
@@ -650,4 +773,199 @@ public:
 
 BEAST_DEFINE_TESTSUITE(STObject,protocol,ripple);
 
+//------------------------------------------------------------------------------
+
+// Compares the two ways of deserializing a ledger entry or transaction:
+// parsing the fields freely and then applying the format's template,
+// against parsing straight into the template's layout. The argument
+// lists the iteration counts.
+class STObjectBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct Sample
+    {
+        char const* name;
+        SField const& field;
+        SOTemplate const& format;
+        Serializer data;
+    };
+
+    static
+    AccountID
+    account (std::uint64_t n)
+    {
+        AccountID id;
+        auto const h = sha512Half (n);
+        std::memcpy (id.data (), h.data (), id.size ());
+        return id;
+    }
+
+    static
+    Sample
+    makeSLE (char const* name, LedgerEntryType type,
+        std::function<void(STObject&)> const& fill)
+    {
+        STLedgerEntry sle (Keylet (type, sha512Half (
+            std::string (name))));
+        fill (sle);
+        Sample sample {name, sfLedgerEntry,
+            LedgerFormats::getInstance ().findByType (type)->elements,
+            Serializer ()};
+        sle.add (sample.data);
+        return sample;
+    }
+
+    static
+    Sample
+    makeTx (char const* name, TxType type,
+        std::function<void(STObject&)> const& fill)
+    {
+        STTx tx (type, [&](STObject& obj)
+        {
+            obj.setAccountID (sfAccount, account (1));
+            obj.setFieldU32 (sfSequence, 1234);
+            obj.setFieldAmount (sfFee, STAmount (12));
+            obj.setFieldVL (sfSigningPubKey, Blob (33, 2));
+            obj.setFieldVL (sfTxnSignature, Blob (71, 3));
+            fill (obj);
+        });
+        Sample sample {name, sfTransaction,
+            TxFormats::getInstance ().findByType (type)->elements,
+            Serializer ()};
+        tx.add (sample.data);
+        return sample;
+    }
+
+    static
+    std::vector<Sample>
+    makeSamples ()
+    {
+        Issue const usd (to_currency ("USD"), account (2));
+        std::vector<Sample> samples;
+
+        samples.push_back (makeSLE ("AccountRoot", ltACCOUNT_ROOT,
+            [&](STObject& obj)
+            {
+                obj.setAccountID (sfAccount, account (1));
+                obj.setFieldAmount (sfBalance, STAmount (100000000));
+                obj.setFieldU32 (sfSequence, 42);
+                obj.setFieldU32 (sfOwnerCount, 3);
+                obj.setFieldH256 (sfPreviousTxnID, sha512Half (1));
+                obj.setFieldU32 (sfPreviousTxnLgrSeq, 12345678);
+            }));
+
+        samples.push_back (makeSLE ("RippleState", ltRIPPLE_STATE,
+            [&](STObject& obj)
+            {
+                obj.setFieldAmount (sfBalance, STAmount (
+                    Issue (usd.currency, noAccount ()), 12345, -2));
+                obj.setFieldAmount (sfLowLimit, STAmount (
+                    Issue (usd.currency, account (1)), 100));
+                obj.setFieldAmount (sfHighLimit, STAmount (
+                    Issue (usd.currency, account (2)), 0));
+                obj.setFieldU32 (sfFlags, 0x00020000);
+                obj.setFieldH256 (sfPreviousTxnID, sha512Half (1));
+                obj.setFieldU32 (sfPreviousTxnLgrSeq, 12345678);
+            }));
+
+        samples.push_back (makeSLE ("DirectoryNode", ltDIR_NODE,
+            [&](STObject& obj)
+            {
+                std::vector<uint256> indexes;
+                for (std::uint64_t i = 0; i < 32; ++i)
+                    indexes.push_back (sha512Half (i));
+                obj.setFieldH256 (sfRootIndex, sha512Half (99));
+                obj.setFieldV256 (sfIndexes, STVector256 (indexes));
+                obj.setAccountID (sfOwner, account (1));
+            }));
+
+        samples.push_back (makeTx ("Payment", ttPAYMENT,
+            [&](STObject& obj)
+            {
+                obj.setAccountID (sfDestination, account (3));
+                obj.setFieldAmount (sfAmount, STAmount (usd, 500));
+                obj.setFieldAmount (sfSendMax, STAmount (600000000));
+                STPathSet paths;
+                for (std::uint64_t i = 0; i < 3; ++i)
+                {
+                    STPath path;
+                    path.emplace_back (account (10 + i),
+                        usd.currency, account (10 + i));
+                    path.emplace_back (boost::none, usd.currency, usd.account);
+                    paths.push_back (path);
+                }
+                static_cast<STPathSet&> (
+                    *obj.makeFieldPresent (sfPaths)) = paths;
+            }));
+
+        samples.push_back (makeTx ("OfferCreate", ttOFFER_CREATE,
+            [&](STObject& obj)
+            {
+                obj.setFieldAmount (sfTakerPays, STAmount (usd, 100));
+                obj.setFieldAmount (sfTakerGets, STAmount (250000000));
+            }));
+
+        return samples;
+    }
+
+    template <class Parse>
+    std::chrono::nanoseconds
+    time (Sample const& sample, std::size_t count, Parse&& parse)
+    {
+        auto const start = clock_type::now ();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            STObject obj (sample.field);
+            SerialIter sit (sample.data.slice ());
+            BEAST_EXPECT(parse (obj, sit));
+        }
+        return clock_type::now () - start;
+    }
+
+    void
+    bench (std::vector<Sample> const& samples, std::size_t count)
+    {
+        testcase ("iterations " + std::to_string (count));
+
+        for (auto const& sample : samples)
+        {
+            auto const free = time (sample, count,
+                [&](STObject& obj, SerialIter& sit)
+                {
+                    obj.set (sit);
+                    return obj.setType (sample.format);
+                });
+            auto const typed = time (sample, count,
+                [&](STObject& obj, SerialIter& sit)
+                {
+                    return obj.set (sample.format, sit);
+                });
+
+            auto const rate = [&](std::chrono::nanoseconds d)
+            {
+                return std::to_string (count * 1000000000ull /
+                    std::max<std::uint64_t> (d.count (), 1));
+            };
+            log << "    " << sample.name << " (" <<
+                sample.data.size () << " bytes): " <<
+                rate (free) << "/s free, " <<
+                rate (typed) << "/s typed" << std::endl;
+        }
+    }
+
+public:
+    void
+    run () override
+    {
+        auto const counts = test::benchSizes (arg (), { 100000 });
+
+        auto const samples = makeSamples ();
+        for (auto const count : counts)
+            bench (samples, count);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STObjectBench,protocol,ripple);
+
 } // ripple
@@ -0,0 +1,239 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/beast/unit_test.h>
+#include <test/unit_test/bench_args.h>
+#include <chrono>
+#include <thread>
+
+namespace ripple {
+
+class Serializer_test : public beast::unit_test::suite
+{
+    void
+    testReuse ()
+    {
+        testcase ("reuse");
+
+        // Warm up this thread's cache
+        for (int i = 0; i < 4; ++i)
+            Serializer s;
+
+        auto const before = Serializer::buffersAllocated ();
+        for (int i = 0; i < 1000; ++i)
+        {
+            Serializer s;
+            BEAST_EXPECT(s.size () == 0);
+            BEAST_EXPECT(s.capacity () >= 256);
+            s.add32 (i);
+            s.add256 (sha512Half (i));
+            BEAST_EXPECT(s.size () == 36);
+        }
+        BEAST_EXPECT(Serializer::buffersAllocated () == before);
+
+        // Large buffers are not kept
+        for (int i = 0; i < 3; ++i)
+        {
+            Serializer s (64 * 1024);
+            s.addZeros (64 * 1024);
+        }
+        BEAST_EXPECT(Serializer::buffersAllocated () == before + 3);
+
+        // A small request never gets a much larger cached buffer
+        {
+            Serializer s (8 * 1024);
+            s.addZeros (8 * 1024);
+        }
+        Serializer small (100);
+        BEAST_EXPECT(small.capacity () >= 100);
+        BEAST_EXPECT(small.capacity () <= 200);
+        small.addZeros (100);
+        Blob const blob = std::move (small.modData ());
+        BEAST_EXPECT(blob.capacity () <= 200);
+    }
+
+    void
+    testValueSemantics ()
+    {
+        testcase ("value semantics");
+
+        Serializer a;
+        a.add32 (0x01020304);
+        a.addVL (Slice ("abc", 3));
+
+        Serializer b (a);
+        BEAST_EXPECT(b == a);
+        BEAST_EXPECT(b.data () != a.data ());
+        b.add8 (5);
+        BEAST_EXPECT(b.size () == a.size () + 1);
+
+        Serializer c (a.data (), a.size ());
+        BEAST_EXPECT(c == a);
+
+        auto const data = a.data ();
+        Serializer d (std::move (a));
+        BEAST_EXPECT(d.data () == data);
+        BEAST_EXPECT(d == c);
+
+        c = b;
+        BEAST_EXPECT(c == b);
+        d = std::move (b);
+        BEAST_EXPECT(d == c);
+
+        // Moving the storage out leaves the serializer usable
+        Blob blob = std::move (d.modData ());
+        BEAST_EXPECT(blob == c.peekData ());
+        d.add8 (1);
+        BEAST_EXPECT(d.size () == 1);
+    }
+
+    void
+    testThreads ()
+    {
+        testcase ("threads");
+
+        // A serializer may be destroyed on another thread
+        std::vector<Serializer> v;
+        std::thread t ([&v]
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                v.emplace_back ();
+                v.back ().add32 (i);
+            }
+        });
+        t.join ();
+        for (int i = 0; i < 100; ++i)
+        {
+            std::uint32_t n = 0;
+            BEAST_EXPECT(v[i].getInteger (n, 0) && n == i);
+        }
+        v.clear ();
+        pass ();
+    }
+
+public:
+    void
+    run () override
+    {
+        testReuse ();
+        testValueSemantics ();
+        testThreads ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Serializer,protocol,ripple);
+
+//------------------------------------------------------------------------------
+
+class SerializerBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static
+    STTx
+    makeTx ()
+    {
+        auto const keys = generateKeyPair (KeyType::secp256k1,
+            generateSeed ("masterpassphrase"));
+        STTx tx (ttPAYMENT, [&](STObject& obj)
+        {
+            obj.setAccountID (sfAccount, calcAccountID (keys.first));
+            obj.setAccountID (sfDestination, calcAccountID (keys.first));
+            obj.setFieldU32 (sfSequence, 1234);
+            obj.setFieldAmount (sfFee, STAmount (12));
+            obj.setFieldAmount (sfAmount, STAmount (1000000));
+            obj.setFieldVL (sfSigningPubKey, keys.first.slice ());
+        });
+        tx.sign (keys.first, keys.second);
+        return tx;
+    }
+
+    template <class F>
+    void
+    measure (std::string const& name, std::size_t count, F&& f)
+    {
+        // Warm up the buffer cache
+        f ();
+
+        auto const allocated = Serializer::buffersAllocated ();
+        auto const start = clock_type::now ();
+        for (std::size_t i = 0; i < count; ++i)
+            f ();
+        auto const elapsed = clock_type::now () - start;
+        auto const buffers = Serializer::buffersAllocated () - allocated;
+
+        log << "    " << name << ": " <<
+            std::chrono::duration_cast<std::chrono::nanoseconds> (
+                elapsed).count () / count << " ns, " <<
+            double (buffers) / count << " buffer allocations per call" <<
+            std::endl;
+    }
+
+    void
+    bench (std::size_t count)
+    {
+        testcase ("iterations " + std::to_string (count));
+
+        auto const tx = makeTx ();
+        std::uint64_t sink = 0;
+
+        measure ("transaction ID", count, [&]
+        {
+            sink += tx.getHash (HashPrefix::transactionID).begin ()[0];
+        });
+        measure ("signing hash", count, [&]
+        {
+            sink += tx.getSigningHash ().begin ()[0];
+        });
+        measure ("serialize", count, [&]
+        {
+            Serializer s;
+            tx.add (s);
+            sink += s.size ();
+        });
+        measure ("copy", count, [&, s = tx.getSerializer ()]
+        {
+            Serializer copy (s);
+            sink += copy.size ();
+        });
+
+        BEAST_EXPECT(sink != 0);
+    }
+
+public:
+    void
+    run () override
+    {
+        auto const counts = test::benchSizes (arg (), { 100000 });
+
+        for (auto const count : counts)
+            bench (count);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(SerializerBench,protocol,ripple);
+
+} // ripple
@@ -149,14 +149,98 @@ public:
         pass ();
     }
 
+    // Hashes SHAMap inner node sized messages one at a time, then in
+    // batches through sha512HalfBatch.
+    void testSHA512HalfBatch ()
+    {
+        testcase ("SHA512Half batch");
+
+        using namespace std::chrono;
+        using clock_type = high_resolution_clock;
+
+        std::size_t const count = 200000;
+        std::size_t const size = 516;
+        std::vector<std::uint8_t> data (count * size);
+        beast::xor_shift_engine g (19207813);
+        beast::rngfill (data.data (), data.size (), g);
+
+        std::vector<Slice> messages;
+        messages.reserve (count);
+        for (std::size_t i = 0; i < count; ++i)
+            messages.emplace_back (data.data () + i * size, size);
+
+        std::vector<uint256> single (count);
+        auto start = clock_type::now ();
+        for (std::size_t i = 0; i < count; ++i)
+            single[i] = sha512Half (messages[i]);
+        auto const one = duration_cast<milliseconds> (
+            clock_type::now () - start);
+
+        std::vector<uint256> batched (count);
+        start = clock_type::now ();
+        for (std::size_t i = 0; i < count; i += 256)
+            sha512HalfBatch (&messages[i], &batched[i],
+                std::min<std::size_t> (256, count - i));
+        auto const many = duration_cast<milliseconds> (
+            clock_type::now () - start);
+
+        BEAST_EXPECT (single == batched);
+
+        auto const rate = [&](milliseconds ms)
+        {
+            return (count * size / 1000) / std::max<std::int64_t> (
+                ms.count (), 1);
+        };
+        log <<
+            "    one at a time: " << one.count () << "ms, " <<
+                rate (one) << " MB/s" << '\n' <<
+            "          batched: " << many.count () << "ms, " <<
+                rate (many) << " MB/s" << std::endl;
+    }
+
     void run ()
     {
         testSHA512 ();
         testSHA256 ();
         testRIPEMD160 ();
+        testSHA512HalfBatch ();
     }
 };
 
 BEAST_DEFINE_TESTSUITE_MANUAL(digest,ripple_data,ripple);
 
+//------------------------------------------------------------------------------
+
+class sha512HalfBatch_test : public beast::unit_test::suite
+{
+public:
+    void run ()
+    {
+        // Cover lengths on either side of the padding boundaries and
+        // batches whose lanes need different numbers of blocks.
+        beast::xor_shift_engine g (1);
+        std::vector<std::uint8_t> data (1024);
+        beast::rngfill (data.data (), data.size (), g);
+
+        std::vector<Slice> messages;
+        for (std::size_t size = 0; size <= 300; ++size)
+            messages.emplace_back (data.data () + (size % 64), size);
+        for (auto const size : { 516, 517, 575, 1000 })
+            messages.emplace_back (data.data (), size);
+
+        for (std::size_t count = 0; count <= messages.size (); count += 7)
+        {
+            std::vector<uint256> hashes (count);
+            sha512HalfBatch (messages.data (), hashes.data (), count);
+
+            bool ok = true;
+            for (std::size_t i = 0; i < count; ++i)
+                ok = ok && hashes[i] == sha512Half (messages[i]);
+            BEAST_EXPECT (ok);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(sha512HalfBatch,ripple_data,ripple);
+
 } // ripple
@@ -25,6 +25,8 @@
 #include <ripple/resource/Consumer.h>
 #include <ripple/resource/impl/Entry.h>
 #include <ripple/resource/impl/Logic.h>
+#include <thread>
+#include <vector>
 
 
 
@@ -244,6 +246,92 @@ public:
         pass();
     }
 
+    void testConcurrent (beast::Journal j)
+    {
+        testcase ("Concurrent");
+
+        TestLogic logic (j);
+
+        // The clock does not move, so nothing decays
+        int const threads = 8;
+        int const charges = 1000;
+        std::vector<std::thread> v;
+        for (int t = 0; t < threads; ++t)
+        {
+            v.emplace_back ([&logic, t]
+            {
+                beast::IP::Endpoint const shared (
+                    beast::IP::Endpoint::from_string ("192.0.2.1"));
+                beast::IP::Endpoint const own (
+                    beast::IP::AddressV4 (198, 51, 100, 1 + t));
+                for (int i = 0; i < charges; ++i)
+                {
+                    Consumer c (logic.newInboundEndpoint (shared));
+                    c.charge (Charge (decayWindowSeconds));
+                    Consumer d (logic.newInboundEndpoint (own));
+                    d.charge (Charge (1));
+                }
+            });
+        }
+        for (auto& t : v)
+            t.join ();
+
+        {
+            Consumer c (logic.newInboundEndpoint (
+                beast::IP::Endpoint::from_string ("192.0.2.1")));
+            BEAST_EXPECT(c.balance () == threads * charges);
+            BEAST_EXPECT(c.disposition () == drop);
+            BEAST_EXPECT(c.disconnect ());
+        }
+
+        // Every consumer is inactive until it expires
+        BEAST_EXPECT(logic.getJson (0).size () == 0);
+        logic.clock ().advance (secondsUntilExpiration);
+        logic.periodicActivity ();
+        Consumer c (logic.newInboundEndpoint (
+            beast::IP::Endpoint::from_string ("192.0.2.1")));
+        BEAST_EXPECT(c.balance () == 0);
+    }
+
+    void testExport (beast::Journal j)
+    {
+        testcase ("Export");
+
+        TestLogic logic (j);
+
+        beast::IP::Endpoint const busy (
+            beast::IP::Endpoint::from_string ("192.0.2.1"));
+        beast::IP::Endpoint const quiet (
+            beast::IP::Endpoint::from_string ("192.0.2.2"));
+        Consumer b (logic.newInboundEndpoint (busy));
+        Consumer q (logic.newInboundEndpoint (quiet));
+        b.charge (Charge (minimumGossipBalance * decayWindowSeconds));
+        q.charge (Charge (1));
+
+        // Gossip is collected by the periodic sweep
+        BEAST_EXPECT(logic.exportConsumers ().items.empty ());
+        logic.periodicActivity ();
+        auto const gossip = logic.exportConsumers ();
+        if (BEAST_EXPECT(gossip.items.size () == 1))
+        {
+            BEAST_EXPECT(gossip.items[0].address == busy.at_port (0));
+            BEAST_EXPECT(gossip.items[0].balance == minimumGossipBalance);
+        }
+
+        // Imported balances count toward the consumer's balance
+        Gossip g;
+        Gossip::Item item;
+        item.balance = 200;
+        item.address = quiet;
+        g.items.push_back (item);
+        logic.importConsumers ("g", g);
+        BEAST_EXPECT(q.balance () == 200);
+
+        logic.clock ().advance (gossipExpirationSeconds);
+        logic.periodicActivity ();
+        BEAST_EXPECT(q.balance () == 0);
+    }
+
     void run()
     {
         beast::Journal j;
@@ -252,6 +340,8 @@ public:
         testCharges (j);
         testImports (j);
         testImport (j);
+        testConcurrent (j);
+        testExport (j);
     }
 };
 
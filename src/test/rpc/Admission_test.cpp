@@ -0,0 +1,419 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/beast/insight/NullCollector.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/resource/Fees.h>
+#include <ripple/rpc/RPCHandler.h>
+#include <ripple/rpc/impl/Admission.h>
+#include <test/jtx.h>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class Admission_test : public beast::unit_test::suite
+{
+    // A request running in its own coroutine
+    struct Request
+    {
+        Json::Value params;
+        Role role;
+        Json::Value result;
+        std::atomic<bool> done {false};
+
+        Request (Json::Value const& params_, Role role_)
+            : params (params_)
+            , role (role_)
+        {
+        }
+    };
+
+    // Commands that stop until they are allowed to finish
+    class Commands
+    {
+        std::mutex mutex_;
+        std::vector<std::shared_ptr<JobQueue::Coro>> paused_;
+        int started_ = 0;
+
+    public:
+        // Suspends the calling coroutine
+        void
+        execute (std::shared_ptr<JobQueue::Coro> const& coro,
+            Json::Value& result)
+        {
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                paused_.push_back (coro);
+                result[jss::count] = ++started_;
+            }
+            coro->yield();
+        }
+
+        int
+        started()
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            return started_;
+        }
+
+        // Lets every paused command finish
+        void
+        finish()
+        {
+            std::vector<std::shared_ptr<JobQueue::Coro>> paused;
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                paused.swap (paused_);
+            }
+            for (auto const& coro : paused)
+                coro->post();
+        }
+    };
+
+    template <class Pred>
+    bool
+    waitFor (Pred&& pred)
+    {
+        using namespace std::chrono;
+        auto const until = steady_clock::now() + seconds (10);
+        while (! pred())
+        {
+            if (steady_clock::now() > until)
+                return false;
+            std::this_thread::sleep_for (milliseconds (1));
+        }
+        return true;
+    }
+
+    void
+    launch (jtx::Env& env, RPC::Admission& admission,
+        Commands& commands, Request& request)
+    {
+        auto& app = env.app();
+        app.getJobQueue().postCoro (jtCLIENT, "Admission-Test",
+            [&](std::shared_ptr<JobQueue::Coro> const& coro)
+            {
+                Resource::Charge loadType = Resource::feeReferenceRPC;
+                Resource::Consumer c;
+                RPC::Context context {env.journal, request.params, app,
+                    loadType, app.getOPs(), app.getLedgerMaster(), c,
+                        request.role, coro};
+                admission.run (context,
+                    [&](Json::Value& result)
+                    {
+                        commands.execute (coro, result);
+                    }, request.result);
+                request.done = true;
+            });
+    }
+
+    // Runs RPC::doCommand through admission
+    void
+    launchCommand (jtx::Env& env, RPC::Admission& admission,
+        Request& request)
+    {
+        auto& app = env.app();
+        app.getJobQueue().postCoro (jtCLIENT, "Admission-Test",
+            [&](std::shared_ptr<JobQueue::Coro> const& coro)
+            {
+                Resource::Charge loadType = Resource::feeReferenceRPC;
+                Resource::Consumer c;
+                RPC::Context context {env.journal, request.params, app,
+                    loadType, app.getOPs(), app.getLedgerMaster(), c,
+                        request.role, coro};
+                admission.doCommand (context, request.result);
+                request.done = true;
+            });
+    }
+
+    void
+    testKey()
+    {
+        testcase ("key");
+
+        using namespace jtx;
+        Env env {*this};
+        env.fund (XRP(10000), "alice");
+        env.close();
+
+        auto key = [&](Json::Value const& params, Role role = Role::USER)
+        {
+            Resource::Charge loadType = Resource::feeReferenceRPC;
+            Resource::Consumer c;
+            RPC::Context context {env.journal, params, env.app(),
+                loadType, env.app().getOPs(), env.app().getLedgerMaster(),
+                    c, role};
+            return RPC::coalesceKey (context);
+        };
+
+        Json::Value params;
+        params[jss::command] = "account_info";
+        params[jss::account] = Account ("alice").human();
+        params[jss::ledger_index] = "validated";
+        auto const validated = key (params);
+        BEAST_EXPECT(validated);
+
+        // The request id does not matter, the role does
+        auto withId = params;
+        withId[jss::id] = 7;
+        BEAST_EXPECT(key (withId) == validated);
+        BEAST_EXPECT(key (params, Role::ADMIN) &&
+            key (params, Role::ADMIN) != validated);
+
+        // A validated ledger may be named by its sequence
+        params[jss::ledger_index] = env.closed()->info().seq;
+        BEAST_EXPECT(key (params) && key (params) != validated);
+
+        // The open ledger changes
+        params[jss::ledger_index] = "current";
+        BEAST_EXPECT(! key (params));
+        params.removeMember (jss::ledger_index);
+        BEAST_EXPECT(! key (params));
+        params[jss::ledger_index] = env.closed()->info().seq + 1;
+        BEAST_EXPECT(! key (params));
+
+        // A ledger hash names a fixed ledger, if it is a hash at all
+        params.removeMember (jss::ledger_index);
+        params[jss::ledger_hash] = to_string (env.closed()->info().hash);
+        BEAST_EXPECT(key (params));
+        params[jss::ledger_hash] = "validated";
+        BEAST_EXPECT(! key (params));
+        params.removeMember (jss::ledger_hash);
+
+        // Commands with side effects are never coalesced
+        params[jss::command] = "submit";
+        params[jss::ledger_index] = "validated";
+        BEAST_EXPECT(! key (params));
+    }
+
+    void
+    testCoalesce()
+    {
+        testcase ("coalesce");
+
+        using namespace jtx;
+        Env env {*this};
+        env.fund (XRP(10000), "alice");
+        env.close();
+
+        RPC::Admission admission (env.app().getJobQueue(),
+            beast::insight::NullCollector::New(), env.journal);
+        Commands commands;
+
+        Json::Value params;
+        params[jss::command] = "account_info";
+        params[jss::account] = Account ("alice").human();
+        params[jss::ledger_index] = "validated";
+
+        std::list<Request> requests;
+        for (int i = 0; i < 3; ++i)
+        {
+            params[jss::id] = i;
+            requests.emplace_back (params, Role::USER);
+            launch (env, admission, commands, requests.back());
+        }
+
+        BEAST_EXPECT(waitFor ([&]{ return admission.coalesced() == 2; }));
+        BEAST_EXPECT(commands.started() == 1);
+
+        commands.finish();
+        BEAST_EXPECT(waitFor ([&]
+            {
+                for (auto const& r : requests)
+                    if (! r.done)
+                        return false;
+                return true;
+            }));
+        BEAST_EXPECT(commands.started() == 1);
+        for (auto const& r : requests)
+            BEAST_EXPECT(r.result[jss::count] == 1);
+
+        // Once the first request is done, the next one runs again
+        requests.emplace_back (params, Role::USER);
+        launch (env, admission, commands, requests.back());
+        BEAST_EXPECT(waitFor ([&]{ return commands.started() == 2; }));
+        commands.finish();
+        BEAST_EXPECT(waitFor ([&]{ return requests.back().done.load(); }));
+        BEAST_EXPECT(requests.back().result[jss::count] == 2);
+        BEAST_EXPECT(admission.coalesced() == 2);
+    }
+
+    void
+    testLimits()
+    {
+        testcase ("limits");
+
+        using namespace jtx;
+        Env env {*this};
+
+        RPC::Admission admission (env.app().getJobQueue(),
+            beast::insight::NullCollector::New(), env.journal);
+        Commands commands;
+
+        // Two path finds may run at once, and eight may wait
+        Json::Value params;
+        params[jss::command] = "ripple_path_find";
+
+        std::list<Request> requests;
+        auto const add = [&](Role role)
+        {
+            params[jss::id] = static_cast<int> (requests.size());
+            requests.emplace_back (params, role);
+            launch (env, admission, commands, requests.back());
+        };
+
+        for (int i = 0; i < 2; ++i)
+            add (Role::USER);
+        BEAST_EXPECT(waitFor ([&]{ return commands.started() == 2; }));
+
+        for (int i = 0; i < 8; ++i)
+            add (Role::USER);
+        BEAST_EXPECT(waitFor ([&]{ return admission.queued() == 8; }));
+        BEAST_EXPECT(commands.started() == 2);
+
+        // No room left
+        add (Role::USER);
+        BEAST_EXPECT(waitFor ([&]{ return requests.back().done.load(); }));
+        BEAST_EXPECT(admission.shed() == 1);
+        BEAST_EXPECT(requests.back().result[jss::error] == "tooBusy");
+
+        // Admins are not held back
+        add (Role::ADMIN);
+        BEAST_EXPECT(waitFor ([&]{ return commands.started() == 3; }));
+
+        // Each finished request hands its slot to a waiting one
+        for (int started = 3; started < 11; started += 2)
+        {
+            commands.finish();
+            BEAST_EXPECT(waitFor ([&]
+                { return commands.started() == started + 2; }));
+        }
+        commands.finish();
+        BEAST_EXPECT(waitFor ([&]
+            {
+                for (auto const& r : requests)
+                    if (! r.done)
+                        return false;
+                return true;
+            }));
+        BEAST_EXPECT(commands.started() == 11);
+        BEAST_EXPECT(admission.shed() == 1);
+    }
+
+    void
+    testCached()
+    {
+        testcase ("cached");
+
+        using namespace jtx;
+        Env env {*this};
+        env.fund (XRP(10000), "alice");
+        env.close();
+
+        RPC::Admission admission (env.app().getJobQueue(),
+            beast::insight::NullCollector::New(), env.journal);
+        Commands commands;
+
+        // Fill every slot and the queue for the ledger command. The
+        // open ledger is never coalesced or cached.
+        Json::Value params;
+        params[jss::command] = "ledger";
+        params[jss::ledger_index] = "current";
+
+        std::list<Request> requests;
+        auto const add = [&]()
+        {
+            params[jss::id] = static_cast<int> (requests.size());
+            requests.emplace_back (params, Role::USER);
+            launch (env, admission, commands, requests.back());
+        };
+
+        for (int i = 0; i < 8; ++i)
+            add();
+        BEAST_EXPECT(waitFor ([&]{ return commands.started() == 8; }));
+        for (int i = 0; i < 32; ++i)
+            add();
+        BEAST_EXPECT(waitFor ([&]{ return admission.queued() == 32; }));
+        add();
+        BEAST_EXPECT(waitFor ([&]{ return requests.back().done.load(); }));
+        BEAST_EXPECT(admission.shed() == 1);
+
+        // Put the answer about the validated ledger in the cache
+        Json::Value validated;
+        validated[jss::command] = "ledger";
+        validated[jss::ledger_index] = "validated";
+        {
+            Resource::Charge loadType = Resource::feeReferenceRPC;
+            Resource::Consumer c;
+            RPC::Context context {env.journal, validated, env.app(),
+                loadType, env.app().getOPs(),
+                    env.app().getLedgerMaster(), c, Role::USER};
+            Json::Value result;
+            RPC::doCommand (context, result);
+            BEAST_EXPECT(result[jss::validated].asBool());
+        }
+
+        // A cached answer is neither queued nor refused
+        Request cached (validated, Role::USER);
+        launchCommand (env, admission, cached);
+        BEAST_EXPECT(waitFor ([&]{ return cached.done.load(); }));
+        BEAST_EXPECT(cached.result[jss::validated].asBool());
+        BEAST_EXPECT(! cached.result.isMember (jss::error));
+        BEAST_EXPECT(admission.queued() == 32);
+        BEAST_EXPECT(admission.shed() == 1);
+
+        // A request that misses the cache is still refused
+        Request uncached (validated, Role::USER);
+        uncached.params[jss::ledger_index] = env.closed()->info().seq - 1;
+        launchCommand (env, admission, uncached);
+        BEAST_EXPECT(waitFor ([&]{ return uncached.done.load(); }));
+        BEAST_EXPECT(uncached.result[jss::error] == "tooBusy");
+        BEAST_EXPECT(admission.shed() == 2);
+
+        BEAST_EXPECT(waitFor ([&]
+            {
+                commands.finish();
+                for (auto const& r : requests)
+                    if (! r.done)
+                        return false;
+                return true;
+            }));
+    }
+
+public:
+    void
+    run() override
+    {
+        testKey();
+        testCoalesce();
+        testLimits();
+        testCached();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Admission,rpc,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/beast/insight/NullCollector.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/rpc/ResponseCache.h>
+#include <test/jtx.h>
+#include <boost/lexical_cast.hpp>
+
+namespace ripple {
+
+class RPCCache_test : public beast::unit_test::suite
+{
+    static
+    std::uint64_t
+    count (Json::Value const& stats, Json::StaticString const& field)
+    {
+        return std::stoull (stats[field].asString());
+    }
+
+    static
+    Json::Value
+    response (int n, bool validated = true)
+    {
+        Json::Value v (Json::objectValue);
+        v[jss::validated] = validated;
+        v[jss::ledger_index] = n;
+        return v;
+    }
+
+    void
+    testCache()
+    {
+        testcase ("cache");
+
+        RPC::ResponseCache cache (2000, beast::insight::NullCollector::New());
+
+        Json::Value result;
+        BEAST_EXPECT(! cache.fetch ("a", result));
+        cache.insert ("a", response (1));
+        BEAST_EXPECT(cache.fetch ("a", result));
+        BEAST_EXPECT(result == response (1));
+
+        // Only final answers are kept
+        cache.insert ("b", response (2, false));
+        Json::Value error (Json::objectValue);
+        error[jss::error] = "lgrNotFound";
+        cache.insert ("c", error);
+        BEAST_EXPECT(! cache.fetch ("b", result));
+        BEAST_EXPECT(! cache.fetch ("c", result));
+
+        // Nor is one response too large for the cache
+        Json::Value large = response (3);
+        large[jss::account] = std::string (200, 'x');
+        cache.insert ("d", large);
+        BEAST_EXPECT(! cache.fetch ("d", result));
+
+        auto stats = cache.getJson();
+        BEAST_EXPECT(count (stats, jss::hits) == 1);
+        BEAST_EXPECT(count (stats, jss::misses) == 4);
+        BEAST_EXPECT(stats[jss::entries].asUInt() == 1);
+        BEAST_EXPECT(stats[jss::max_bytes].asUInt() == 2000);
+
+        // The least recently used responses go first
+        for (int i = 0; i < 200; ++i)
+        {
+            cache.insert (std::to_string (i), response (i));
+            BEAST_EXPECT(cache.fetch ("a", result));
+        }
+        stats = cache.getJson();
+        BEAST_EXPECT(stats[jss::bytes].asUInt() <= 2000);
+        BEAST_EXPECT(stats[jss::entries].asUInt() < 200);
+        BEAST_EXPECT(! cache.fetch ("0", result));
+        BEAST_EXPECT(cache.fetch ("199", result));
+        BEAST_EXPECT(result == response (199));
+
+        cache.clear();
+        stats = cache.getJson();
+        BEAST_EXPECT(stats[jss::entries].asUInt() == 0);
+        BEAST_EXPECT(stats[jss::bytes].asUInt() == 0);
+        BEAST_EXPECT(! cache.fetch ("a", result));
+    }
+
+    void
+    testRPC()
+    {
+        testcase ("rpc");
+
+        using namespace test::jtx;
+        Env env {*this};
+        Account const alice {"alice"};
+        env.fund (XRP(10000), alice);
+        env.close();
+
+        auto const accountInfo = [&](Json::Value const& ledger)
+        {
+            Json::Value params;
+            params[jss::account] = alice.human();
+            params[jss::ledger_index] = ledger;
+            return env.rpc ("json", "account_info",
+                boost::lexical_cast<std::string>(params))[jss::result];
+        };
+
+        auto const before = env.rpc ("rpc_cache")[jss::result];
+
+        // The second request is answered from the cache
+        auto const first = accountInfo ("validated");
+        auto const second = accountInfo ("validated");
+        BEAST_EXPECT(first[jss::validated].asBool());
+        BEAST_EXPECT(second[jss::account_data] == first[jss::account_data]);
+        BEAST_EXPECT(second[jss::ledger_hash] == first[jss::ledger_hash]);
+
+        auto stats = env.rpc ("rpc_cache")[jss::result];
+        BEAST_EXPECT(count (stats, jss::hits) == count (before, jss::hits) + 1);
+        BEAST_EXPECT(count (stats, jss::misses) ==
+            count (before, jss::misses) + 1);
+        BEAST_EXPECT(stats[jss::entries].asUInt() > 0);
+
+        // The open ledger is never cached
+        accountInfo ("current");
+        accountInfo ("current");
+        auto const seq = first[jss::ledger_index].asUInt();
+        accountInfo (seq + 1);
+        auto const after = env.rpc ("rpc_cache")[jss::result];
+        BEAST_EXPECT(count (after, jss::hits) == count (stats, jss::hits));
+        BEAST_EXPECT(count (after, jss::misses) == count (stats, jss::misses));
+
+        // A newly validated ledger is a different request
+        env (pay (env.master, alice, XRP(1000)));
+        env.close();
+        auto const third = accountInfo ("validated");
+        BEAST_EXPECT(third[jss::ledger_index].asUInt() > seq);
+        BEAST_EXPECT(third[jss::account_data][sfBalance.fieldName] !=
+            first[jss::account_data][sfBalance.fieldName]);
+        BEAST_EXPECT(accountInfo (seq)[jss::account_data] ==
+            first[jss::account_data]);
+
+        auto const cleared = env.rpc ("rpc_cache", "clear")[jss::result];
+        BEAST_EXPECT(cleared[jss::clear].asBool());
+        BEAST_EXPECT(cleared[jss::entries].asUInt() == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testCache();
+        testRPC();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RPCCache,rpc,ripple);
+
+} // ripple
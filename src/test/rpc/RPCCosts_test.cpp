@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/resource/Fees.h>
+#include <ripple/rpc/impl/RPCCost.h>
+#include <test/jtx.h>
+#include <boost/lexical_cast.hpp>
+
+namespace ripple {
+
+class RPCCosts_test : public beast::unit_test::suite
+{
+    static
+    std::uint64_t
+    count (Json::Value const& methods, std::string const& method)
+    {
+        if (! methods.isMember (method))
+            return 0;
+        return std::stoull (methods[method][jss::count].asString());
+    }
+
+    void
+    testCharge()
+    {
+        testcase ("charge");
+
+        using namespace std::chrono;
+
+        ThreadUsage usage;
+        BEAST_EXPECT(RPC::measuredCharge (usage).cost() == 0);
+
+        // Cheap calls stay below the static fees
+        usage.cpu = microseconds (500);
+        usage.fetches = 20;
+        usage.allocated = 100 * 1024;
+        BEAST_EXPECT(RPC::measuredCharge (usage).cost() == 0);
+
+        usage.cpu = milliseconds (30);
+        usage.fetches = 1000;
+        usage.allocated = 4 * 1024 * 1024;
+        BEAST_EXPECT(RPC::measuredCharge (usage).cost() == 30 + 20 + 16);
+
+        // A long running command costs more than the heaviest fee
+        usage.cpu = seconds (1);
+        BEAST_EXPECT(RPC::measuredCharge (usage).cost() >
+            Resource::feeHighBurdenRPC.cost());
+    }
+
+    void
+    testUsage()
+    {
+        testcase ("usage");
+
+        using namespace std::chrono;
+
+        auto const before = ThreadUsage::now();
+        ThreadUsage::addFetch();
+        ThreadUsage::addFetch();
+        std::vector<std::unique_ptr<std::uint64_t[]>> v;
+        auto const until = steady_clock::now() + milliseconds (20);
+        while (steady_clock::now() < until)
+            v.emplace_back (new std::uint64_t[128]);
+        auto const used = ThreadUsage::now() - before;
+
+        BEAST_EXPECT(used.fetches == 2);
+        BEAST_EXPECT(used.cpu > milliseconds (0));
+#if RIPPLE_COUNT_ALLOCATIONS
+        BEAST_EXPECT(used.allocated >= v.size() * 128 * sizeof(std::uint64_t));
+#else
+        BEAST_EXPECT(used.allocated == 0);
+#endif
+    }
+
+    void
+    testCosts()
+    {
+        testcase ("costs");
+
+        using namespace test::jtx;
+        Env env {*this};
+        env.fund (XRP(10000), "alice", "bob");
+        env.close();
+
+        auto const before = env.rpc ("rpc_costs")[jss::result][jss::methods];
+
+        Json::Value params;
+        params[jss::ledger_index] = "current";
+        for (int i = 0; i < 5; ++i)
+            env.rpc ("json", "ledger_data",
+                boost::lexical_cast<std::string>(params));
+
+        auto const result = env.rpc ("rpc_costs")[jss::result];
+        BEAST_EXPECT(result[jss::status] == "success");
+        auto const& methods = result[jss::methods];
+        BEAST_EXPECT(count (methods, "ledger_data") ==
+            count (before, "ledger_data") + 5);
+        BEAST_EXPECT(count (methods, "rpc_costs") ==
+            count (before, "rpc_costs") + 1);
+
+        auto const& entry = methods["ledger_data"];
+        for (auto const& field :
+            {jss::cpu_us, jss::fetches, jss::allocated_bytes})
+        {
+            auto const& h = entry[field];
+            auto const p50 = std::stoull (h[jss::p50].asString());
+            auto const p99 = std::stoull (h[jss::p99].asString());
+            BEAST_EXPECT(p50 <= p99);
+            BEAST_EXPECT(h.isMember (jss::mean));
+            BEAST_EXPECT(h.isMember (jss::p90));
+            BEAST_EXPECT(h.isMember (jss::max));
+        }
+#if RIPPLE_COUNT_ALLOCATIONS
+        BEAST_EXPECT(std::stoull (
+            entry[jss::allocated_bytes][jss::max].asString()) > 0);
+#endif
+    }
+
+    void
+    testAdminOnly()
+    {
+        testcase ("admin only");
+
+        using namespace test::jtx;
+        Env env {*this, envconfig(no_admin)};
+
+        // The HTTP server refuses the request with a 403, which the
+        // client reports as a null result.
+        auto const result = env.rpc ("rpc_costs")[jss::result];
+        BEAST_EXPECT(result.type() == Json::nullValue);
+    }
+
+public:
+    void
+    run() override
+    {
+        testCharge();
+        testUsage();
+        testCosts();
+        testAdminOnly();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RPCCosts,rpc,ripple);
+
+} // ripple
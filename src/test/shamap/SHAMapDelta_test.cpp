@@ -0,0 +1,329 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/shamap/SHAMap.h>
+#include <test/shamap/common.h>
+#include <ripple/basics/Blob.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/protocol/digest.h>
+#include <test/unit_test/bench_args.h>
+#include <chrono>
+#include <random>
+#include <set>
+#include <thread>
+
+namespace ripple {
+namespace tests {
+
+static
+Blob
+deltaData (std::size_t v)
+{
+    Blob b (32);
+    for (std::size_t i = 0; i < b.size (); ++i)
+        b[i] = static_cast<unsigned char> (v >> (i % 8));
+    return b;
+}
+
+class SHAMapDelta_test : public beast::unit_test::suite
+{
+    // Builds a pair of maps that share most of their items
+    static
+    std::pair<std::shared_ptr<SHAMap>, std::shared_ptr<SHAMap>>
+    makeMaps (TestFamily& f, std::size_t count, std::size_t changes)
+    {
+        auto before = std::make_shared<SHAMap> (
+            SHAMapType::FREE, f, SHAMap::version{1});
+        for (std::size_t i = 0; i < count; ++i)
+            before->addItem (SHAMapItem{sha512Half (i),
+                deltaData (i)}, false, false);
+        before->flushDirty (hotACCOUNT_NODE, 1);
+
+        auto after = before->snapShot (true);
+        beast::xor_shift_engine gen (count + changes);
+        std::uniform_int_distribution<std::size_t> pick (0, count - 1);
+        for (std::size_t i = 0; i < changes; ++i)
+        {
+            auto const key = sha512Half (pick (gen));
+            switch (i % 3)
+            {
+            case 0:
+                after->addItem (SHAMapItem{sha512Half (count + i),
+                    deltaData (i)}, false, false);
+                break;
+            case 1:
+                if (after->hasItem (key))
+                    after->delItem (key);
+                break;
+            default:
+                if (after->hasItem (key))
+                    after->updateGiveItem (std::make_shared<SHAMapItem> (
+                        key, deltaData (count + i)), false, false);
+                break;
+            }
+        }
+        after->flushDirty (hotACCOUNT_NODE, 2);
+        before->setImmutable ();
+        after->setImmutable ();
+        return { before, after };
+    }
+
+    void
+    testMatchesCompare (std::size_t count, std::size_t changes)
+    {
+        testcase ("matches compare, " + std::to_string (count) +
+            " items, " + std::to_string (changes) + " changes");
+
+        TestFamily f (beast::Journal{});
+        auto const maps = makeMaps (f, count, changes);
+
+        SHAMap::Delta expected;
+        BEAST_EXPECT(maps.first->compare (
+            *maps.second, expected, 1000000));
+
+        for (std::size_t workers : { 1, 2, 4, 7 })
+        {
+            SHAMap::Delta delta;
+            bool duplicate = false;
+            BEAST_EXPECT(maps.first->visitDelta (*maps.second,
+                [&](uint256 const& key,
+                    std::shared_ptr<SHAMapItem const> const& before,
+                    std::shared_ptr<SHAMapItem const> const& after)
+                {
+                    if (! delta.emplace (key, std::make_pair (
+                            before, after)).second)
+                        duplicate = true;
+                    return true;
+                }, workers));
+            BEAST_EXPECT(! duplicate);
+            BEAST_EXPECT(delta.size () == expected.size ());
+            BEAST_EXPECT(std::equal (delta.begin (), delta.end (),
+                expected.begin (), expected.end (),
+                [](auto const& a, auto const& b)
+                {
+                    return a.first == b.first &&
+                        a.second.first == b.second.first &&
+                        a.second.second == b.second.second;
+                }));
+        }
+
+        // The reverse comparison swaps before and after
+        std::size_t swapped = 0;
+        maps.second->visitDelta (*maps.first,
+            [&](uint256 const& key,
+                std::shared_ptr<SHAMapItem const> const& before,
+                std::shared_ptr<SHAMapItem const> const& after)
+            {
+                auto const iter = expected.find (key);
+                if (iter != expected.end () &&
+                        iter->second.first == after &&
+                        iter->second.second == before)
+                    ++swapped;
+                return true;
+            }, 3);
+        BEAST_EXPECT(swapped == expected.size ());
+    }
+
+    void
+    testStop()
+    {
+        testcase ("stop");
+
+        TestFamily f (beast::Journal{});
+        auto const maps = makeMaps (f, 5000, 3000);
+
+        for (std::size_t workers : { 1, 4 })
+        {
+            std::size_t seen = 0;
+            BEAST_EXPECT(! maps.first->visitDelta (*maps.second,
+                [&](uint256 const&,
+                    std::shared_ptr<SHAMapItem const> const&,
+                    std::shared_ptr<SHAMapItem const> const&)
+                {
+                    return ++seen < 10;
+                }, workers));
+            BEAST_EXPECT(seen == 10);
+        }
+
+        // Equal maps produce no differences
+        std::size_t seen = 0;
+        BEAST_EXPECT(maps.first->visitDelta (*maps.first,
+            [&](uint256 const&,
+                std::shared_ptr<SHAMapItem const> const&,
+                std::shared_ptr<SHAMapItem const> const&)
+            {
+                ++seen;
+                return true;
+            }, 4));
+        BEAST_EXPECT(seen == 0);
+    }
+
+    void
+    testNewNodes()
+    {
+        testcase ("visitNewNodes");
+
+        TestFamily f (beast::Journal{});
+        auto const maps = makeMaps (f, 5000, 300);
+
+        auto const collect = [](SHAMap const& map, SHAMap const* have)
+        {
+            std::set<uint256> hashes;
+            map.visitNewNodes (have,
+                [&](SHAMapAbstractNode& node)
+                {
+                    hashes.insert (node.getNodeHash ().as_uint256 ());
+                    return false;
+                });
+            return hashes;
+        };
+
+        auto const before = collect (*maps.first, nullptr);
+        auto const after = collect (*maps.second, nullptr);
+        auto const added = collect (*maps.second, maps.first.get ());
+
+        std::size_t all = 0;
+        maps.second->visitNodes (
+            [&](SHAMapAbstractNode&)
+            {
+                ++all;
+                return false;
+            });
+        BEAST_EXPECT(after.size () == all);
+
+        // Every node is either new or already in the other map. A
+        // leaf that moved to another position counts as new.
+        BEAST_EXPECT(! added.empty ());
+        BEAST_EXPECT(added.size () < after.size ());
+        for (auto const& hash : after)
+            BEAST_EXPECT(added.count (hash) || before.count (hash));
+        for (auto const& hash : added)
+            BEAST_EXPECT(after.count (hash));
+
+        BEAST_EXPECT(collect (*maps.second, maps.second.get ()).empty ());
+
+        // Returning true stops the walk
+        std::size_t seen = 0;
+        maps.second->visitNewNodes (nullptr,
+            [&](SHAMapAbstractNode&)
+            {
+                return ++seen == 5;
+            });
+        BEAST_EXPECT(seen == 5);
+    }
+
+public:
+    void
+    run () override
+    {
+        testMatchesCompare (1, 1);
+        testMatchesCompare (20, 10);
+        testMatchesCompare (5000, 300);
+        testMatchesCompare (5000, 6000);
+        testStop ();
+        testNewNodes ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SHAMapDelta,ripple_app,ripple);
+
+//------------------------------------------------------------------------------
+
+// Measures a full diff of two maps that share part of their items, read
+// back from the node store the way two distant ledgers would be. The
+// argument lists the worker counts.
+class SHAMapDeltaBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t const items = 200000;
+    static std::size_t const changes = 100000;
+
+    void
+    bench (TestFamily& f, SHAMapHash const& before,
+        SHAMapHash const& after, std::size_t workers)
+    {
+        testcase ("workers " + std::to_string (workers));
+
+        // Start from the node store every time
+        f.treecache ().clear ();
+        SHAMap ours (SHAMapType::FREE, before.as_uint256 (), f,
+            SHAMap::version{1});
+        SHAMap other (SHAMapType::FREE, after.as_uint256 (), f,
+            SHAMap::version{1});
+        BEAST_EXPECT(ours.fetchRoot (before, nullptr));
+        BEAST_EXPECT(other.fetchRoot (after, nullptr));
+        ours.setImmutable ();
+        other.setImmutable ();
+
+        std::size_t differences = 0;
+        auto const start = clock_type::now ();
+        BEAST_EXPECT(ours.visitDelta (other,
+            [&](uint256 const&,
+                std::shared_ptr<SHAMapItem const> const&,
+                std::shared_ptr<SHAMapItem const> const&)
+            {
+                ++differences;
+                return true;
+            }, workers));
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::milliseconds> (clock_type::now () - start);
+
+        log << "    " << differences << " differences in " <<
+            elapsed.count () << "ms" << std::endl;
+    }
+
+public:
+    void
+    run () override
+    {
+        auto const counts = test::benchSizes (arg (), { 1, 2, 4, 8 });
+
+        TestFamily f (beast::Journal{});
+        SHAMapHash before;
+        SHAMapHash after;
+        {
+            SHAMap map (SHAMapType::FREE, f, SHAMap::version{1});
+            for (std::size_t i = 0; i < items; ++i)
+                map.addItem (SHAMapItem{sha512Half (i),
+                    deltaData (i)}, false, false);
+            map.flushDirty (hotACCOUNT_NODE, 1);
+            before = map.getHash ();
+
+            for (std::size_t i = 0; i < changes; ++i)
+                map.updateGiveItem (std::make_shared<SHAMapItem> (
+                    sha512Half (i * 2), deltaData (items + i)),
+                        false, false);
+            map.flushDirty (hotACCOUNT_NODE, 2);
+            after = map.getHash ();
+        }
+
+        for (auto const workers : counts)
+            bench (f, before, after, workers);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapDeltaBench,ripple_app,ripple);
+
+} // tests
+} // ripple
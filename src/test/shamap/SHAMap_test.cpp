@@ -24,6 +24,13 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/protocol/digest.h>
+#include <test/unit_test/bench_args.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
 
 namespace ripple {
 namespace tests {
@@ -324,5 +331,194 @@ public:
 
 BEAST_DEFINE_TESTSUITE(SHAMap,ripple_app,ripple);
 
+//------------------------------------------------------------------------------
+
+// Measures how random lookups in one shared SHAMap scale with the number
+// of reader threads. Each run loads a fresh map from the node store by
+// its root hash, so the readers also race to hook up child nodes. The
+// argument lists the reader thread counts.
+class SHAMapBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t const items = 100000;
+    static std::size_t const lookups = 250000;
+
+    void
+    bench (TestFamily& f, SHAMapHash const& root,
+        std::vector<uint256> const& keys, std::size_t threads)
+    {
+        testcase ("threads " + std::to_string (threads));
+
+        SHAMap map (SHAMapType::FREE, root.as_uint256 (), f,
+            SHAMap::version{1});
+        BEAST_EXPECT(map.fetchRoot (root, nullptr));
+        map.setImmutable ();
+
+        std::atomic<std::size_t> found {0};
+        std::vector<std::thread> workers;
+        auto const start = clock_type::now ();
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back ([&, t]
+            {
+                beast::xor_shift_engine gen (t + 1);
+                std::uniform_int_distribution<std::size_t> pick (
+                    0, keys.size () - 1);
+                std::size_t n = 0;
+                for (std::size_t i = 0; i < lookups; ++i)
+                    n += map.hasItem (keys[pick (gen)]) ? 1 : 0;
+                found += n;
+            });
+        }
+        for (auto& w : workers)
+            w.join ();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::milliseconds> (clock_type::now () - start);
+
+        BEAST_EXPECT(found == threads * lookups);
+        auto const total = threads * lookups;
+        log << "    " << total << " lookups in " << elapsed.count () <<
+            "ms, " << (total * 1000 / std::max<std::int64_t> (
+                elapsed.count (), 1)) << " per second" << std::endl;
+    }
+
+public:
+    void
+    run () override
+    {
+        auto const counts = test::benchSizes (arg (), { 1, 2, 4, 8 });
+
+        TestFamily f (beast::Journal{});
+        std::vector<uint256> keys;
+        keys.reserve (items);
+        SHAMapHash root;
+        {
+            SHAMap map (SHAMapType::FREE, f, SHAMap::version{1});
+            for (std::size_t i = 0; i < items; ++i)
+            {
+                keys.push_back (sha512Half (i));
+                map.addItem (SHAMapItem{keys.back (),
+                    SHAMap_test::IntToVUC (i)}, false, false);
+            }
+            map.flushDirty (hotACCOUNT_NODE, 1);
+            root = map.getHash ();
+        }
+
+        for (auto const threads : counts)
+            bench (f, root, keys, threads);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapBench,ripple_app,ripple);
+
+//------------------------------------------------------------------------------
+
+// Measures the phases of a map's life that create and destroy the most
+// tree nodes: building and flushing a state map, closing a series of
+// ledgers on top of it, tearing them down, and acquiring the last one
+// again from the node store. The argument lists the item counts.
+class SHAMapNodeBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t const closes = 20;
+    static std::size_t const changesPerClose = 2000;
+
+    static
+    std::int64_t
+    since (clock_type::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds> (
+            clock_type::now () - start).count ();
+    }
+
+    void
+    bench (std::size_t count)
+    {
+        testcase ("items " + std::to_string (count));
+
+        TestFamily f (beast::Journal{});
+        beast::xor_shift_engine gen (count);
+        std::uniform_int_distribution<std::size_t> pick (0, count - 1);
+
+        auto start = clock_type::now ();
+        auto map = std::make_shared<SHAMap> (
+            SHAMapType::FREE, f, SHAMap::version{1});
+        for (std::size_t i = 0; i < count; ++i)
+            map->addItem (SHAMapItem{sha512Half (i),
+                SHAMap_test::IntToVUC (i)}, false, false);
+        map->flushDirty (hotACCOUNT_NODE, 1);
+        auto const build = since (start);
+
+        // Each close modifies existing items and adds new ones
+        start = clock_type::now ();
+        std::vector<std::shared_ptr<SHAMap>> history;
+        std::size_t next = count;
+        for (std::size_t c = 0; c < closes; ++c)
+        {
+            history.push_back (map);
+            map = map->snapShot (true);
+            for (std::size_t i = 0; i < changesPerClose; ++i)
+            {
+                if (i % 4 == 0)
+                {
+                    map->addItem (SHAMapItem{sha512Half (next++),
+                        SHAMap_test::IntToVUC (c)}, false, false);
+                }
+                else
+                {
+                    auto const key = sha512Half (pick (gen));
+                    map->updateGiveItem (std::make_shared<SHAMapItem> (
+                        key, SHAMap_test::IntToVUC (i + c)), false, false);
+                }
+            }
+            map->flushDirty (hotACCOUNT_NODE, c + 2);
+        }
+        auto const close = since (start);
+
+        // Drop every cached node so acquisition rebuilds the tree
+        // from the node store
+        auto const root = map->getHash ();
+        start = clock_type::now ();
+        history.clear ();
+        map.reset ();
+        f.treecache ().clear ();
+        auto const teardown = since (start);
+
+        start = clock_type::now ();
+        auto acquired = std::make_shared<SHAMap> (SHAMapType::FREE,
+            root.as_uint256 (), f, SHAMap::version{1});
+        BEAST_EXPECT(acquired->fetchRoot (root, nullptr));
+        std::size_t nodes = 0;
+        acquired->visitNodes (
+            [&nodes](SHAMapAbstractNode&)
+            {
+                ++nodes;
+                return false;
+            });
+        BEAST_EXPECT(acquired->getHash () == root);
+        f.treecache ().clear ();
+        acquired.reset ();
+        auto const acquire = since (start);
+
+        log << "    build " << build << "ms, " << closes << " closes " <<
+            close << "ms, teardown " << teardown << "ms, acquire " <<
+            nodes << " nodes " << acquire << "ms" << std::endl;
+    }
+
+public:
+    void
+    run () override
+    {
+        auto const counts = test::benchSizes (arg (), { 100000 });
+
+        for (auto const count : counts)
+            bench (count);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapNodeBench,ripple_app,ripple);
+
 } // tests
 } // ripple
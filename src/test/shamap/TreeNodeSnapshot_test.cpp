@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/shamap/TreeNodeSnapshot.h>
+#include <ripple/shamap/SHAMap.h>
+#include <test/shamap/common.h>
+#include <ripple/basics/Blob.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/protocol/digest.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace ripple {
+namespace tests {
+
+class TreeNodeSnapshot_test : public beast::unit_test::suite
+{
+    static
+    std::shared_ptr<SHAMap>
+    makeMap (TestFamily& f, std::size_t count)
+    {
+        auto map = std::make_shared<SHAMap> (
+            SHAMapType::FREE, f, SHAMap::version{1});
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Blob data (40, static_cast<std::uint8_t> (i));
+            map->addItem (SHAMapItem{sha512Half (i), std::move (data)},
+                false, false);
+        }
+        map->flushDirty (hotACCOUNT_NODE, 1);
+        map->setImmutable ();
+        return map;
+    }
+
+    // Returns true if every node was read back, and is in the cache
+    bool
+    allCached (TestFamily& f,
+        std::vector<std::shared_ptr<SHAMapAbstractNode>> const& nodes)
+    {
+        for (auto const& node : nodes)
+        {
+            auto const cached = f.treecache().fetch (
+                node->getNodeHash().as_uint256());
+            if (cached != node)
+                return false;
+        }
+        return true;
+    }
+
+public:
+    void
+    run() override
+    {
+        beast::Journal const j;
+        beast::temp_dir dir;
+        boost::filesystem::path const path (dir.file ("snapshot"));
+
+        TestFamily f (j);
+        auto const map = makeMap (f, 2000);
+
+        std::size_t inner = 0;
+        std::size_t total = 0;
+        map->visitNodes (
+            [&](SHAMapAbstractNode& node)
+            {
+                if (node.isInner())
+                    ++inner;
+                ++total;
+                return true;
+            });
+
+        {
+            testcase ("round trip");
+
+            BEAST_EXPECT(loadTreeNodeSnapshot (f, path).empty());
+
+            auto const saved = saveTreeNodeSnapshot (f, path, 1000000);
+            BEAST_EXPECT(saved >= total);
+
+            // Saving does not count as using the cached nodes
+            BEAST_EXPECT(f.treecache().getHitRate() == 0);
+
+            TestFamily f2 (j);
+            auto const nodes = loadTreeNodeSnapshot (f2, path);
+            BEAST_EXPECT(nodes.size() == saved);
+            BEAST_EXPECT(allCached (f2, nodes));
+
+            // The map can be walked from the cache alone
+            auto const root = f2.treecache().fetch (
+                map->getHash().as_uint256());
+            BEAST_EXPECT(root && root->isInner());
+            auto const reads = f2.db().getFetchTotalCount();
+            SHAMap copy (SHAMapType::FREE, map->getHash().as_uint256(), f2,
+                SHAMap::version{1});
+            BEAST_EXPECT(copy.fetchRoot (map->getHash(), nullptr));
+            std::size_t items = 0;
+            for (auto const& item : copy)
+            {
+                (void)item;
+                ++items;
+            }
+            BEAST_EXPECT(items == 2000);
+            BEAST_EXPECT(f2.db().getFetchTotalCount() == reads);
+        }
+
+        {
+            testcase ("inner nodes first");
+
+            BEAST_EXPECT(saveTreeNodeSnapshot (f, path, inner) == inner);
+
+            TestFamily f2 (j);
+            auto const nodes = loadTreeNodeSnapshot (f2, path);
+            BEAST_EXPECT(nodes.size() == inner);
+            bool allInner = true;
+            for (auto const& node : nodes)
+                allInner = allInner && node->isInner();
+            BEAST_EXPECT(allInner);
+        }
+
+        {
+            testcase ("damaged");
+
+            auto const saved = saveTreeNodeSnapshot (f, path, 1000000);
+            auto const size = boost::filesystem::file_size (path);
+            {
+                std::fstream file (path.string(),
+                    std::ios::in | std::ios::out | std::ios::binary);
+                file.seekp (size / 2);
+                char c = 0;
+                file.seekg (size / 2);
+                file.get (c);
+                file.seekp (size / 2);
+                file.put (static_cast<char> (c ^ 0x55));
+            }
+
+            TestFamily f2 (j);
+            auto const nodes = loadTreeNodeSnapshot (f2, path);
+            BEAST_EXPECT(! nodes.empty() && nodes.size() < saved);
+            BEAST_EXPECT(allCached (f2, nodes));
+
+            // A truncated file keeps the records before the cut
+            boost::filesystem::resize_file (path, size / 4);
+            TestFamily f3 (j);
+            auto const part = loadTreeNodeSnapshot (f3, path);
+            BEAST_EXPECT(! part.empty() && part.size() < nodes.size());
+            BEAST_EXPECT(allCached (f3, part));
+
+            // A record claiming to be larger than any node
+            saveTreeNodeSnapshot (f, path, 1000000);
+            {
+                std::fstream file (path.string(),
+                    std::ios::in | std::ios::out | std::ios::binary);
+                file.seekp (sizeof(std::uint64_t) + uint256::bytes);
+                std::uint32_t const huge = 0xFFFFFFFF;
+                file.write (reinterpret_cast<char const*>(&huge),
+                    sizeof(huge));
+            }
+            TestFamily f5 (j);
+            BEAST_EXPECT(loadTreeNodeSnapshot (f5, path).empty());
+
+            // Not a snapshot at all
+            boost::filesystem::resize_file (path, 4);
+            TestFamily f4 (j);
+            BEAST_EXPECT(loadTreeNodeSnapshot (f4, path).empty());
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TreeNodeSnapshot,shamap,ripple);
+
+} // tests
+} // ripple
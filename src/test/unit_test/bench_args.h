@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2017 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef TEST_UNIT_TEST_BENCH_ARGS_H
+#define TEST_UNIT_TEST_BENCH_ARGS_H
+
+#include <ripple/beast/core/LexicalCast.h>
+#include <boost/algorithm/string.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+/** Return the sizes a manual benchmark suite should run with.
+
+    Benchmark suites take a comma separated list of sizes (item counts,
+    thread counts and so on) as their argument, for example
+    `--unittest=SHAMapBench --unittest-arg=1,4,16`.
+
+    @param arg The suite's argument.
+    @param defaults The sizes to use when the argument is empty.
+    @throws std::exception if an entry is not a number.
+*/
+inline
+std::vector<std::size_t>
+benchSizes (std::string const& arg, std::vector<std::size_t> defaults)
+{
+    if (arg.empty ())
+        return defaults;
+
+    std::vector<std::string> args;
+    boost::split (args, arg, boost::is_any_of (","));
+
+    std::vector<std::size_t> sizes;
+    sizes.reserve (args.size ());
+    for (auto const& a : args)
+        sizes.push_back (beast::lexicalCastThrow<std::size_t> (a));
+    return sizes;
+}
+
+} // test
+} // ripple
+
+#endif
@@ -24,6 +24,7 @@
 #include <test/basics/contract_test.cpp>
 #include <test/basics/hardened_hash_test.cpp>
 #include <test/basics/KeyCache_test.cpp>
+#include <test/basics/Log_test.cpp>
 #include <test/basics/mulDiv_test.cpp>
 #include <test/basics/RangeSet_test.cpp>
 #include <test/basics/Slice_test.cpp>
@@ -24,5 +24,6 @@
 #include <test/beast/beast_basic_seconds_clock_test.cpp>
 #include <test/beast/beast_CurrentThreadName_test.cpp>
 #include <test/beast/beast_Debug_test.cpp>
+#include <test/beast/beast_insight_Histogram_test.cpp>
 #include <test/beast/beast_Journal_test.cpp>
 #include <test/beast/beast_PropertyStream_test.cpp>
@@ -19,6 +19,7 @@
 //==============================================================================
 
 #include <test/ledger/BookDirs_test.cpp>
+#include <test/ledger/CachedSLEs_test.cpp>
 #include <test/ledger/CashDiff_test.cpp>
 #include <test/ledger/Directory_test.cpp>
 #include <test/ledger/Invariants_test.cpp>
@@ -22,10 +22,12 @@
 #include <test/protocol/digest_test.cpp>
 #include <test/protocol/InnerObjectFormats_test.cpp>
 #include <test/protocol/IOUAmount_test.cpp>
+#include <test/protocol/LazySLE_test.cpp>
 #include <test/protocol/Issue_test.cpp>
 #include <test/protocol/PublicKey_test.cpp>
 #include <test/protocol/Quality_test.cpp>
 #include <test/protocol/SecretKey_test.cpp>
+#include <test/protocol/Serializer_test.cpp>
 #include <test/protocol/Seed_test.cpp>
 #include <test/protocol/STAccount_test.cpp>
 #include <test/protocol/STAmount_test.cpp>
@@ -19,5 +19,7 @@
 //==============================================================================
 
 #include <test/shamap/FetchPack_test.cpp>
+#include <test/shamap/SHAMapDelta_test.cpp>
 #include <test/shamap/SHAMapSync_test.cpp>
-#include <test/shamap/SHAMap_test.cpp>
\ No newline at end of file
+#include <test/shamap/SHAMap_test.cpp>
+#include <test/shamap/TreeNodeSnapshot_test.cpp>